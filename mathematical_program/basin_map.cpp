@@ -0,0 +1,60 @@
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+
+#include <gflags/gflags.h>
+
+#include "basin_map.h"
+#include "tutorial_programs.h"
+
+#include <iostream>
+#include <numeric>
+
+DEFINE_int32(resolution, 200, "Number of grid points per dimension.");
+DEFINE_double(box, 15, "The grid covers [-box, box]^2.");
+DEFINE_int32(num_threads, 1,
+             "Number of worker threads; 0 means one per hardware thread. See "
+             "solver_concurrency.h for when Ipopt solves run in parallel.");
+DEFINE_string(image, "basin_map.ppm", "Path of the basin image.");
+DEFINE_string(table, "basin_map.bin", "Path of the binary basin table.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  const int num_threads = FLAGS_num_threads > 0 ? FLAGS_num_threads
+                                                : drake_tutorials::ThreadPool::DefaultNumThreads();
+  drake_tutorials::ThreadPool pool(num_threads);
+
+  // good_or_bad_initial_guess.cpp: where do initial guesses in the plane end up?
+  const auto prog = drake_tutorials::MakeCircleProgram();
+  const Eigen::MatrixXd guesses = drake_tutorials::MakeGrid(
+      Eigen::Vector2d::Constant(-FLAGS_box), Eigen::Vector2d::Constant(FLAGS_box),
+      FLAGS_resolution);
+  drake::solvers::SolverOptions solver_options;
+  solver_options.SetOption(drake::solvers::IpoptSolver::id(), "print_level", 0);
+  drake_tutorials::BasinMapOptions options;
+  options.solver_options = solver_options;
+  const auto map = drake_tutorials::ComputeBasinMap(*prog, guesses, options, &pool);
+
+  print(map.num_starts(), " solves on ", num_threads, " thread(s) in ", map.wall_time, " s: ",
+        map.solves_per_second(), " solves/s, ", map.num_failed, " failed");
+  for (size_t k = 0; k < map.basins.size(); ++k) {
+    const auto& basin = map.basins[k];
+    print("basin ", k, ": x = ", basin.x.transpose(), ", cost ", basin.cost, ", ",
+          100.0 * basin.num_starts / map.num_starts(), " % of the guesses, ",
+          basin.mean_iterations, " iterations and ", 1e3 * basin.mean_solve_time,
+          " ms per solve");
+  }
+  // What a guess drawn uniformly from the box costs on average.
+  const double mean_solve_time =
+      std::accumulate(map.solve_times.begin(), map.solve_times.end(), 0.0) / map.num_starts();
+  print("expected solve time from a uniform guess: ", 1e3 * mean_solve_time, " ms");
+
+  drake_tutorials::WriteBasinImage(map, FLAGS_resolution, FLAGS_resolution, FLAGS_image);
+  drake_tutorials::WriteBasinTable(map, FLAGS_table);
+  print("Wrote ", FLAGS_image, " and ", FLAGS_table);
+  return 0;
+}
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+
+#include "program_codec.h"
+#include "solver_concurrency.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace drake_tutorials {
+
+// Returns the points of a regular grid over the box [lower, upper], one per column, with
+// `resolution` points per dimension. The first dimension varies fastest.
+inline Eigen::MatrixXd MakeGrid(const Eigen::VectorXd& lower, const Eigen::VectorXd& upper,
+                                int resolution) {
+  const int dim = lower.size();
+  if (upper.size() != dim || resolution < 1) {
+    throw std::invalid_argument("MakeGrid: lower and upper differ in size or resolution < 1.");
+  }
+  std::int64_t num_points = 1;
+  for (int i = 0; i < dim; ++i) {
+    num_points *= resolution;
+  }
+  Eigen::MatrixXd points(dim, num_points);
+  for (std::int64_t j = 0; j < num_points; ++j) {
+    std::int64_t index = j;
+    for (int i = 0; i < dim; ++i) {
+      const double fraction =
+          resolution > 1 ? static_cast<double>(index % resolution) / (resolution - 1) : 0.5;
+      points(i, j) = lower(i) + fraction * (upper(i) - lower(i));
+      index /= resolution;
+    }
+  }
+  return points;
+}
+
+struct BasinMapOptions {
+  // Two solutions belong to the same basin if they are closer than
+  // tolerance * (1 + |representative|).
+  double tolerance{1e-4};
+  std::optional<drake::solvers::SolverOptions> solver_options;
+};
+
+struct Basin {
+  // The first solution that was assigned to the basin.
+  Eigen::VectorXd x;
+  double cost{0};
+  int num_starts{0};
+  double mean_iterations{0};
+  double mean_solve_time{0};
+};
+
+/*
+ * The outcome of solving a program from many initial guesses: which local solution every guess
+ * leads to, and how long it takes to get there.
+ */
+struct BasinMap {
+  // The initial guesses, one per column.
+  Eigen::MatrixXd guesses;
+  // Basin of every guess, or -1 if the solve failed. Basins are sorted by cost, so basin 0 holds
+  // the best solution found.
+  std::vector<int> basin;
+  std::vector<int> iterations;
+  std::vector<float> solve_times;
+  std::vector<Basin> basins;
+  int num_failed{0};
+  double wall_time{0};
+
+  int num_starts() const { return static_cast<int>(basin.size()); }
+  double solves_per_second() const { return wall_time > 0 ? num_starts() / wall_time : 0; }
+};
+
+namespace internal {
+
+// Greedy clustering: every solution joins the first basin whose representative is within the
+// tolerance, or opens a new one. Afterwards the basins are renumbered by cost.
+inline void ClusterSolutions(const std::vector<drake::solvers::MathematicalProgramResult>& results,
+                             double tolerance, BasinMap* map) {
+  const int n = static_cast<int>(results.size());
+  map->basin.assign(n, -1);
+  std::vector<Basin> basins;
+  for (int i = 0; i < n; ++i) {
+    if (!results[i].is_success()) {
+      ++map->num_failed;
+      continue;
+    }
+    const Eigen::VectorXd& x = results[i].get_x_val();
+    int k = 0;
+    for (; k < static_cast<int>(basins.size()); ++k) {
+      if ((x - basins[k].x).norm() <= tolerance * (1 + basins[k].x.norm())) {
+        break;
+      }
+    }
+    if (k == static_cast<int>(basins.size())) {
+      basins.push_back({x, results[i].get_optimal_cost()});
+    }
+    Basin& basin = basins[k];
+    ++basin.num_starts;
+    basin.mean_iterations += map->iterations[i];
+    basin.mean_solve_time += map->solve_times[i];
+    map->basin[i] = k;
+  }
+  std::vector<int> order(basins.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&basins](int a, int b) { return basins[a].cost < basins[b].cost; });
+  std::vector<int> rank(basins.size());
+  map->basins.clear();
+  for (size_t r = 0; r < order.size(); ++r) {
+    rank[order[r]] = static_cast<int>(r);
+    Basin basin = basins[order[r]];
+    basin.mean_iterations /= basin.num_starts;
+    basin.mean_solve_time /= basin.num_starts;
+    map->basins.push_back(basin);
+  }
+  for (int& b : map->basin) {
+    if (b >= 0) {
+      b = rank[b];
+    }
+  }
+}
+
+}  // namespace internal
+
+/*
+ * Solves `prog` with IpoptSolver from every column of `guesses` on `pool` and groups the
+ * solutions into basins. Every worker solves its own clone of the program with its own solver;
+ * iterations are counted through a visualization callback. See solver_concurrency.h for when
+ * the solves actually overlap.
+ */
+inline BasinMap ComputeBasinMap(const drake::solvers::MathematicalProgram& prog,
+                                const Eigen::MatrixXd& guesses, const BasinMapOptions& options,
+                                ThreadPool* pool) {
+  if (guesses.rows() != prog.num_vars()) {
+    throw std::invalid_argument("ComputeBasinMap: guesses must have one row per variable.");
+  }
+  const int n = guesses.cols();
+  struct WorkerState {
+    std::unique_ptr<drake::solvers::MathematicalProgram> prog;
+    drake::solvers::IpoptSolver solver;
+    int iterations{0};
+  };
+  std::vector<WorkerState> states(pool->num_threads());
+  std::vector<drake::solvers::MathematicalProgramResult> results(n);
+  BasinMap map;
+  map.guesses = guesses;
+  map.iterations.resize(n);
+  map.solve_times.resize(n);
+
+  const auto start = std::chrono::steady_clock::now();
+  pool->ParallelFor(
+      n,
+      [&](int worker, int i) {
+        WorkerState& state = states[worker];
+        if (state.prog == nullptr) {
+          state.prog = prog.Clone();
+          state.prog->AddVisualizationCallback(
+              [&state](const Eigen::Ref<const Eigen::VectorXd>&) { ++state.iterations; },
+              state.prog->decision_variables());
+        }
+        state.iterations = 0;
+        const auto solve_start = std::chrono::steady_clock::now();
+        SolveConcurrently(state.solver, *state.prog, guesses.col(i), options.solver_options,
+                          &results[i]);
+        const std::chrono::duration<double> solve_time =
+            std::chrono::steady_clock::now() - solve_start;
+        map.iterations[i] = state.iterations;
+        map.solve_times[i] = static_cast<float>(solve_time.count());
+      },
+      std::max(1, n / (16 * pool->num_threads())));
+  const std::chrono::duration<double> wall_time = std::chrono::steady_clock::now() - start;
+  map.wall_time = wall_time.count();
+
+  internal::ClusterSolutions(results, options.tolerance, &map);
+  return map;
+}
+
+/*
+ * Writes `map` as a binary table: the magic "BASINMAP", then the ByteWriter encoding of the
+ * dimension, wall time, one (x, cost, num_starts, mean_iterations, mean_solve_time) record per
+ * basin, the guesses (column-major), and the per-guess basin, iteration and solve time arrays.
+ */
+inline void WriteBasinTable(const BasinMap& map, const std::string& path) {
+  ByteWriter writer;
+  writer.Put(std::array<char, 8>{'B', 'A', 'S', 'I', 'N', 'M', 'A', 'P'});
+  writer.Put<std::uint32_t>(map.guesses.rows());
+  writer.Put<double>(map.wall_time);
+  writer.Put<std::uint32_t>(map.basins.size());
+  for (const Basin& basin : map.basins) {
+    writer.PutVector(basin.x);
+    writer.Put<double>(basin.cost);
+    writer.Put<std::int32_t>(basin.num_starts);
+    writer.Put<double>(basin.mean_iterations);
+    writer.Put<double>(basin.mean_solve_time);
+  }
+  writer.PutArray(map.guesses.data(), map.guesses.size());
+  writer.PutArray(map.basin.data(), map.basin.size());
+  writer.PutArray(map.iterations.data(), map.iterations.size());
+  writer.PutArray(map.solve_times.data(), map.solve_times.size());
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(writer.bytes().data(), writer.bytes().size());
+  if (!out) {
+    throw std::runtime_error("WriteBasinTable: failed to write " + path);
+  }
+}
+
+inline BasinMap ReadBasinTable(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  std::stringstream contents;
+  contents << in.rdbuf();
+  const std::string bytes = contents.str();
+  ByteReader reader(bytes);
+  if (reader.Get<std::array<char, 8>>() !=
+      std::array<char, 8>{'B', 'A', 'S', 'I', 'N', 'M', 'A', 'P'}) {
+    throw std::runtime_error(path + " is not a basin table.");
+  }
+  BasinMap map;
+  const auto dim = reader.Get<std::uint32_t>();
+  map.wall_time = reader.Get<double>();
+  map.basins.resize(reader.Get<std::uint32_t>());
+  for (Basin& basin : map.basins) {
+    basin.x = reader.GetVector();
+    basin.cost = reader.Get<double>();
+    basin.num_starts = reader.Get<std::int32_t>();
+    basin.mean_iterations = reader.Get<double>();
+    basin.mean_solve_time = reader.Get<double>();
+  }
+  const auto guesses = reader.GetArray<double>();
+  map.basin = reader.GetArray<int>();
+  map.iterations = reader.GetArray<int>();
+  map.solve_times = reader.GetArray<float>();
+  if (dim == 0 || guesses.size() != dim * map.basin.size() ||
+      map.iterations.size() != map.basin.size() || map.solve_times.size() != map.basin.size()) {
+    throw std::runtime_error(path + " is not a consistent basin table.");
+  }
+  map.guesses = Eigen::Map<const Eigen::MatrixXd>(guesses.data(), dim, map.basin.size());
+  map.num_failed = std::count(map.basin.begin(), map.basin.end(), -1);
+  return map;
+}
+
+/*
+ * Writes the basins of a map over a `width` x `height` grid (MakeGrid() over two variables with
+ * the first one varying fastest) as a binary PPM image, one pixel per guess with the first guess
+ * at the bottom left. Every basin gets its own hue; pixels get darker the more iterations their
+ * solve took. Failed solves are black.
+ */
+inline void WriteBasinImage(const BasinMap& map, int width, int height, const std::string& path) {
+  if (width <= 0 || height <= 0) {
+    throw std::invalid_argument("WriteBasinImage: the image needs at least one pixel.");
+  }
+  if (static_cast<std::int64_t>(width) * height != map.num_starts()) {
+    throw std::invalid_argument("WriteBasinImage: the map does not have width * height starts.");
+  }
+  static constexpr std::array<std::array<int, 3>, 8> kPalette{{{31, 119, 180},
+                                                              {255, 127, 14},
+                                                              {44, 160, 44},
+                                                              {214, 39, 40},
+                                                              {148, 103, 189},
+                                                              {140, 86, 75},
+                                                              {227, 119, 194},
+                                                              {188, 189, 34}}};
+  const int max_iterations =
+      std::max(1, *std::max_element(map.iterations.begin(), map.iterations.end()));
+  std::string pixels(3 * static_cast<std::size_t>(width) * height, '\0');
+  for (int row = 0; row < height; ++row) {
+    for (int column = 0; column < width; ++column) {
+      const int i = (height - 1 - row) * width + column;
+      if (map.basin[i] < 0) {
+        continue;
+      }
+      const auto& color = kPalette[map.basin[i] % kPalette.size()];
+      const double shade = 1 - 0.6 * map.iterations[i] / max_iterations;
+      for (int c = 0; c < 3; ++c) {
+        pixels[3 * (static_cast<std::size_t>(row) * width + column) + c] =
+            static_cast<char>(color[c] * shade);
+      }
+    }
+  }
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out << "P6\n" << width << " " << height << "\n255\n";
+  out.write(pixels.data(), pixels.size());
+  if (!out) {
+    throw std::runtime_error("WriteBasinImage: failed to write " + path);
+  }
+}
+
+}  // namespace drake_tutorials
@@ -0,0 +1,322 @@
+#pragma once
+
+#include <drake/common/symbolic/codegen.h>
+#include <drake/common/symbolic/expression.h>
+#include <drake/solvers/constraint.h>
+#include <drake/solvers/cost.h>
+#include <drake/solvers/mathematical_program.h>
+
+#include "native_evaluator.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace drake_tutorials {
+
+namespace internal {
+
+// Generated code that evaluates f at many points in one call. The points and the values are
+// stored variable by variable: x[j * n + i] is variable j of point i, and y[k * n + i] output k.
+class NativeBatchFunction {
+ public:
+  NativeBatchFunction(const drake::VectorX<drake::symbolic::Expression>& f,
+                      const std::vector<drake::symbolic::Variable>& variables,
+                      const std::string& cache_dir)
+      : num_outputs_(f.size()) {
+    // CodeGen() writes f for a single point. The wrapper calls it in a loop over the points,
+    // in which the compiler inlines f and vectorizes across points: the columns are contiguous,
+    // and without semantic interposition f may be inlined although the library exports it.
+    const drake::MatrixX<drake::symbolic::Expression> column = f;
+    std::ostringstream source;
+    source << "#include <math.h>\n"
+           << drake::symbolic::CodeGen("f", variables, column)
+           << "\nvoid f_batch(const double* restrict x, double* restrict y, long n) {\n"
+           << "  for (long i = 0; i < n; ++i) {\n"
+           << "    double p[" << std::max<size_t>(1, variables.size()) << "];\n"
+           << "    double m[" << std::max(1, num_outputs_) << "];\n"
+           << "    for (int j = 0; j < " << variables.size() << "; ++j) p[j] = x[j * n + i];\n"
+           << "    f(p, m);\n"
+           << "    for (int k = 0; k < " << num_outputs_ << "; ++k) y[k * n + i] = m[k];\n"
+           << "  }\n"
+           << "}\n";
+    library_ = std::make_unique<NativeLibrary>(
+        source.str(), "-O3 -march=native -fno-math-errno -fno-semantic-interposition", cache_dir);
+    function_ = library_->Symbol<Function>("f_batch");
+  }
+
+  int num_outputs() const { return num_outputs_; }
+
+  void Evaluate(const double* x, double* y, long n) const { function_(x, y, n); }
+
+ private:
+  using Function = void (*)(const double*, double*, long);
+
+  int num_outputs_;
+  std::unique_ptr<NativeLibrary> library_;
+  Function function_{nullptr};
+};
+
+}  // namespace internal
+
+/*
+ * Evaluates one cost or constraint of a program at many points at once.
+ *
+ * Points are passed as a structure of arrays: a matrix with one row per point and one column per
+ * decision variable of the program (column j holds decision variable j of every point), so each
+ * variable is contiguous in memory. The values come back the same way, one row per point and one
+ * column per output of the evaluator.
+ *
+ * Instead of calling EvaluatorBase::Eval() once per point, the evaluator is recognized and
+ * evaluated with a kernel over whole columns:
+ *  - linear costs and linear, linear equality and bounding box constraints as (sparse) matrix
+ *    products,
+ *  - quadratic costs as 0.5 * rowsum((X Q) .* X) + X b + c, and quadratic constraints the same
+ *    way without c,
+ *  - symbolic evaluators (ExpressionCost, ExpressionConstraint, NativeCost, NativeConstraint) by
+ *    native code generated for batches, whose point loop the compiler vectorizes,
+ *  - anything else by the scalar loop over the points.
+ */
+class BatchEvaluator {
+ public:
+  enum class Kernel {
+    kLinearCost, kQuadraticCost, kQuadraticConstraint, kBoundingBox, kLinear, kNative, kScalar,
+  };
+
+  // Constructing an evaluator for a symbolic binding compiles its batch code, or loads it from
+  // `cache_dir` if the same expressions were compiled before.
+  BatchEvaluator(const drake::solvers::MathematicalProgram& prog,
+                 const drake::solvers::Binding<drake::solvers::EvaluatorBase>& binding,
+                 const std::string& cache_dir = NativeLibrary::DefaultCacheDirectory())
+      : evaluator_(binding.evaluator()),
+        indices_(prog.FindDecisionVariableIndices(binding.variables())),
+        num_vars_(prog.num_vars()) {
+    using namespace drake::solvers;
+    const EvaluatorBase* evaluator = evaluator_.get();
+    if (const auto* cost = dynamic_cast<const LinearCost*>(evaluator)) {
+      kernel_ = Kernel::kLinearCost;
+      b_ = cost->a();
+      c_ = cost->b();
+    } else if (const auto* cost = dynamic_cast<const QuadraticCost*>(evaluator)) {
+      kernel_ = Kernel::kQuadraticCost;
+      Q_ = cost->Q();
+      b_ = cost->b();
+      c_ = cost->c();
+    } else if (const auto* constraint = dynamic_cast<const QuadraticConstraint*>(evaluator)) {
+      kernel_ = Kernel::kQuadraticConstraint;
+      Q_ = constraint->Q();
+      b_ = constraint->b();
+    } else if (dynamic_cast<const BoundingBoxConstraint*>(evaluator) != nullptr) {
+      kernel_ = Kernel::kBoundingBox;
+    } else if (const auto* constraint = dynamic_cast<const LinearConstraint*>(evaluator)) {
+      kernel_ = Kernel::kLinear;
+      A_transpose_ = constraint->get_sparse_A().transpose();
+    } else if (const auto* cost = dynamic_cast<const ExpressionCost*>(evaluator)) {
+      Compile(drake::Vector1<drake::symbolic::Expression>(cost->expression()), cost->vars(),
+              cache_dir);
+    } else if (const auto* constraint = dynamic_cast<const ExpressionConstraint*>(evaluator)) {
+      Compile(constraint->expressions(), constraint->vars(), cache_dir);
+    } else if (const auto* cost = dynamic_cast<const NativeCost*>(evaluator)) {
+      Compile(drake::Vector1<drake::symbolic::Expression>(cost->expression()), cost->variables(),
+              cache_dir);
+    } else if (const auto* constraint = dynamic_cast<const NativeConstraint*>(evaluator)) {
+      Compile(constraint->expressions(), constraint->variables(), cache_dir);
+    }
+  }
+
+  Kernel kernel() const { return kernel_; }
+  int num_outputs() const { return evaluator_->num_outputs(); }
+  const drake::solvers::EvaluatorBase& evaluator() const { return *evaluator_; }
+
+  // Evaluates at every row of `points` on the calling thread.
+  void Eval(const Eigen::Ref<const Eigen::MatrixXd>& points, Eigen::MatrixXd* values) const {
+    CheckPoints(points);
+    values->resize(points.rows(), num_outputs());
+    EvalRows(points, *values);
+  }
+
+  // Evaluates blocks of rows in parallel on `pool`.
+  void Eval(const Eigen::Ref<const Eigen::MatrixXd>& points, Eigen::MatrixXd* values,
+            ThreadPool* pool) const {
+    CheckPoints(points);
+    values->resize(points.rows(), num_outputs());
+    const Eigen::Index num_blocks = (points.rows() + kBlockRows - 1) / kBlockRows;
+    pool->ParallelFor(static_cast<int>(num_blocks), [&](int, int block) {
+      const Eigen::Index begin = block * kBlockRows;
+      const Eigen::Index size = std::min(kBlockRows, points.rows() - begin);
+      EvalRows(points.middleRows(begin, size), values->middleRows(begin, size));
+    });
+  }
+
+  // Evaluates with one EvaluatorBase::Eval() per point, as the kernels' reference.
+  void EvalPointwise(const Eigen::Ref<const Eigen::MatrixXd>& points,
+                     Eigen::MatrixXd* values) const {
+    CheckPoints(points);
+    values->resize(points.rows(), num_outputs());
+    EvalScalar(points, *values);
+  }
+
+ private:
+  // Rows per task of the parallel path; the gathered block of a binding with a few variables
+  // then fits in the L2 cache.
+  static constexpr Eigen::Index kBlockRows = 8192;
+
+  void Compile(const drake::VectorX<drake::symbolic::Expression>& f,
+               const drake::solvers::VectorXDecisionVariable& vars, const std::string& cache_dir) {
+    Compile(f, std::vector<drake::symbolic::Variable>(vars.data(), vars.data() + vars.size()),
+            cache_dir);
+  }
+
+  void Compile(const drake::VectorX<drake::symbolic::Expression>& f,
+               const std::vector<drake::symbolic::Variable>& variables,
+               const std::string& cache_dir) {
+    kernel_ = Kernel::kNative;
+    native_ = std::make_shared<internal::NativeBatchFunction>(f, variables, cache_dir);
+  }
+
+  void CheckPoints(const Eigen::Ref<const Eigen::MatrixXd>& points) const {
+    if (points.cols() != num_vars_) {
+      throw std::invalid_argument("BatchEvaluator: points must have one column per decision "
+                                  "variable of the program.");
+    }
+  }
+
+  // The columns of the binding's variables, contiguous.
+  Eigen::MatrixXd Gather(const Eigen::Ref<const Eigen::MatrixXd>& points) const {
+    Eigen::MatrixXd x(points.rows(), indices_.size());
+    for (size_t k = 0; k < indices_.size(); ++k) {
+      x.col(k) = points.col(indices_[k]);
+    }
+    return x;
+  }
+
+  void EvalRows(const Eigen::Ref<const Eigen::MatrixXd>& points,
+                Eigen::Ref<Eigen::MatrixXd> values) const {
+    if (kernel_ == Kernel::kScalar) {
+      EvalScalar(points, values);
+      return;
+    }
+    const Eigen::MatrixXd x = Gather(points);
+    switch (kernel_) {
+      case Kernel::kLinearCost:
+        values.col(0) = (x * b_).array() + c_;
+        break;
+      case Kernel::kQuadraticCost:
+        values.col(0) = (0.5 * (x * Q_).cwiseProduct(x).rowwise().sum() + x * b_).array() + c_;
+        break;
+      case Kernel::kQuadraticConstraint:
+        values.col(0) = 0.5 * (x * Q_).cwiseProduct(x).rowwise().sum() + x * b_;
+        break;
+      case Kernel::kBoundingBox:
+        values = x;
+        break;
+      case Kernel::kLinear:
+        values = x * A_transpose_;
+        break;
+      case Kernel::kNative: {
+        Eigen::MatrixXd y(x.rows(), num_outputs());
+        native_->Evaluate(x.data(), y.data(), x.rows());
+        values = y;
+        break;
+      }
+      case Kernel::kScalar:
+        break;
+    }
+  }
+
+  // One EvaluatorBase::Eval() per point.
+  void EvalScalar(const Eigen::Ref<const Eigen::MatrixXd>& points,
+                  Eigen::Ref<Eigen::MatrixXd> values) const {
+    Eigen::VectorXd x(indices_.size());
+    Eigen::VectorXd y;
+    for (Eigen::Index i = 0; i < points.rows(); ++i) {
+      for (size_t k = 0; k < indices_.size(); ++k) {
+        x(k) = points(i, indices_[k]);
+      }
+      evaluator_->Eval(x, &y);
+      values.row(i) = y.transpose();
+    }
+  }
+
+  std::shared_ptr<drake::solvers::EvaluatorBase> evaluator_;
+  std::vector<int> indices_;
+  int num_vars_;
+  Kernel kernel_{Kernel::kScalar};
+  Eigen::MatrixXd Q_;
+  Eigen::VectorXd b_;
+  double c_{0};
+  Eigen::SparseMatrix<double> A_transpose_;
+  std::shared_ptr<internal::NativeBatchFunction> native_;
+};
+
+/*
+ * Batch evaluators for every cost and constraint of a program, for screening many candidate
+ * points (e.g. initial guesses) at once. Points are laid out as for BatchEvaluator.
+ */
+class ProgramBatchEvaluator {
+ public:
+  explicit ProgramBatchEvaluator(
+      const drake::solvers::MathematicalProgram& prog,
+      const std::string& cache_dir = NativeLibrary::DefaultCacheDirectory()) {
+    for (const auto& cost : prog.GetAllCosts()) {
+      costs_.emplace_back(prog, cost, cache_dir);
+    }
+    for (const auto& constraint : prog.GetAllConstraints()) {
+      constraints_.emplace_back(prog, constraint, cache_dir);
+    }
+  }
+
+  const std::vector<BatchEvaluator>& costs() const { return costs_; }
+  const std::vector<BatchEvaluator>& constraints() const { return constraints_; }
+
+  // The sum of all costs at every point. Runs on `pool` if given.
+  Eigen::VectorXd TotalCost(const Eigen::Ref<const Eigen::MatrixXd>& points,
+                            ThreadPool* pool = nullptr) const {
+    Eigen::VectorXd total = Eigen::VectorXd::Zero(points.rows());
+    Eigen::MatrixXd values;
+    for (const BatchEvaluator& cost : costs_) {
+      Eval(cost, points, &values, pool);
+      total += values.col(0);
+    }
+    return total;
+  }
+
+  // The largest violation of any constraint bound at every point, 0 at feasible points.
+  Eigen::VectorXd MaxViolation(const Eigen::Ref<const Eigen::MatrixXd>& points,
+                               ThreadPool* pool = nullptr) const {
+    Eigen::VectorXd violation = Eigen::VectorXd::Zero(points.rows());
+    Eigen::MatrixXd values;
+    for (const BatchEvaluator& constraint : constraints_) {
+      Eval(constraint, points, &values, pool);
+      const auto& evaluator =
+          static_cast<const drake::solvers::Constraint&>(constraint.evaluator());
+      for (int k = 0; k < values.cols(); ++k) {
+        violation = violation.cwiseMax(
+            (evaluator.lower_bound()(k) - values.col(k).array())
+                .max(values.col(k).array() - evaluator.upper_bound()(k))
+                .matrix());
+      }
+    }
+    return violation;
+  }
+
+ private:
+  static void Eval(const BatchEvaluator& evaluator,
+                   const Eigen::Ref<const Eigen::MatrixXd>& points, Eigen::MatrixXd* values,
+                   ThreadPool* pool) {
+    if (pool != nullptr) {
+      evaluator.Eval(points, values, pool);
+    } else {
+      evaluator.Eval(points, values);
+    }
+  }
+
+  std::vector<BatchEvaluator> costs_;
+  std::vector<BatchEvaluator> constraints_;
+};
+
+}  // namespace drake_tutorials
@@ -0,0 +1,123 @@
+#include <drake/solvers/mathematical_program.h>
+
+#include <gflags/gflags.h>
+
+#include "batch_evaluation.h"
+#include "native_evaluator.h"
+#include "thread_pool.h"
+#include "tutorial_programs.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+DEFINE_int32(num_points, 2000000, "Number of points every cost and constraint is evaluated at.");
+DEFINE_int32(num_threads, 0, "Number of worker threads; 0 means one per hardware thread.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+const char* KernelName(drake_tutorials::BatchEvaluator::Kernel kernel) {
+  using Kernel = drake_tutorials::BatchEvaluator::Kernel;
+  switch (kernel) {
+    case Kernel::kLinearCost:
+      return "linear cost";
+    case Kernel::kQuadraticCost:
+      return "quadratic cost";
+    case Kernel::kQuadraticConstraint:
+      return "quadratic constraint";
+    case Kernel::kBoundingBox:
+      return "bounding box";
+    case Kernel::kLinear:
+      return "linear";
+    case Kernel::kNative:
+      return "native";
+    case Kernel::kScalar:
+      return "scalar";
+  }
+  return "";
+}
+
+// Returns the seconds one call of `evaluate` takes.
+template <typename Function>
+double Measure(const Function& evaluate) {
+  const auto start = std::chrono::steady_clock::now();
+  evaluate();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Evaluates every cost and constraint of `prog` at `points` one EvaluatorBase::Eval() per point,
+// with the batch kernel and with the batch kernel on `pool`. Returns false if the batch values
+// differ from the scalar ones.
+bool Compare(const std::string& name, const drake::solvers::MathematicalProgram& prog,
+             const Eigen::MatrixXd& points, drake_tutorials::ThreadPool* pool) {
+  auto start = std::chrono::steady_clock::now();
+  const drake_tutorials::ProgramBatchEvaluator batch(prog);
+  const std::chrono::duration<double> setup = std::chrono::steady_clock::now() - start;
+  print(name, ": ", setup.count(), " s to prepare the kernels");
+
+  bool ok = true;
+  const double num_points = points.rows();
+  std::vector<drake_tutorials::BatchEvaluator> bindings = batch.costs();
+  bindings.insert(bindings.end(), batch.constraints().begin(), batch.constraints().end());
+  for (const auto& evaluator : bindings) {
+    Eigen::MatrixXd expected;
+    const double scalar_time = Measure([&] { evaluator.EvalPointwise(points, &expected); });
+    Eigen::MatrixXd values;
+    const double batch_time = Measure([&] { evaluator.Eval(points, &values); });
+    double error = (values - expected).cwiseAbs().maxCoeff();
+    const double parallel_time = Measure([&] { evaluator.Eval(points, &values, pool); });
+    error = std::max(error, (values - expected).cwiseAbs().maxCoeff());
+    const double tolerance = 1e-12 * (1 + expected.cwiseAbs().maxCoeff());
+    ok = ok && error <= tolerance;
+    print("  ", KernelName(evaluator.kernel()), " kernel (", evaluator.evaluator().num_vars(),
+          " variables, ", evaluator.num_outputs(), " outputs):\n    scalar loop ",
+          1e-6 * num_points / scalar_time, " Mpoints/s\n    batch ",
+          1e-6 * num_points / batch_time, " Mpoints/s (", scalar_time / batch_time,
+          "x)\n    batch on ", pool->num_threads(), " threads ",
+          1e-6 * num_points / parallel_time, " Mpoints/s (", scalar_time / parallel_time,
+          "x)\n    largest difference ", error);
+  }
+
+  // Screening: the total cost and the largest constraint violation at every point.
+  Eigen::VectorXd cost;
+  Eigen::VectorXd violation;
+  const double screening_time = Measure([&] {
+    cost = batch.TotalCost(points, pool);
+    violation = batch.MaxViolation(points, pool);
+  });
+  const Eigen::Index num_feasible = (violation.array() <= 1e-6).count();
+  print("  screening ", 1e-6 * num_points / screening_time, " Mpoints/s, ", num_feasible,
+        " points within 1e-6 of feasible");
+  return ok;
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  drake_tutorials::ThreadPool pool(FLAGS_num_threads > 0
+                                       ? FLAGS_num_threads
+                                       : drake_tutorials::ThreadPool::DefaultNumThreads());
+  const Eigen::MatrixXd points = 10 * Eigen::MatrixXd::Random(FLAGS_num_points, 2);
+  bool ok = true;
+
+  // A quadratic cost and linear constraints.
+  ok &= Compare("simple_optimization_problem_feasible", *drake_tutorials::MakeFeasibleProgram(),
+                points, &pool);
+  // The quadratic cost x0^2 - x1^2 and the quadratic constraint x0^2 + x1^2 == 100.
+  ok &= Compare("good_or_bad_initial_guess", *drake_tutorials::MakeCircleProgram(), points, &pool);
+
+  // The same cost and constraint as NativeCost and NativeConstraint.
+  drake::solvers::MathematicalProgram native_prog;
+  const auto x = native_prog.NewContinuousVariables(2);
+  drake_tutorials::AddNativeCost(&native_prog, pow(x[0], 2) - pow(x[1], 2));
+  drake_tutorials::AddNativeConstraint(
+      &native_prog, drake::Vector1<drake::symbolic::Expression>(pow(x[0], 2) + pow(x[1], 2)),
+      drake::Vector1d(100), drake::Vector1d(100));
+  ok &= Compare("native", native_prog, points, &pool);
+  return ok ? 0 : 1;
+}
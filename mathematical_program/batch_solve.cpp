@@ -0,0 +1,102 @@
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/solve.h>
+
+#include <gflags/gflags.h>
+
+#include "batch_solve.h"
+#include "tutorial_programs.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+DEFINE_int32(num_programs, 10000, "Number of programs solved per batch.");
+DEFINE_int32(num_threads, 0, "Number of worker threads; 0 means one per hardware thread.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+// The optimal solution is x* = (b/2, b/2).
+int CountWrongSolutions(const std::vector<drake::solvers::MathematicalProgramResult>& results,
+                        const std::vector<Eigen::VectorXd>& parameters) {
+  int num_wrong = 0;
+  for (size_t i = 0; i < results.size(); ++i) {
+    const double expected = parameters[i](0) / 2;
+    if (!results[i].is_success() ||
+        (results[i].get_x_val().array() - expected).abs().maxCoeff() > 1e-5) {
+      ++num_wrong;
+    }
+  }
+  return num_wrong;
+}
+
+void PrintStatistics(const std::string& name, const drake_tutorials::BatchSolveStatistics& stats) {
+  print(name, ": ", stats.num_programs, " solves on ", stats.num_threads, " thread(s) in ",
+        stats.wall_time, " s, ", stats.solves_per_second, " solves/s");
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  const int num_threads = FLAGS_num_threads > 0 ? FLAGS_num_threads
+                                                : drake_tutorials::ThreadPool::DefaultNumThreads();
+
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> distribution(-10, 10);
+  std::vector<Eigen::VectorXd> parameters(FLAGS_num_programs, Eigen::VectorXd(1));
+  for (auto& p : parameters) {
+    p(0) = distribution(generator);
+  }
+
+  // The way simple_optimization_problem_feasible.cpp does it: build the program symbolically
+  // and call Solve() every time.
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<drake::solvers::MathematicalProgramResult> serial_results;
+  serial_results.reserve(parameters.size());
+  for (const auto& p : parameters) {
+    serial_results.push_back(drake::solvers::Solve(*drake_tutorials::MakeFeasibleProgram(p(0))));
+  }
+  const std::chrono::duration<double> serial_time = std::chrono::steady_clock::now() - start;
+  print("serial build + Solve(): ", parameters.size(), " solves in ", serial_time.count(), " s, ",
+        parameters.size() / serial_time.count(), " solves/s, wrong solutions: ",
+        CountWrongSolutions(serial_results, parameters));
+
+  // One program plus a vector of parameter sets. Only the right-hand side of x(0) + x(1) = b
+  // changes, so each worker rewrites the existing LinearEqualityConstraint in place.
+  drake_tutorials::ProgramFamily family;
+  family.build = [] { return drake_tutorials::MakeFeasibleProgram(0); };
+  family.set_parameters = [](const Eigen::VectorXd& p, drake::solvers::MathematicalProgram* prog) {
+    prog->linear_equality_constraints().front().evaluator()->UpdateCoefficients(
+        Eigen::RowVector2d(1, 1), p);
+  };
+
+  drake_tutorials::BatchSolveStatistics single_thread_stats;
+  {
+    drake_tutorials::ThreadPool pool(1);
+    auto results = drake_tutorials::SolveInBatch(family, parameters, std::nullopt, &pool,
+                                                 &single_thread_stats);
+    PrintStatistics("parameter batch", single_thread_stats);
+    print("wrong solutions: ", CountWrongSolutions(results, parameters));
+  }
+  drake_tutorials::ThreadPool pool(num_threads);
+  drake_tutorials::BatchSolveStatistics stats;
+  auto results = drake_tutorials::SolveInBatch(family, parameters, std::nullopt, &pool, &stats);
+  PrintStatistics("parameter batch", stats);
+  print("wrong solutions: ", CountWrongSolutions(results, parameters));
+  print("speedup over 1 thread: ", stats.solves_per_second / single_thread_stats.solves_per_second,
+        " (ideal ", num_threads, ")");
+
+  // A vector of independently built programs.
+  std::vector<std::unique_ptr<drake::solvers::MathematicalProgram>> programs;
+  std::vector<const drake::solvers::MathematicalProgram*> program_ptrs;
+  for (const auto& p : parameters) {
+    programs.push_back(drake_tutorials::MakeFeasibleProgram(p(0)));
+    program_ptrs.push_back(programs.back().get());
+  }
+  results = drake_tutorials::SolveInBatch(program_ptrs, std::nullopt, &pool, &stats);
+  PrintStatistics("program batch", stats);
+  print("wrong solutions: ", CountWrongSolutions(results, parameters));
+  return 0;
+}
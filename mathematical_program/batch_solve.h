@@ -0,0 +1,129 @@
+#pragma once
+
+#include <drake/solvers/choose_best_solver.h>
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/solver_interface.h>
+
+#include "solver_concurrency.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace drake_tutorials {
+
+struct BatchSolveStatistics {
+  int num_programs{0};
+  int num_threads{0};
+  // Wall-clock time of the whole batch in seconds.
+  double wall_time{0};
+  double solves_per_second{0};
+};
+
+// A family of programs that share their structure and only differ in data. `build` is called
+// once per worker; `set_parameters` rewrites the data of such an instance in place before every
+// solve, so the symbolic construction is not repeated for each parameter set.
+struct ProgramFamily {
+  std::function<std::unique_ptr<drake::solvers::MathematicalProgram>()> build;
+  std::function<void(const Eigen::VectorXd& parameters, drake::solvers::MathematicalProgram* prog)>
+      set_parameters;
+};
+
+namespace internal {
+
+// Solver instances owned by one worker, created on first use and reused afterwards.
+class WorkerSolvers {
+ public:
+  const drake::solvers::SolverInterface& Get(const drake::solvers::SolverId& id) {
+    auto it = solvers_.find(id);
+    if (it == solvers_.end()) {
+      it = solvers_.emplace(id, drake::solvers::MakeSolver(id)).first;
+    }
+    return *it->second;
+  }
+
+ private:
+  std::unordered_map<drake::solvers::SolverId, std::unique_ptr<drake::solvers::SolverInterface>>
+      solvers_;
+};
+
+inline int DefaultGrainSize(int num_programs, int num_threads) {
+  // A few chunks per worker keep the deques stealable without paying for one task per solve.
+  return std::max(1, num_programs / (16 * num_threads));
+}
+
+inline void FillStatistics(int num_programs, int num_threads,
+                           std::chrono::steady_clock::time_point start,
+                           BatchSolveStatistics* statistics) {
+  if (statistics == nullptr) {
+    return;
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  statistics->num_programs = num_programs;
+  statistics->num_threads = num_threads;
+  statistics->wall_time = elapsed.count();
+  statistics->solves_per_second = elapsed.count() > 0 ? num_programs / elapsed.count() : 0;
+}
+
+}  // namespace internal
+
+// Solves every program in `progs` on `pool` and returns the results in input order. Each worker
+// keeps one solver instance per solver id, picked with ChooseBestSolver() for every program.
+// The programs are only read, so they must not be modified while the batch is running. Solves
+// go through SolveConcurrently() (see solver_concurrency.h).
+inline std::vector<drake::solvers::MathematicalProgramResult> SolveInBatch(
+    const std::vector<const drake::solvers::MathematicalProgram*>& progs,
+    const std::optional<drake::solvers::SolverOptions>& solver_options, ThreadPool* pool,
+    BatchSolveStatistics* statistics = nullptr) {
+  const int n = static_cast<int>(progs.size());
+  std::vector<drake::solvers::MathematicalProgramResult> results(n);
+  std::vector<internal::WorkerSolvers> solvers(pool->num_threads());
+  const auto start = std::chrono::steady_clock::now();
+  pool->ParallelFor(
+      n,
+      [&](int worker, int i) {
+        const auto& prog = *progs[i];
+        const auto& solver = solvers[worker].Get(drake::solvers::ChooseBestSolver(prog));
+        SolveConcurrently(solver, prog, std::nullopt, solver_options, &results[i]);
+      },
+      internal::DefaultGrainSize(n, pool->num_threads()));
+  internal::FillStatistics(n, pool->num_threads(), start, statistics);
+  return results;
+}
+
+// Solves one instance of `family` per parameter set and returns the results in input order.
+// Every worker builds its own program instance and solver once, then only updates the data.
+inline std::vector<drake::solvers::MathematicalProgramResult> SolveInBatch(
+    const ProgramFamily& family, const std::vector<Eigen::VectorXd>& parameters,
+    const std::optional<drake::solvers::SolverOptions>& solver_options, ThreadPool* pool,
+    BatchSolveStatistics* statistics = nullptr) {
+  struct WorkerState {
+    std::unique_ptr<drake::solvers::MathematicalProgram> prog;
+    std::unique_ptr<drake::solvers::SolverInterface> solver;
+  };
+  const int n = static_cast<int>(parameters.size());
+  std::vector<drake::solvers::MathematicalProgramResult> results(n);
+  std::vector<WorkerState> states(pool->num_threads());
+  const auto start = std::chrono::steady_clock::now();
+  pool->ParallelFor(
+      n,
+      [&](int worker, int i) {
+        WorkerState& state = states[worker];
+        if (state.prog == nullptr) {
+          state.prog = family.build();
+          state.solver = drake::solvers::MakeSolver(drake::solvers::ChooseBestSolver(*state.prog));
+        }
+        family.set_parameters(parameters[i], state.prog.get());
+        SolveConcurrently(*state.solver, *state.prog, std::nullopt, solver_options, &results[i]);
+      },
+      internal::DefaultGrainSize(n, pool->num_threads()));
+  internal::FillStatistics(n, pool->num_threads(), start, statistics);
+  return results;
+}
+
+}  // namespace drake_tutorials
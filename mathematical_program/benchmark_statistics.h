@@ -0,0 +1,22 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace drake_tutorials {
+
+// Returns the value below which `fraction` of `values` lie (nearest rank), or NaN if `values` is
+// empty.
+inline double Percentile(std::vector<double> values, double fraction) {
+  if (values.empty()) {
+    return NAN;
+  }
+  const std::size_t k =
+      std::min(values.size() - 1, static_cast<std::size_t>(fraction * values.size()));
+  std::nth_element(values.begin(), values.begin() + k, values.end());
+  return values[k];
+}
+
+}  // namespace drake_tutorials
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <drake/solvers/choose_best_solver.h>
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/solver_interface.h>
+
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace drake_tutorials {
+
+/*
+ * A MathematicalProgram whose structure is built once and whose data is exposed as named
+ * parameters.
+ *
+ * Every parameter refers to a Binding of the program and rewrites its evaluator in place, so a
+ * repeated solve neither parses symbolic expressions nor adds new constraints or costs. The solver
+ * is picked with ChooseBestSolver() on the first solve and reused afterwards.
+ */
+class CompiledProgram {
+ public:
+  enum class ParameterKind {
+    // Lower/upper bound vector of a linear constraint.
+    kLowerBound,
+    kUpperBound,
+    // Right-hand side beq of a linear equality constraint Aeq * x = beq.
+    kEqualityRhs,
+    // Coefficient matrix A of a linear (equality) constraint.
+    kConstraintMatrix,
+    // Q and b of a quadratic cost 0.5 x'Qx + b'x + c.
+    kQuadraticCostHessian,
+    kQuadraticCostLinearTerm,
+    // a of a linear cost a'x + b.
+    kLinearCostCoefficients,
+  };
+
+  CompiledProgram() = default;
+  CompiledProgram(const CompiledProgram&) = delete;
+  CompiledProgram& operator=(const CompiledProgram&) = delete;
+
+  drake::solvers::MathematicalProgram& prog() { return prog_; }
+  const drake::solvers::MathematicalProgram& prog() const { return prog_; }
+
+  // Linear equality constraints are rejected with std::invalid_argument, since moving one side
+  // would break lb == ub; declare their right-hand side with DeclareEqualityRhs() instead.
+  void DeclareLowerBound(const std::string& name,
+                         const drake::solvers::Binding<drake::solvers::LinearConstraint>& binding) {
+    CheckNotEquality(name, binding);
+    Declare(name, ParameterKind::kLowerBound, binding);
+  }
+  void DeclareUpperBound(const std::string& name,
+                         const drake::solvers::Binding<drake::solvers::LinearConstraint>& binding) {
+    CheckNotEquality(name, binding);
+    Declare(name, ParameterKind::kUpperBound, binding);
+  }
+  void DeclareEqualityRhs(
+      const std::string& name,
+      const drake::solvers::Binding<drake::solvers::LinearEqualityConstraint>& binding) {
+    Declare(name, ParameterKind::kEqualityRhs, binding);
+  }
+  void DeclareConstraintMatrix(
+      const std::string& name,
+      const drake::solvers::Binding<drake::solvers::LinearConstraint>& binding) {
+    Declare(name, ParameterKind::kConstraintMatrix, binding);
+  }
+  void DeclareConstraintMatrix(
+      const std::string& name,
+      const drake::solvers::Binding<drake::solvers::LinearEqualityConstraint>& binding) {
+    Declare(name, ParameterKind::kConstraintMatrix, binding);
+  }
+  void DeclareQuadraticCostHessian(
+      const std::string& name,
+      const drake::solvers::Binding<drake::solvers::QuadraticCost>& binding) {
+    Declare(name, ParameterKind::kQuadraticCostHessian, binding);
+  }
+  void DeclareQuadraticCostLinearTerm(
+      const std::string& name,
+      const drake::solvers::Binding<drake::solvers::QuadraticCost>& binding) {
+    Declare(name, ParameterKind::kQuadraticCostLinearTerm, binding);
+  }
+  void DeclareLinearCostCoefficients(
+      const std::string& name, const drake::solvers::Binding<drake::solvers::LinearCost>& binding) {
+    Declare(name, ParameterKind::kLinearCostCoefficients, binding);
+  }
+
+  // Returns the index of a declared parameter, to skip the name lookup in SetParameter().
+  int FindParameter(const std::string& name) const {
+    const auto it = parameter_indices_.find(name);
+    if (it == parameter_indices_.end()) {
+      throw std::out_of_range("CompiledProgram: no parameter named '" + name + "'.");
+    }
+    return it->second;
+  }
+
+  void SetParameter(const std::string& name, const Eigen::Ref<const Eigen::MatrixXd>& value) {
+    SetParameter(FindParameter(name), value);
+  }
+
+  void SetParameter(int index, const Eigen::Ref<const Eigen::MatrixXd>& value) {
+    Parameter& parameter = parameters_.at(index);
+    switch (parameter.kind) {
+      case ParameterKind::kLowerBound: {
+        auto& c = *std::get<LinearConstraintBinding>(parameter.binding).evaluator();
+        CheckSize(parameter, value, c.num_constraints(), 1);
+        c.UpdateLowerBound(value.col(0));
+        break;
+      }
+      case ParameterKind::kUpperBound: {
+        auto& c = *std::get<LinearConstraintBinding>(parameter.binding).evaluator();
+        CheckSize(parameter, value, c.num_constraints(), 1);
+        c.UpdateUpperBound(value.col(0));
+        break;
+      }
+      case ParameterKind::kEqualityRhs: {
+        // Keeps Aeq, which UpdateCoefficients() takes in sparse form without densifying it.
+        auto& c = *std::get<LinearEqualityConstraintBinding>(parameter.binding).evaluator();
+        CheckSize(parameter, value, c.num_constraints(), 1);
+        c.UpdateCoefficients(c.get_sparse_A(), value.col(0));
+        break;
+      }
+      case ParameterKind::kConstraintMatrix: {
+        if (auto* b = std::get_if<LinearEqualityConstraintBinding>(&parameter.binding)) {
+          auto& c = *b->evaluator();
+          CheckSize(parameter, value, c.num_constraints(), c.num_vars());
+          c.UpdateCoefficients(value, c.lower_bound());
+        } else {
+          auto& c = *std::get<LinearConstraintBinding>(parameter.binding).evaluator();
+          CheckSize(parameter, value, c.num_constraints(), c.num_vars());
+          c.UpdateCoefficients(value, c.lower_bound(), c.upper_bound());
+        }
+        break;
+      }
+      case ParameterKind::kQuadraticCostHessian: {
+        auto& c = *std::get<QuadraticCostBinding>(parameter.binding).evaluator();
+        CheckSize(parameter, value, c.num_vars(), c.num_vars());
+        c.UpdateCoefficients(value, c.b(), c.c());
+        break;
+      }
+      case ParameterKind::kQuadraticCostLinearTerm: {
+        auto& c = *std::get<QuadraticCostBinding>(parameter.binding).evaluator();
+        CheckSize(parameter, value, c.num_vars(), 1);
+        c.UpdateCoefficients(c.Q(), value.col(0), c.c());
+        break;
+      }
+      case ParameterKind::kLinearCostCoefficients: {
+        auto& c = *std::get<LinearCostBinding>(parameter.binding).evaluator();
+        CheckSize(parameter, value, c.num_vars(), 1);
+        c.UpdateCoefficients(value.col(0), c.b());
+        break;
+      }
+    }
+  }
+
+  // Solves the program with its current data. The returned reference stays valid until the next
+  // call.
+  const drake::solvers::MathematicalProgramResult& Solve(
+      const std::optional<Eigen::VectorXd>& initial_guess = std::nullopt,
+      const std::optional<drake::solvers::SolverOptions>& solver_options = std::nullopt) {
+    if (solver_ == nullptr) {
+      solver_ = drake::solvers::MakeSolver(drake::solvers::ChooseBestSolver(prog_));
+    }
+    solver_->Solve(prog_, initial_guess, solver_options, &result_);
+    return result_;
+  }
+
+ private:
+  using LinearConstraintBinding = drake::solvers::Binding<drake::solvers::LinearConstraint>;
+  using LinearEqualityConstraintBinding =
+      drake::solvers::Binding<drake::solvers::LinearEqualityConstraint>;
+  using QuadraticCostBinding = drake::solvers::Binding<drake::solvers::QuadraticCost>;
+  using LinearCostBinding = drake::solvers::Binding<drake::solvers::LinearCost>;
+
+  struct Parameter {
+    std::string name;
+    ParameterKind kind;
+    std::variant<LinearConstraintBinding, LinearEqualityConstraintBinding, QuadraticCostBinding,
+                 LinearCostBinding>
+        binding;
+  };
+
+  template <typename BindingType>
+  void Declare(const std::string& name, ParameterKind kind, const BindingType& binding) {
+    if (parameter_indices_.count(name) > 0) {
+      throw std::invalid_argument("CompiledProgram: parameter '" + name + "' declared twice.");
+    }
+    parameter_indices_.emplace(name, static_cast<int>(parameters_.size()));
+    parameters_.push_back(Parameter{name, kind, binding});
+  }
+
+  static void CheckNotEquality(const std::string& name, const LinearConstraintBinding& binding) {
+    if (dynamic_cast<const drake::solvers::LinearEqualityConstraint*>(binding.evaluator().get())) {
+      throw std::invalid_argument("CompiledProgram: parameter '" + name + "' binds a linear "
+                                  "equality constraint; use DeclareEqualityRhs() for it.");
+    }
+  }
+
+  static void CheckSize(const Parameter& parameter, const Eigen::Ref<const Eigen::MatrixXd>& value,
+                        int rows, int cols) {
+    if (value.rows() != rows || value.cols() != cols) {
+      throw std::invalid_argument("CompiledProgram: parameter '" + parameter.name + "' expects a " +
+                                  std::to_string(rows) + "x" + std::to_string(cols) +
+                                  " value, got " + std::to_string(value.rows()) + "x" +
+                                  std::to_string(value.cols()) + ".");
+    }
+  }
+
+  drake::solvers::MathematicalProgram prog_;
+  std::vector<Parameter> parameters_;
+  std::unordered_map<std::string, int> parameter_indices_;
+  std::unique_ptr<drake::solvers::SolverInterface> solver_;
+  drake::solvers::MathematicalProgramResult result_;
+};
+
+}  // namespace drake_tutorials
@@ -0,0 +1,120 @@
+#include <drake/common/eigen_types.h>
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/solve.h>
+
+#include <gflags/gflags.h>
+
+#include "compiled_program.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+
+DEFINE_int32(num_solves, 10000, "Number of solves per benchmark.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+// Runs `solve(i)` for every i and prints the median and mean latency in microseconds.
+void Benchmark(const std::string& name, int n, const std::function<bool(int)>& solve) {
+  std::vector<double> latencies(n);
+  int num_success = 0;
+  for (int i = 0; i < n; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    num_success += solve(i);
+    const std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    latencies[i] = elapsed.count();
+  }
+  double total = 0;
+  for (double latency : latencies) {
+    total += latency;
+  }
+  std::nth_element(latencies.begin(), latencies.begin() + n / 2, latencies.end());
+  print(name, ": median ", latencies[n / 2], " us, mean ", total / n, " us, ", num_success, "/",
+        n, " successful");
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  const int n = FLAGS_num_solves;
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> distribution(0.5, 2);
+  std::vector<double> data(n);
+  for (auto& value : data) {
+    value = distribution(generator);
+  }
+
+  /*
+   * simple_optimization_problem_feasible.cpp with a varying right-hand side b
+   *    min x(0)^2 + x(1)^2
+   * subject to x(0) + x(1) = b
+   *        x(0) <= x(1)
+   */
+  Benchmark("feasible, rebuild per solve", n, [&](int i) {
+    auto prog = drake::solvers::MathematicalProgram();
+    auto x = prog.NewContinuousVariables(2);
+    prog.AddConstraint(x[0] + x[1] == data[i]);
+    prog.AddConstraint(x[0] <= x[1]);
+    prog.AddCost(pow(x[0], 2) + pow(x[1], 2));
+    return drake::solvers::Solve(prog).is_success();
+  });
+
+  drake_tutorials::CompiledProgram feasible;
+  {
+    auto x = feasible.prog().NewContinuousVariables(2);
+    feasible.DeclareEqualityRhs("b", feasible.prog().AddLinearEqualityConstraint(x[0] + x[1] == 1));
+    feasible.prog().AddLinearConstraint(x[0] <= x[1]);
+    feasible.DeclareQuadraticCostHessian(
+        "Q", feasible.prog().AddQuadraticCost(pow(x[0], 2) + pow(x[1], 2)));
+  }
+  const int b = feasible.FindParameter("b");
+  Benchmark("feasible, in-place update", n, [&](int i) {
+    feasible.SetParameter(b, drake::Vector1d(data[i]));
+    return feasible.Solve().is_success();
+  });
+
+  // The Hessian is a parameter as well; rewriting it in place costs the same as the bounds.
+  const int Q = feasible.FindParameter("Q");
+  Benchmark("feasible, in-place Hessian update", n, [&](int i) {
+    feasible.SetParameter(Q, 2 * data[i] * Eigen::Matrix2d::Identity());
+    return feasible.Solve().is_success();
+  });
+
+  /*
+   * simple_optimization_problem_infeasible.cpp with a varying lower bound
+   *    min x
+   * subject to x + y >= lower
+   *            x + y <= 0
+   */
+  Benchmark("infeasible, rebuild per solve", n, [&](int i) {
+    auto prog = drake::solvers::MathematicalProgram();
+    auto x = prog.NewContinuousVariables(1)[0];
+    auto y = prog.NewContinuousVariables(1)[0];
+    prog.AddConstraint(x + y >= data[i]);
+    prog.AddConstraint(x + y <= 0);
+    prog.AddCost(x);
+    return drake::solvers::Solve(prog).get_solution_result() ==
+           drake::solvers::SolutionResult::kInfeasibleConstraints;
+  });
+
+  drake_tutorials::CompiledProgram infeasible;
+  {
+    auto x = infeasible.prog().NewContinuousVariables(1)[0];
+    auto y = infeasible.prog().NewContinuousVariables(1)[0];
+    infeasible.DeclareLowerBound("lower", infeasible.prog().AddLinearConstraint(x + y >= 1));
+    infeasible.DeclareUpperBound("upper", infeasible.prog().AddLinearConstraint(x + y <= 0));
+    infeasible.DeclareLinearCostCoefficients("a", infeasible.prog().AddLinearCost(x));
+  }
+  const int lower = infeasible.FindParameter("lower");
+  Benchmark("infeasible, in-place update", n, [&](int i) {
+    infeasible.SetParameter(lower, drake::Vector1d(data[i]));
+    return infeasible.Solve().get_solution_result() ==
+           drake::solvers::SolutionResult::kInfeasibleConstraints;
+  });
+  return 0;
+}
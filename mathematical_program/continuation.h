@@ -0,0 +1,257 @@
+#pragma once
+
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+
+#include "batch_solve.h"
+#include "solver_concurrency.h"
+#include "thread_pool.h"
+#include "warm_start_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace drake_tutorials {
+
+struct ContinuationOptions {
+  // Initial guess of the first solve of every segment.
+  std::optional<Eigen::VectorXd> initial_guess;
+  // Number of independent pieces the path is cut into. Each piece starts cold and is followed on
+  // its own worker.
+  int num_segments{1};
+  // Largest parameter step (Euclidean distance) taken in one solve; longer steps between two
+  // requested values are split. After a failed solve the step is multiplied by `shrink`, after a
+  // successful one by `growth`, up to `max_step`. Below `min_step` the driver gives up on
+  // continuation and solves the requested value cold.
+  double max_step{std::numeric_limits<double>::infinity()};
+  double min_step{1e-8};
+  double shrink{0.5};
+  double growth{2};
+  // Extrapolate the initial guess linearly from the last two solutions (secant predictor).
+  // Otherwise the last solution is used as it is.
+  bool predictor{true};
+  std::optional<drake::solvers::SolverOptions> solver_options;
+};
+
+struct ContinuationStep {
+  int segment{0};
+  // Index of the requested parameter value this solve was for, or -1 for an intermediate step.
+  int target{-1};
+  Eigen::VectorXd parameters;
+  Eigen::VectorXd initial_guess;
+  Eigen::VectorXd x;
+  bool success{false};
+  // Whether the solve was warm started from earlier solutions of the path.
+  bool warm{false};
+  double cost{std::numeric_limits<double>::infinity()};
+  // Number of Ipopt iterations, counted through a visualization callback.
+  int iterations{0};
+};
+
+struct ContinuationResult {
+  // Every solve, including failed and intermediate ones, in path order.
+  std::vector<ContinuationStep> steps;
+  // For every requested parameter value, the index of its final solve in `steps`.
+  std::vector<int> solutions;
+  int total_iterations{0};
+  int num_failed_solves{0};
+  double wall_time{0};
+
+  const ContinuationStep& solution(int target) const { return steps[solutions[target]]; }
+};
+
+namespace internal {
+
+// Follows one segment of the path on one worker.
+class ContinuationSegment {
+ public:
+  ContinuationSegment(int segment, const ContinuationOptions& options,
+                      drake::solvers::MathematicalProgram* prog,
+                      const drake::solvers::IpoptSolver& solver, const ProgramFamily& family,
+                      const int* iterations)
+      : segment_(segment),
+        options_(options),
+        prog_(prog),
+        solver_(solver),
+        family_(family),
+        iterations_(iterations),
+        step_(options.max_step) {}
+
+  void Follow(const std::vector<Eigen::VectorXd>& targets, int begin, int end,
+              std::vector<ContinuationStep>* steps) {
+    for (int t = begin; t < end; ++t) {
+      if (history_.empty()) {
+        Cold(targets[t], t, steps);
+        continue;
+      }
+      while (true) {
+        const Eigen::VectorXd& from = history_.back().parameters;
+        const double distance = (targets[t] - from).norm();
+        const bool reaches_target = distance <= step_;
+        const Eigen::VectorXd next =
+            reaches_target ? targets[t] : (from + (targets[t] - from) * (step_ / distance)).eval();
+        const ContinuationStep& step = Solve(next, Predict(next), true, reaches_target ? t : -1,
+                                             steps);
+        if (step.success) {
+          Push(step);
+          step_ = std::min(options_.max_step, options_.growth * std::max(step_, distance));
+          if (reaches_target) {
+            break;
+          }
+          continue;
+        }
+        step_ = options_.shrink * std::min(step_, distance);
+        if (step_ < options_.min_step) {
+          step_ = options_.max_step;
+          Cold(targets[t], t, steps);
+          break;
+        }
+      }
+    }
+  }
+
+ private:
+  void Cold(const Eigen::VectorXd& parameters, int target, std::vector<ContinuationStep>* steps) {
+    const Eigen::VectorXd guess =
+        options_.initial_guess.value_or(Eigen::VectorXd::Zero(prog_->num_vars()));
+    const ContinuationStep& step = Solve(parameters, guess, false, target, steps);
+    history_.clear();
+    if (step.success) {
+      Push(step);
+    }
+  }
+
+  const ContinuationStep& Solve(const Eigen::VectorXd& parameters, const Eigen::VectorXd& guess,
+                                bool warm, int target, std::vector<ContinuationStep>* steps) {
+    family_.set_parameters(parameters, prog_);
+    drake::solvers::MathematicalProgramResult result;
+    const int iterations_before = *iterations_;
+    if (warm) {
+      SolveConcurrently(solver_, *prog_, guess, IpoptWarmStartOptions(options_.solver_options),
+                        &result);
+    } else {
+      SolveConcurrently(solver_, *prog_, guess, options_.solver_options, &result);
+    }
+    ContinuationStep& step = steps->emplace_back();
+    step.segment = segment_;
+    step.target = target;
+    step.parameters = parameters;
+    step.initial_guess = guess;
+    step.x = result.get_x_val();
+    step.success = result.is_success();
+    step.warm = warm;
+    step.cost = result.get_optimal_cost();
+    step.iterations = *iterations_ - iterations_before;
+    return step;
+  }
+
+  // Secant predictor: moves the last solution along the chord through the last two solutions, by
+  // the projection of the parameter step onto the last parameter step.
+  Eigen::VectorXd Predict(const Eigen::VectorXd& parameters) const {
+    const ContinuationStep& last = history_.back();
+    if (!options_.predictor || history_.size() < 2) {
+      return last.x;
+    }
+    const ContinuationStep& before = history_.front();
+    const Eigen::VectorXd dp = last.parameters - before.parameters;
+    const double dp_squared = dp.squaredNorm();
+    if (dp_squared == 0) {
+      return last.x;
+    }
+    const double alpha = (parameters - last.parameters).dot(dp) / dp_squared;
+    return last.x + alpha * (last.x - before.x);
+  }
+
+  // Keeps the last two successful steps.
+  void Push(const ContinuationStep& step) {
+    if (history_.size() == 2) {
+      history_.erase(history_.begin());
+    }
+    history_.push_back(step);
+  }
+
+  int segment_;
+  const ContinuationOptions& options_;
+  drake::solvers::MathematicalProgram* prog_;
+  const drake::solvers::IpoptSolver& solver_;
+  const ProgramFamily& family_;
+  const int* iterations_;
+  double step_;
+  std::vector<ContinuationStep> history_;
+};
+
+}  // namespace internal
+
+/*
+ * Solves one instance of `family` for each parameter vector in `targets`, following the path
+ * through them in order with IpoptSolver.
+ *
+ * Every solve is warm started from the previous solutions along the path: the initial guess is
+ * extrapolated by a secant predictor, and Ipopt starts with a small barrier parameter (see
+ * internal::IpoptWarmStartOptions(); Drake's IpoptSolver does not accept dual initial guesses).
+ * When a solve fails, the step towards the next requested value is shortened and intermediate
+ * parameter values are inserted; successful steps let it grow again. Staying on one solution
+ * branch this way avoids the jumps between local minima that cold starts make.
+ *
+ * The path is cut into `options.num_segments` contiguous segments that are followed in parallel
+ * on `pool`, each with its own program instance (family.build()) and solver. The first solve of
+ * each segment is cold, from `options.initial_guess`. See solver_concurrency.h for when the
+ * segments' solves actually overlap.
+ */
+inline ContinuationResult SolveContinuation(const ProgramFamily& family,
+                                            const std::vector<Eigen::VectorXd>& targets,
+                                            const ContinuationOptions& options, ThreadPool* pool) {
+  if (options.shrink <= 0 || options.shrink >= 1 || options.growth < 1 || options.min_step <= 0) {
+    throw std::invalid_argument("SolveContinuation: need 0 < shrink < 1, growth >= 1 and "
+                                "min_step > 0.");
+  }
+  const int n = static_cast<int>(targets.size());
+  const int num_segments = std::clamp(options.num_segments, 1, std::max(1, n));
+  struct WorkerState {
+    std::unique_ptr<drake::solvers::MathematicalProgram> prog;
+    drake::solvers::IpoptSolver solver;
+    int iterations{0};
+  };
+  std::vector<WorkerState> states(pool->num_threads());
+  std::vector<std::vector<ContinuationStep>> segment_steps(num_segments);
+
+  const auto start = std::chrono::steady_clock::now();
+  pool->ParallelFor(num_segments, [&](int worker, int segment) {
+    WorkerState& state = states[worker];
+    if (state.prog == nullptr) {
+      state.prog = family.build();
+      state.prog->AddVisualizationCallback(
+          [&state](const Eigen::Ref<const Eigen::VectorXd>&) { ++state.iterations; },
+          state.prog->decision_variables());
+    }
+    internal::ContinuationSegment follower(segment, options, state.prog.get(), state.solver,
+                                           family, &state.iterations);
+    const int begin = static_cast<int>(static_cast<long>(n) * segment / num_segments);
+    const int end = static_cast<int>(static_cast<long>(n) * (segment + 1) / num_segments);
+    follower.Follow(targets, begin, end, &segment_steps[segment]);
+  });
+  const std::chrono::duration<double> wall_time = std::chrono::steady_clock::now() - start;
+
+  ContinuationResult result;
+  result.wall_time = wall_time.count();
+  result.solutions.assign(n, -1);
+  for (auto& steps : segment_steps) {
+    for (auto& step : steps) {
+      result.total_iterations += step.iterations;
+      result.num_failed_solves += !step.success;
+      if (step.target >= 0) {
+        result.solutions[step.target] = static_cast<int>(result.steps.size());
+      }
+      result.steps.push_back(std::move(step));
+    }
+  }
+  return result;
+}
+
+}  // namespace drake_tutorials
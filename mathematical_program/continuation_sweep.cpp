@@ -0,0 +1,92 @@
+#include <drake/solvers/mathematical_program.h>
+
+#include <gflags/gflags.h>
+
+#include "continuation.h"
+#include "tutorial_programs.h"
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+DEFINE_int32(num_values, 2000, "Number of radius_squared values in the sweep.");
+DEFINE_double(first, 100, "First value of radius_squared.");
+DEFINE_double(last, 10000, "Last value of radius_squared.");
+DEFINE_int32(num_threads, 1,
+             "Number of worker threads; 0 means one per hardware thread. See "
+             "solver_concurrency.h for when Ipopt solves run in parallel.");
+DEFINE_int32(num_segments, 0, "Number of path segments followed in parallel; 0 means one per "
+             "thread.");
+DEFINE_string(output, "continuation_path.csv", "Path of the CSV with every solve of the path.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+// Number of neighbouring requested values whose solutions lie on different branches, x(1) > 0
+// and x(1) < 0, of good_or_bad_initial_guess.cpp's two local minima.
+int CountBranchSwitches(const drake_tutorials::ContinuationResult& result) {
+  int num_switches = 0;
+  for (size_t t = 1; t < result.solutions.size(); ++t) {
+    num_switches += (result.solution(t).x(1) > 0) != (result.solution(t - 1).x(1) > 0);
+  }
+  return num_switches;
+}
+
+void PrintSummary(const std::string& name, const drake_tutorials::ContinuationResult& result) {
+  int num_failed_targets = 0;
+  for (size_t t = 0; t < result.solutions.size(); ++t) {
+    num_failed_targets += !result.solution(t).success;
+  }
+  print(name, ": ", result.steps.size(), " solves for ", result.solutions.size(), " values in ",
+        result.wall_time, " s, ", result.total_iterations, " Ipopt iterations (",
+        static_cast<double>(result.total_iterations) / result.solutions.size(),
+        " per value), ", result.num_failed_solves, " failed solves, ", num_failed_targets,
+        " unsolved values, ", CountBranchSwitches(result), " branch switches");
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  const int num_threads = FLAGS_num_threads > 0 ? FLAGS_num_threads
+                                                : drake_tutorials::ThreadPool::DefaultNumThreads();
+  drake_tutorials::ThreadPool pool(num_threads);
+
+  // good_or_bad_initial_guess.cpp with the radius as the parameter. The circle constraint is a
+  // QuadraticConstraint with bounds radius_squared, which a new value updates in place.
+  drake_tutorials::ProgramFamily family;
+  family.build = [] { return drake_tutorials::MakeCircleProgram(FLAGS_first); };
+  family.set_parameters = [](const Eigen::VectorXd& p, drake::solvers::MathematicalProgram* prog) {
+    prog->quadratic_constraints().front().evaluator()->set_bounds(p, p);
+  };
+
+  std::vector<Eigen::VectorXd> targets;
+  for (int i = 0; i < FLAGS_num_values; ++i) {
+    const double fraction = FLAGS_num_values > 1 ? static_cast<double>(i) / (FLAGS_num_values - 1)
+                                                 : 0;
+    targets.push_back(
+        Eigen::VectorXd::Constant(1, (1 - fraction) * FLAGS_first + fraction * FLAGS_last));
+  }
+
+  drake_tutorials::ContinuationOptions options;
+  options.initial_guess = Eigen::Vector2d(-5, 0);
+
+  // Cold starts: with one segment per value, every value is solved from the initial guess of
+  // the tutorial.
+  options.num_segments = FLAGS_num_values;
+  PrintSummary("cold", drake_tutorials::SolveContinuation(family, targets, options, &pool));
+
+  options.num_segments = FLAGS_num_segments > 0 ? FLAGS_num_segments : num_threads;
+  const auto result = drake_tutorials::SolveContinuation(family, targets, options, &pool);
+  PrintSummary("continuation", result);
+
+  std::ofstream out(FLAGS_output);
+  out << "segment,target,radius_squared,x0,x1,success,warm,iterations\n";
+  for (const auto& step : result.steps) {
+    out << step.segment << "," << step.target << "," << step.parameters(0) << "," << step.x(0)
+        << "," << step.x(1) << "," << step.success << "," << step.warm << "," << step.iterations
+        << "\n";
+  }
+  print("Wrote ", FLAGS_output);
+  return 0;
+}
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/osqp_solver.h>
+#include <drake/solvers/scs_solver.h>
+#include <drake/solvers/solver_interface.h>
+
+#include "batch_solve.h"
+#include "solver_concurrency.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace drake_tutorials {
+
+enum class DeadlineStatus {
+  // The solver converged before the deadline.
+  kOptimal,
+  // The best feasible iterate seen before the deadline.
+  kFeasibleSuboptimal,
+  // Nothing feasible before the deadline: the solution returned by the previous Solve(), or the
+  // initial guess if there was none.
+  kStale,
+};
+
+inline const char* to_string(DeadlineStatus status) {
+  switch (status) {
+    case DeadlineStatus::kOptimal:
+      return "optimal";
+    case DeadlineStatus::kFeasibleSuboptimal:
+      return "feasible-suboptimal";
+    case DeadlineStatus::kStale:
+      return "stale";
+  }
+  return "unknown";
+}
+
+struct DeadlineSolveOptions {
+  drake::solvers::SolverId solver_id{drake::solvers::IpoptSolver::id()};
+  // Fraction of the remaining budget passed on as the solver's own time limit. The rest absorbs
+  // the iteration that overruns the limit, so the solver usually finishes before the deadline.
+  double solver_time_fraction{0.8};
+  // Constraint tolerance for an iterate to count as feasible.
+  double feasibility_tolerance{1e-6};
+  std::optional<drake::solvers::SolverOptions> solver_options;
+};
+
+struct DeadlineResult {
+  Eigen::VectorXd x;
+  DeadlineStatus status{DeadlineStatus::kStale};
+  // The cost at x; NaN if x is stale.
+  double cost{NAN};
+  // Seconds from the call to Solve() to its return.
+  double latency{0};
+  // Iterates seen by the callback before the return; 0 for solvers without callback support.
+  int iterations{0};
+  // False if the deadline passed while the solver was still running.
+  bool solver_finished{false};
+};
+
+/*
+ * Solves a program family (see ProgramFamily) within a wall-clock budget per call, for control
+ * loops with a hard cycle time.
+ *
+ * The solve runs on a worker thread owned by the solver, and Solve() waits for it until the
+ * deadline at the latest, so it returns on time even if an iteration of the backend overruns
+ * the backend's own limit. The backend gets a time limit from the remaining budget (Ipopt
+ * max_wall_time, OSQP time_limit, SCS time_limit_secs) and, for Ipopt, an iteration limit from the
+ * measured time per iteration of earlier solves. A visualization callback, where the solver
+ * supports one, checks every iterate for feasibility and keeps the cheapest feasible one, so a
+ * solve cut off by the deadline still yields a usable point. The check evaluates every cost and
+ * constraint once per iterate.
+ *
+ * A solve that is still running at the deadline keeps the worker until the backend's limit stops
+ * it; a Solve() in the meantime waits for it within its own budget and returns kStale if it does
+ * not finish in time.
+ */
+class DeadlineSolver {
+ public:
+  explicit DeadlineSolver(ProgramFamily family, const DeadlineSolveOptions& options = {})
+      : family_(std::move(family)),
+        options_(options),
+        solver_(drake::solvers::MakeSolver(options.solver_id)),
+        prog_(family_.build()) {
+    prog_->AddVisualizationCallback(
+        [this](const Eigen::Ref<const Eigen::VectorXd>& x) { Offer(x, true); },
+        prog_->decision_variables());
+    if (!solver_->AreProgramAttributesSatisfied(*prog_)) {
+      // The solver does not take callbacks, e.g. OSQP; only its final solution is checked.
+      prog_ = family_.build();
+    }
+    constraints_ = prog_->GetAllConstraints();
+    costs_ = prog_->GetAllCosts();
+    worker_ = std::thread([this] { Work(); });
+  }
+
+  DeadlineSolver(const DeadlineSolver&) = delete;
+  DeadlineSolver& operator=(const DeadlineSolver&) = delete;
+
+  // Waits for a running solve to finish.
+  ~DeadlineSolver() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    work_.notify_all();
+    worker_.join();
+  }
+
+  DeadlineResult Solve(const Eigen::VectorXd& parameters, double budget_seconds,
+                       const std::optional<Eigen::VectorXd>& initial_guess = std::nullopt) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline =
+        start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(budget_seconds));
+    std::unique_lock<std::mutex> lock(mutex_);
+    DeadlineResult result;
+    // A solve that overran an earlier deadline still owns the program.
+    if (done_.wait_until(lock, deadline, [this] { return !busy_; })) {
+      const double remaining =
+          std::chrono::duration<double>(deadline - std::chrono::steady_clock::now()).count();
+      job_ = Job{parameters, initial_guess, LimitedOptions(remaining)};
+      ++generation_;
+      busy_ = true;
+      pending_ = true;
+      best_.reset();
+      best_cost_ = NAN;
+      iterations_ = 0;
+      solver_result_.reset();
+      work_.notify_one();
+      result.solver_finished = done_.wait_until(lock, deadline, [this] { return !busy_; });
+      result.iterations = iterations_;
+      if (result.solver_finished && solver_result_ && solver_result_->is_success()) {
+        result.x = solver_result_->get_x_val();
+        result.cost = solver_result_->get_optimal_cost();
+        result.status = DeadlineStatus::kOptimal;
+      } else if (best_) {
+        result.x = *best_;
+        result.cost = best_cost_;
+        result.status = DeadlineStatus::kFeasibleSuboptimal;
+      }
+      // Iterates of a solve that is still running no longer count.
+      ++generation_;
+    }
+    if (result.status == DeadlineStatus::kStale) {
+      result.x = last_x_.size() > 0 ? last_x_ : initial_guess.value_or(Eigen::VectorXd());
+    } else {
+      last_x_ = result.x;
+    }
+    result.latency =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+  }
+
+  // The running estimate of the backend's seconds per iteration; NaN before the first solve with
+  // a callback.
+  double seconds_per_iteration() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return seconds_per_iteration_;
+  }
+
+ private:
+  struct Job {
+    Eigen::VectorXd parameters;
+    std::optional<Eigen::VectorXd> initial_guess;
+    drake::solvers::SolverOptions options;
+  };
+
+  // The solver options with the backend's time and iteration limits for `seconds`.
+  drake::solvers::SolverOptions LimitedOptions(double seconds) const {
+    drake::solvers::SolverOptions options =
+        options_.solver_options.value_or(drake::solvers::SolverOptions());
+    const double limit = std::max(1e-6, options_.solver_time_fraction * seconds);
+    const auto& id = options_.solver_id;
+    if (id == drake::solvers::IpoptSolver::id()) {
+      options.SetOption(id, "max_wall_time", limit);
+      if (std::isfinite(seconds_per_iteration_)) {
+        options.SetOption(id, "max_iter",
+                          std::max(1, static_cast<int>(limit / seconds_per_iteration_)));
+      }
+    } else if (id == drake::solvers::OsqpSolver::id()) {
+      options.SetOption(id, "time_limit", limit);
+    } else if (id == drake::solvers::ScsSolver::id()) {
+      options.SetOption(id, "time_limit_secs", limit);
+    }
+    return options;
+  }
+
+  void Work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      work_.wait(lock, [this] { return stop_ || pending_; });
+      if (stop_) {
+        return;
+      }
+      pending_ = false;
+      const Job job = std::move(job_);
+      running_generation_ = generation_;
+      lock.unlock();
+
+      family_.set_parameters(job.parameters, prog_.get());
+      drake::solvers::MathematicalProgramResult result;
+      const auto start = std::chrono::steady_clock::now();
+      bool solved = true;
+      try {
+        SolveConcurrently(*solver_, *prog_, job.initial_guess, job.options, &result);
+      } catch (const std::exception&) {
+        solved = false;
+      }
+      const double elapsed =
+          std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      if (solved && !result.is_success() && result.get_x_val().size() == prog_->num_vars()) {
+        Offer(result.get_x_val(), false);
+      }
+
+      lock.lock();
+      if (running_generation_ == generation_) {
+        if (iterations_ > 0) {
+          const double per_iteration = elapsed / iterations_;
+          seconds_per_iteration_ = std::isfinite(seconds_per_iteration_)
+                                       ? 0.8 * seconds_per_iteration_ + 0.2 * per_iteration
+                                       : per_iteration;
+        }
+        if (solved) {
+          solver_result_ = std::move(result);
+        }
+      }
+      busy_ = false;
+      done_.notify_all();
+    }
+  }
+
+  // Keeps `x` as the best iterate of the running solve if it is feasible and cheaper. Runs on the
+  // worker thread, from the callback (an iterate) or after an unsuccessful solve (its last point).
+  void Offer(const Eigen::Ref<const Eigen::VectorXd>& x, bool is_iterate) {
+    const bool feasible =
+        prog_->CheckSatisfied(constraints_, x, options_.feasibility_tolerance);
+    double cost = 0;
+    if (feasible) {
+      for (const auto& binding : costs_) {
+        cost += prog_->EvalBinding(binding, x)(0);
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_generation_ != generation_) {
+      return;
+    }
+    iterations_ += is_iterate;
+    if (feasible && (!best_ || cost < best_cost_)) {
+      best_ = x;
+      best_cost_ = cost;
+    }
+  }
+
+  ProgramFamily family_;
+  DeadlineSolveOptions options_;
+  std::unique_ptr<drake::solvers::SolverInterface> solver_;
+  // Only used by the worker thread while a solve is running.
+  std::unique_ptr<drake::solvers::MathematicalProgram> prog_;
+  std::vector<drake::solvers::Binding<drake::solvers::Constraint>> constraints_;
+  std::vector<drake::solvers::Binding<drake::solvers::Cost>> costs_;
+
+  // Everything below is guarded by mutex_, except that running_generation_ is only written by
+  // the worker while it holds the lock.
+  mutable std::mutex mutex_;
+  std::condition_variable work_;
+  std::condition_variable done_;
+  bool stop_{false};
+  bool pending_{false};
+  bool busy_{false};
+  Job job_;
+  // Incremented when a solve starts and when its Solve() returns, so that late iterates of a
+  // solve cut off by the deadline are ignored.
+  std::uint64_t generation_{0};
+  std::uint64_t running_generation_{0};
+  std::optional<Eigen::VectorXd> best_;
+  double best_cost_{NAN};
+  int iterations_{0};
+  std::optional<drake::solvers::MathematicalProgramResult> solver_result_;
+  double seconds_per_iteration_{NAN};
+  Eigen::VectorXd last_x_;
+  std::thread worker_;
+};
+
+}  // namespace drake_tutorials
@@ -0,0 +1,135 @@
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+
+#include <gflags/gflags.h>
+
+#include "benchmark_statistics.h"
+#include "deadline_solve.h"
+#include "scaled_programs.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+DEFINE_int32(num_vars, 200, "Number of variables of the scaled add_callback.cpp program.");
+DEFINE_int32(cycles, 1000, "Number of control cycles.");
+DEFINE_double(budget_ms, 2, "Per-cycle budget in milliseconds; also the cycle period.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+// Latencies in milliseconds as a histogram over fractions of the budget, with the median, the
+// jitter (p99 - p50) and the worst case.
+void Report(const std::string& name, const std::vector<double>& latencies) {
+  if (latencies.empty()) {
+    print(name, ": no cycles");
+    return;
+  }
+  const double edges[] = {0.25, 0.5, 0.75, 1.0, 1.1, 1.5, 2.0};
+  std::vector<int> counts(std::size(edges) + 1, 0);
+  for (double latency : latencies) {
+    const double fraction = latency / FLAGS_budget_ms;
+    ++counts[std::upper_bound(std::begin(edges), std::end(edges), fraction) - std::begin(edges)];
+  }
+  std::ostringstream histogram;
+  histogram << std::fixed << std::setprecision(2);
+  for (size_t i = 0; i < counts.size(); ++i) {
+    histogram << "\n    " << (i == 0 ? 0.0 : edges[i - 1]) << " - ";
+    if (i < std::size(edges)) {
+      histogram << edges[i];
+    } else {
+      histogram << "inf ";
+    }
+    histogram << " budget: " << std::string(60 * counts[i] / latencies.size(), '#') << ' '
+              << counts[i];
+  }
+  const double p50 = drake_tutorials::Percentile(latencies, 0.5);
+  const double p99 = drake_tutorials::Percentile(latencies, 0.99);
+  print(name, ": median ", p50, " ms, p99 ", p99, " ms, jitter ", p99 - p50, " ms, worst ",
+        *std::max_element(latencies.begin(), latencies.end()), " ms", histogram.str());
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (FLAGS_cycles <= 0 || !(FLAGS_budget_ms > 0)) {
+    std::cerr << "--cycles and --budget_ms must be positive." << std::endl;
+    return 1;
+  }
+  const double budget = FLAGS_budget_ms * 1e-3;
+  const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(budget));
+
+  // add_callback.cpp over pairs, with the product x(2k) x(2k + 1) drifting over the cycles. All
+  // pairs share one constraint evaluator, so one set_bounds() moves them all.
+  drake_tutorials::ProgramFamily family;
+  family.build = [] { return drake_tutorials::MakeScaledBilinearProgram(FLAGS_num_vars); };
+  family.set_parameters = [](const Eigen::VectorXd& p, drake::solvers::MathematicalProgram* prog) {
+    prog->quadratic_constraints().front().evaluator()->set_bounds(p, p);
+  };
+  const auto parameters = [](int cycle) {
+    return drake::Vector1d(9 + 3 * std::sin(0.05 * cycle));
+  };
+  const Eigen::VectorXd initial_guess = Eigen::VectorXd::NullaryExpr(
+      2 * std::max(1, FLAGS_num_vars / 2), [](Eigen::Index i) { return i % 2 == 0 ? 4.0 : 5.0; });
+
+  // Ipopt until convergence, warm started from the previous cycle.
+  drake::solvers::SolverOptions options;
+  options.SetOption(drake::solvers::IpoptSolver::id(), "print_level", 0);
+  {
+    const drake::solvers::IpoptSolver solver;
+    auto prog = family.build();
+    Eigen::VectorXd x = initial_guess;
+    std::vector<double> latencies;
+    int missed = 0;
+    for (int cycle = 0; cycle < FLAGS_cycles; ++cycle) {
+      const auto start = std::chrono::steady_clock::now();
+      family.set_parameters(parameters(cycle), prog.get());
+      drake::solvers::MathematicalProgramResult result;
+      solver.Solve(*prog, x, options, &result);
+      if (result.is_success()) {
+        x = result.get_x_val();
+      }
+      latencies.push_back(
+          std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+              .count());
+      missed += latencies.back() > FLAGS_budget_ms;
+      std::this_thread::sleep_until(start + period);
+    }
+    Report("IpoptSolver::Solve()", latencies);
+    print("  ", missed, " of ", FLAGS_cycles, " cycles over budget");
+  }
+
+  drake_tutorials::DeadlineSolveOptions deadline_options;
+  deadline_options.solver_options = options;
+  drake_tutorials::DeadlineSolver solver(family, deadline_options);
+  Eigen::VectorXd x = initial_guess;
+  std::vector<double> latencies;
+  std::map<drake_tutorials::DeadlineStatus, int> statuses;
+  int missed = 0;
+  for (int cycle = 0; cycle < FLAGS_cycles; ++cycle) {
+    const auto start = std::chrono::steady_clock::now();
+    const drake_tutorials::DeadlineResult result = solver.Solve(parameters(cycle), budget, x);
+    x = result.x;
+    latencies.push_back(result.latency * 1e3);
+    ++statuses[result.status];
+    missed += latencies.back() > FLAGS_budget_ms;
+    std::this_thread::sleep_until(start + period);
+  }
+  Report("DeadlineSolver::Solve()", latencies);
+  print("  ", missed, " of ", FLAGS_cycles, " cycles over budget; ",
+        statuses[drake_tutorials::DeadlineStatus::kOptimal], " optimal, ",
+        statuses[drake_tutorials::DeadlineStatus::kFeasibleSuboptimal], " feasible-suboptimal, ",
+        statuses[drake_tutorials::DeadlineStatus::kStale], " stale; ",
+        solver.seconds_per_iteration() * 1e3, " ms per Ipopt iteration");
+  return 0;
+}
@@ -0,0 +1,658 @@
+#pragma once
+
+#include <drake/solvers/mathematical_program.h>
+
+#include "batch_solve.h"
+#include "infeasibility_precheck.h"
+#include "program_codec.h"
+#include "small_qp.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace drake_tutorials {
+
+// One critical region of a parametric QP: the parameters p with H p <= h, in which the set of
+// active constraints, and with it the affine solution x = K p + k, stays the same.
+struct ExplicitQpRegion {
+  // Rows of H have unit norm.
+  Eigen::MatrixXd H;
+  Eigen::VectorXd h;
+  Eigen::MatrixXd K;
+  Eigen::VectorXd k;
+  // Bounding box of the region.
+  Eigen::VectorXd lower;
+  Eigen::VectorXd upper;
+};
+
+/*
+ * The explicit solution of a parametric QP over a box of parameters: a piecewise-affine map from
+ * the parameters to the optimal solution, stored as critical regions.
+ *
+ * The regions are kept in flat arrays and indexed by a bounding volume hierarchy over their
+ * bounding boxes, so finding the region of a parameter vector takes a handful of box tests and
+ * the half-space tests of the few regions whose boxes contain it.
+ */
+class ExplicitQp {
+ public:
+  ExplicitQp(const Eigen::VectorXd& lower, const Eigen::VectorXd& upper, int num_vars,
+             const std::vector<ExplicitQpRegion>& regions, bool complete)
+      : lower_(lower), upper_(upper), num_vars_(num_vars), complete_(complete) {
+    const int p = lower.size();
+    int num_rows = 0;
+    for (const ExplicitQpRegion& region : regions) {
+      if (region.H.cols() != p || region.K.rows() != num_vars || region.K.cols() != p) {
+        throw std::invalid_argument("ExplicitQp: region of the wrong dimensions.");
+      }
+      num_rows += region.H.rows();
+    }
+    const int num_regions = regions.size();
+    row_begin_.assign(1, 0);
+    H_.resize(num_rows, p);
+    h_.resize(num_rows);
+    K_.resize(static_cast<Eigen::Index>(num_regions) * num_vars, p);
+    k_.resize(static_cast<Eigen::Index>(num_regions) * num_vars);
+    region_lower_.resize(p, num_regions);
+    region_upper_.resize(p, num_regions);
+    for (int r = 0; r < num_regions; ++r) {
+      const ExplicitQpRegion& region = regions[r];
+      H_.middleRows(row_begin_.back(), region.H.rows()) = region.H;
+      h_.segment(row_begin_.back(), region.h.size()) = region.h;
+      row_begin_.push_back(row_begin_.back() + region.H.rows());
+      K_.middleRows(static_cast<Eigen::Index>(r) * num_vars, num_vars) = region.K;
+      k_.segment(static_cast<Eigen::Index>(r) * num_vars, num_vars) = region.k;
+      region_lower_.col(r) = region.lower;
+      region_upper_.col(r) = region.upper;
+    }
+    order_.resize(num_regions);
+    std::iota(order_.begin(), order_.end(), 0);
+    if (num_regions > 0) {
+      std::vector<Eigen::VectorXd> node_lower, node_upper;
+      Build(0, num_regions, &node_lower, &node_upper);
+      node_lower_.resize(p, nodes_.size());
+      node_upper_.resize(p, nodes_.size());
+      for (size_t i = 0; i < nodes_.size(); ++i) {
+        node_lower_.col(i) = node_lower[i];
+        node_upper_.col(i) = node_upper[i];
+      }
+    }
+  }
+
+  int num_parameters() const { return lower_.size(); }
+  int num_vars() const { return num_vars_; }
+  int num_regions() const { return static_cast<int>(row_begin_.size()) - 1; }
+  const Eigen::VectorXd& lower() const { return lower_; }
+  const Eigen::VectorXd& upper() const { return upper_; }
+  // False if the region enumeration stopped at ExplicitQpOptions::max_regions.
+  bool complete() const { return complete_; }
+
+  ExplicitQpRegion region(int r) const {
+    const int num_rows = row_begin_[r + 1] - row_begin_[r];
+    return {H_.middleRows(row_begin_[r], num_rows),
+            h_.segment(row_begin_[r], num_rows),
+            K_.middleRows(static_cast<Eigen::Index>(r) * num_vars_, num_vars_),
+            k_.segment(static_cast<Eigen::Index>(r) * num_vars_, num_vars_),
+            region_lower_.col(r),
+            region_upper_.col(r)};
+  }
+
+  // Returns the region that contains `parameters`, or -1 if they are outside the box or in no
+  // region (the QP is infeasible there, or the enumeration missed the region).
+  int Locate(const Eigen::Ref<const Eigen::VectorXd>& parameters) const {
+    if (nodes_.empty() || (parameters.array() < lower_.array()).any() ||
+        (parameters.array() > upper_.array()).any()) {
+      return -1;
+    }
+    // The tree is balanced, so its depth stays far below the stack size.
+    std::array<int, 64> stack;
+    int size = 0;
+    stack[size++] = 0;
+    while (size > 0) {
+      const int index = stack[--size];
+      const Node& node = nodes_[index];
+      if ((parameters.array() < node_lower_.col(index).array() - kTolerance).any() ||
+          (parameters.array() > node_upper_.col(index).array() + kTolerance).any()) {
+        continue;
+      }
+      if (node.left < 0) {
+        for (int i = node.begin; i < node.end; ++i) {
+          if (Contains(order_[i], parameters)) {
+            return order_[i];
+          }
+        }
+        continue;
+      }
+      stack[size++] = node.left;
+      stack[size++] = node.right;
+    }
+    return -1;
+  }
+
+  // The optimal solution in region `r`.
+  Eigen::VectorXd Solution(int r, const Eigen::Ref<const Eigen::VectorXd>& parameters) const {
+    return K_.middleRows(static_cast<Eigen::Index>(r) * num_vars_, num_vars_) * parameters +
+           k_.segment(static_cast<Eigen::Index>(r) * num_vars_, num_vars_);
+  }
+
+  // The optimal solution at `parameters`, or nullopt if Locate() finds no region.
+  std::optional<Eigen::VectorXd> Evaluate(
+      const Eigen::Ref<const Eigen::VectorXd>& parameters) const {
+    const int r = Locate(parameters);
+    if (r < 0) {
+      return std::nullopt;
+    }
+    return Solution(r, parameters);
+  }
+
+ private:
+  // Slack allowed in the half-space tests, so that points on a shared facet find a region.
+  static constexpr double kTolerance = 1e-9;
+  static constexpr int kLeafSize = 4;
+
+  // The bounding box of node i is column i of node_lower_ and node_upper_.
+  struct Node {
+    // Children, or -1 for a leaf holding order_[begin, end).
+    int left{-1};
+    int right{-1};
+    int begin{0};
+    int end{0};
+  };
+
+  bool Contains(int r, const Eigen::Ref<const Eigen::VectorXd>& parameters) const {
+    for (int i = row_begin_[r]; i < row_begin_[r + 1]; ++i) {
+      if (H_.row(i).dot(parameters) > h_(i) + kTolerance) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Builds the subtree over order_[begin, end) by splitting at the median box center along the
+  // axis in which the centers spread most, and returns its index.
+  int Build(int begin, int end, std::vector<Eigen::VectorXd>* node_lower,
+            std::vector<Eigen::VectorXd>* node_upper) {
+    const int index = nodes_.size();
+    nodes_.emplace_back();
+    Eigen::VectorXd lower = region_lower_.col(order_[begin]);
+    Eigen::VectorXd upper = region_upper_.col(order_[begin]);
+    Eigen::VectorXd center_min = lower + upper;
+    Eigen::VectorXd center_max = center_min;
+    for (int i = begin + 1; i < end; ++i) {
+      lower = lower.cwiseMin(region_lower_.col(order_[i]));
+      upper = upper.cwiseMax(region_upper_.col(order_[i]));
+      const Eigen::VectorXd center = region_lower_.col(order_[i]) + region_upper_.col(order_[i]);
+      center_min = center_min.cwiseMin(center);
+      center_max = center_max.cwiseMax(center);
+    }
+    node_lower->push_back(lower);
+    node_upper->push_back(upper);
+    nodes_[index].begin = begin;
+    nodes_[index].end = end;
+    if (end - begin <= kLeafSize) {
+      return index;
+    }
+    int axis = 0;
+    (center_max - center_min).maxCoeff(&axis);
+    const int middle = begin + (end - begin) / 2;
+    std::nth_element(order_.begin() + begin, order_.begin() + middle, order_.begin() + end,
+                     [this, axis](int a, int b) {
+                       return region_lower_(axis, a) + region_upper_(axis, a) <
+                              region_lower_(axis, b) + region_upper_(axis, b);
+                     });
+    const int left = Build(begin, middle, node_lower, node_upper);
+    const int right = Build(middle, end, node_lower, node_upper);
+    nodes_[index].left = left;
+    nodes_[index].right = right;
+    return index;
+  }
+
+  Eigen::VectorXd lower_;
+  Eigen::VectorXd upper_;
+  int num_vars_;
+  bool complete_;
+  // Region r owns rows [row_begin_[r], row_begin_[r + 1]) of H_ and h_, and rows
+  // [r * num_vars_, (r + 1) * num_vars_) of K_ and k_.
+  std::vector<int> row_begin_;
+  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> H_;
+  Eigen::VectorXd h_;
+  Eigen::MatrixXd K_;
+  Eigen::VectorXd k_;
+  Eigen::MatrixXd region_lower_;
+  Eigen::MatrixXd region_upper_;
+  std::vector<Node> nodes_;
+  Eigen::MatrixXd node_lower_;
+  Eigen::MatrixXd node_upper_;
+  std::vector<int> order_;
+};
+
+struct ExplicitQpOptions {
+  // How far beyond a facet the neighbouring region is looked for, relative to the diagonal of
+  // the parameter box.
+  double step{1e-6};
+  // Points drawn uniformly from the box, besides its center, from which the enumeration starts.
+  // They find the regions that facet walks do not reach, e.g. in disconnected feasible sets.
+  int num_seeds{100};
+  int max_regions{10000};
+  double tolerance{1e-9};
+};
+
+namespace internal {
+
+// The QP of a family accepted by IsSmallQp() with the right-hand side b + B p.
+struct ParametricQp {
+  SmallQpData data;
+  Eigen::MatrixXd B;
+  Eigen::LLT<Eigen::MatrixXd> llt;
+};
+
+// Extracts b and B by building the QP at p = 0 and at the unit vectors, and checks that the
+// parameters change nothing else.
+inline ParametricQp MakeParametricQp(const ProgramFamily& family, int num_parameters) {
+  auto prog = family.build();
+  family.set_parameters(Eigen::VectorXd::Zero(num_parameters), prog.get());
+  if (!IsSmallQp(*prog)) {
+    throw std::invalid_argument("ComputeExplicitQp: the family is not a QP accepted by "
+                                "IsSmallQp().");
+  }
+  ParametricQp qp{MakeSmallQpData(*prog), Eigen::MatrixXd(0, 0), Eigen::LLT<Eigen::MatrixXd>()};
+  qp.B.resize(qp.data.b.size(), num_parameters);
+  for (int i = 0; i < num_parameters; ++i) {
+    family.set_parameters(Eigen::VectorXd::Unit(num_parameters, i), prog.get());
+    const SmallQpData data = MakeSmallQpData(*prog);
+    if (data.num_equalities != qp.data.num_equalities || data.b.size() != qp.data.b.size() ||
+        data.G != qp.data.G || data.g != qp.data.g || data.normals != qp.data.normals) {
+      throw std::invalid_argument("ComputeExplicitQp: the parameters may only change the "
+                                  "constraint bounds.");
+    }
+    qp.B.col(i) = data.b - qp.data.b;
+  }
+  qp.llt.compute(qp.data.G);
+  if (qp.llt.info() != Eigen::Success) {
+    throw std::invalid_argument("ComputeExplicitQp: the QP is not strictly convex.");
+  }
+  return qp;
+}
+
+/*
+ * Maximizes c'p (plus the radius r of a ball around p, if `ball`) over the rows of H p <= h
+ * marked in `use`, shrunk by r if `ball`, and p >= lower. Row `on_row`, if not -1, holds with
+ * equality instead. Rows of H have unit norm, so r is the radius of the largest ball inside.
+ *
+ * The LP goes to SolveStandardFormLp() with y = p - lower and a slack per inequality.
+ */
+inline std::optional<std::pair<Eigen::VectorXd, double>> MaximizeOverPolytope(
+    const Eigen::MatrixXd& H, const Eigen::VectorXd& h, const std::vector<bool>& use,
+    const Eigen::VectorXd& lower, const Eigen::VectorXd& c, bool ball, int on_row,
+    double tolerance) {
+  const int p = lower.size();
+  std::vector<int> rows;
+  for (int i = 0; i < H.rows(); ++i) {
+    if (use[i] || i == on_row) {
+      rows.push_back(i);
+    }
+  }
+  const int m = rows.size();
+  const int num_slacks = on_row >= 0 ? m - 1 : m;
+  Eigen::MatrixXd A = Eigen::MatrixXd::Zero(m, p + 1 + num_slacks);
+  Eigen::VectorXd b(m);
+  int slack = 0;
+  for (int k = 0; k < m; ++k) {
+    const int i = rows[k];
+    A.row(k).head(p) = H.row(i);
+    b(k) = h(i) - H.row(i).dot(lower);
+    if (i != on_row) {
+      A(k, p) = ball ? 1 : 0;
+      A(k, p + 1 + slack++) = 1;
+    }
+    if (b(k) < 0) {
+      A.row(k) *= -1;
+      b(k) *= -1;
+    }
+  }
+  Eigen::VectorXd cost = Eigen::VectorXd::Zero(A.cols());
+  cost.head(p) = -c;
+  cost(p) = ball ? -1 : 0;
+  const auto y = SolveStandardFormLp(A, b, cost, tolerance);
+  if (!y) {
+    return std::nullopt;
+  }
+  return std::make_pair(Eigen::VectorXd(lower + y->head(p)), (*y)(p));
+}
+
+// A critical region and the centers of its facets that are not on the parameter box.
+struct CriticalRegion {
+  ExplicitQpRegion region;
+  std::vector<std::pair<Eigen::VectorXd, Eigen::VectorXd>> facets;
+};
+
+// The critical region of the active set `active`, or nullopt if it is not full-dimensional or
+// the active constraints are linearly dependent.
+inline std::optional<CriticalRegion> MakeCriticalRegion(const ParametricQp& qp,
+                                                        const std::vector<int>& active,
+                                                        const Eigen::VectorXd& lower,
+                                                        const Eigen::VectorXd& upper,
+                                                        double tolerance) {
+  const SmallQpData& data = qp.data;
+  const int n = data.g.size();
+  const int p = lower.size();
+  const int a = active.size();
+  Eigen::MatrixXd N(n, a);
+  Eigen::VectorXd b(a);
+  Eigen::MatrixXd B(a, p);
+  for (int i = 0; i < a; ++i) {
+    N.col(i) = data.normals.col(active[i]);
+    b(i) = data.b(active[i]);
+    B.row(i) = qp.B.row(active[i]);
+  }
+  // From G x + g = N u and N'x = b + B p: u = M^-1 (b + B p + N'G^-1 g) with M = N'G^-1 N, and
+  // x = G^-1 (N u - g).
+  const Eigen::VectorXd Ginv_g = qp.llt.solve(data.g);
+  const Eigen::MatrixXd Ginv_N = qp.llt.solve(N);
+  const Eigen::FullPivLU<Eigen::MatrixXd> M(N.transpose() * Ginv_N);
+  if (a > 0 && M.rank() < a) {
+    return std::nullopt;
+  }
+  const Eigen::MatrixXd U = a > 0 ? M.solve(B) : Eigen::MatrixXd(0, p);
+  const Eigen::VectorXd u0 =
+      a > 0 ? M.solve(b + N.transpose() * Ginv_g) : Eigen::VectorXd(0);
+  CriticalRegion critical;
+  ExplicitQpRegion& region = critical.region;
+  region.K = Ginv_N * U;
+  region.k = Ginv_N * u0 - Ginv_g;
+
+  // Inactive inequalities stay satisfied, multipliers of active inequalities stay nonnegative,
+  // and the parameters stay in the box (the last 2p rows).
+  std::vector<bool> is_active(data.b.size(), false);
+  for (int i : active) {
+    is_active[i] = true;
+  }
+  std::vector<Eigen::RowVectorXd> rows;
+  std::vector<double> bounds;
+  for (int i = data.num_equalities; i < data.b.size(); ++i) {
+    if (!is_active[i]) {
+      rows.push_back(qp.B.row(i) - data.normals.col(i).transpose() * region.K);
+      bounds.push_back(data.normals.col(i).dot(region.k) - data.b(i));
+    }
+  }
+  for (int i = 0; i < a; ++i) {
+    if (active[i] >= data.num_equalities) {
+      rows.push_back(-U.row(i));
+      bounds.push_back(u0(i));
+    }
+  }
+  const int num_box_rows = 2 * p;
+  for (int i = 0; i < p; ++i) {
+    rows.push_back(Eigen::RowVectorXd::Unit(p, i));
+    bounds.push_back(upper(i));
+    rows.push_back(-Eigen::RowVectorXd::Unit(p, i));
+    bounds.push_back(-lower(i));
+  }
+  const int num_rows = rows.size();
+  Eigen::MatrixXd H(num_rows, p);
+  Eigen::VectorXd h(num_rows);
+  std::vector<bool> use(num_rows, true);
+  for (int i = 0; i < num_rows; ++i) {
+    const double norm = rows[i].norm();
+    if (norm <= tolerance) {
+      // 0 <= h: no restriction, or none of the parameters satisfies it.
+      if (bounds[i] < -tolerance) {
+        return std::nullopt;
+      }
+      H.row(i).setZero();
+      h(i) = 0;
+      use[i] = false;
+      continue;
+    }
+    H.row(i) = rows[i] / norm;
+    h(i) = bounds[i] / norm;
+  }
+
+  const Eigen::VectorXd zero = Eigen::VectorXd::Zero(p);
+  const auto center = MaximizeOverPolytope(H, h, use, lower, zero, true, -1, tolerance);
+  if (!center || center->second <= tolerance) {
+    return std::nullopt;
+  }
+  // Drops the rows that are not facets, one at a time against the rows kept so far: a facet has
+  // a ball of positive radius inside it.
+  for (int i = 0; i < num_rows; ++i) {
+    if (!use[i]) {
+      continue;
+    }
+    use[i] = false;
+    const auto facet = MaximizeOverPolytope(H, h, use, lower, zero, true, i, tolerance);
+    if (!facet || facet->second <= tolerance) {
+      continue;
+    }
+    use[i] = true;
+    if (i < num_rows - num_box_rows) {
+      critical.facets.emplace_back(facet->first, H.row(i).transpose());
+    }
+  }
+  const int num_facets = std::count(use.begin(), use.end(), true);
+  region.H.resize(num_facets, p);
+  region.h.resize(num_facets);
+  for (int i = 0, j = 0; i < num_rows; ++i) {
+    if (use[i]) {
+      region.H.row(j) = H.row(i);
+      region.h(j++) = h(i);
+    }
+  }
+  region.lower.resize(p);
+  region.upper.resize(p);
+  for (int i = 0; i < p; ++i) {
+    const Eigen::VectorXd e = Eigen::VectorXd::Unit(p, i);
+    const auto highest = MaximizeOverPolytope(H, h, use, lower, e, false, -1, tolerance);
+    const auto lowest = MaximizeOverPolytope(H, h, use, lower, -e, false, -1, tolerance);
+    region.upper(i) = highest ? highest->first(i) : upper(i);
+    region.lower(i) = lowest ? lowest->first(i) : lower(i);
+  }
+  return critical;
+}
+
+// Enumerates the critical regions of `qp` over [lower, upper]; see ComputeExplicitQp().
+inline ExplicitQp ExploreCriticalRegions(const ParametricQp& qp, const Eigen::VectorXd& lower,
+                                         const Eigen::VectorXd& upper,
+                                         const ExplicitQpOptions& options) {
+  const int p = lower.size();
+  const SmallQpData& data = qp.data;
+  const double step = options.step * (upper - lower).norm();
+
+  std::deque<Eigen::VectorXd> candidates;
+  candidates.push_back(0.5 * (lower + upper));
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> distribution(0, 1);
+  for (int i = 0; i < options.num_seeds; ++i) {
+    candidates.push_back(lower + (upper - lower).cwiseProduct(Eigen::VectorXd::NullaryExpr(
+                                     p, [&] { return distribution(generator); })));
+  }
+
+  std::vector<ExplicitQpRegion> regions;
+  std::set<std::vector<int>> active_sets;
+  const auto covered = [&regions, &options](const Eigen::VectorXd& parameters) {
+    for (const ExplicitQpRegion& region : regions) {
+      if ((region.H * parameters - region.h).maxCoeff() <= options.tolerance) {
+        return true;
+      }
+    }
+    return false;
+  };
+  while (!candidates.empty() && static_cast<int>(regions.size()) < options.max_regions) {
+    const Eigen::VectorXd parameters = std::move(candidates.front());
+    candidates.pop_front();
+    if ((parameters.array() < lower.array()).any() || (parameters.array() > upper.array()).any() ||
+        covered(parameters)) {
+      continue;
+    }
+    Eigen::VectorXd x, multipliers;
+    const SmallQpStatus status =
+        SolveSmallQpData(data, data.b + qp.B * parameters, &x, &multipliers);
+    if (status != SmallQpStatus::kSolved) {
+      continue;
+    }
+    std::vector<int> active(data.num_equalities);
+    std::iota(active.begin(), active.end(), 0);
+    for (int i = data.num_equalities; i < multipliers.size(); ++i) {
+      if (multipliers(i) > options.tolerance) {
+        active.push_back(i);
+      }
+    }
+    if (!active_sets.insert(active).second) {
+      continue;
+    }
+    auto critical = MakeCriticalRegion(qp, active, lower, upper, options.tolerance);
+    if (!critical) {
+      continue;
+    }
+    for (const auto& [center, normal] : critical->facets) {
+      candidates.push_back(center + step * normal);
+    }
+    regions.push_back(std::move(critical->region));
+  }
+  return ExplicitQp(lower, upper, data.g.size(), regions, candidates.empty());
+}
+
+}  // namespace internal
+
+/*
+ * Computes the explicit solution of the parametric QP `family` (see IsSmallQp()) over the box
+ * [lower, upper] of parameters, offline.
+ *
+ * The parameters must enter the program affinely and only through the constraint bounds, as in
+ * x(0) + x(1) == b or an MPC problem whose initial state is the parameter; the Hessian has to be
+ * positive definite. The critical regions are enumerated by exploration: the QP is solved with
+ * SolveSmallQp()'s active-set method at the box center, its optimal active set defines a region
+ * and the affine solution in it, and the QP is solved again just beyond every facet of the
+ * region that is not on the box, until no facet leads to a new region. Points where the QP is
+ * infeasible end the walk there. Degenerate (lower-dimensional) regions are skipped, so the map
+ * may miss a sliver of the box; ExplicitQpEvaluator falls back to a solve there.
+ */
+inline ExplicitQp ComputeExplicitQp(const ProgramFamily& family, const Eigen::VectorXd& lower,
+                                    const Eigen::VectorXd& upper,
+                                    const ExplicitQpOptions& options = {}) {
+  const int p = lower.size();
+  if (upper.size() != p || p == 0 || (upper.array() <= lower.array()).any()) {
+    throw std::invalid_argument("ComputeExplicitQp: need lower < upper.");
+  }
+  return internal::ExploreCriticalRegions(internal::MakeParametricQp(family, p), lower, upper,
+                                          options);
+}
+
+/*
+ * Writes `map` as a binary file: the magic "EXPLICQP", then the ByteWriter encoding of the
+ * parameter box, the number of variables, the completeness flag and one (H, h, K, k, lower,
+ * upper) record per region, matrices column-major.
+ */
+inline void WriteExplicitQp(const ExplicitQp& map, const std::string& path) {
+  ByteWriter writer;
+  writer.Put(std::array<char, 8>{'E', 'X', 'P', 'L', 'I', 'C', 'Q', 'P'});
+  writer.PutVector(map.lower());
+  writer.PutVector(map.upper());
+  writer.Put<std::uint32_t>(map.num_vars());
+  writer.Put<std::uint8_t>(map.complete());
+  writer.Put<std::uint32_t>(map.num_regions());
+  for (int r = 0; r < map.num_regions(); ++r) {
+    const ExplicitQpRegion region = map.region(r);
+    writer.Put<std::uint32_t>(region.H.rows());
+    writer.PutArray(region.H.data(), region.H.size());
+    writer.PutVector(region.h);
+    writer.PutArray(region.K.data(), region.K.size());
+    writer.PutVector(region.k);
+    writer.PutVector(region.lower);
+    writer.PutVector(region.upper);
+  }
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(writer.bytes().data(), writer.bytes().size());
+  if (!out) {
+    throw std::runtime_error("WriteExplicitQp: failed to write " + path);
+  }
+}
+
+inline ExplicitQp ReadExplicitQp(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  std::stringstream contents;
+  contents << in.rdbuf();
+  const std::string bytes = contents.str();
+  ByteReader reader(bytes);
+  if (reader.Get<std::array<char, 8>>() !=
+      std::array<char, 8>{'E', 'X', 'P', 'L', 'I', 'C', 'Q', 'P'}) {
+    throw std::runtime_error(path + " is not an explicit QP.");
+  }
+  const Eigen::VectorXd lower = reader.GetVector();
+  const Eigen::VectorXd upper = reader.GetVector();
+  const int p = lower.size();
+  const int num_vars = reader.Get<std::uint32_t>();
+  const bool complete = reader.Get<std::uint8_t>() != 0;
+  std::vector<ExplicitQpRegion> regions(reader.Get<std::uint32_t>());
+  for (ExplicitQpRegion& region : regions) {
+    const int num_rows = reader.Get<std::uint32_t>();
+    const auto H = reader.GetArray<double>();
+    region.h = reader.GetVector();
+    const auto K = reader.GetArray<double>();
+    region.k = reader.GetVector();
+    region.lower = reader.GetVector();
+    region.upper = reader.GetVector();
+    if (H.size() != static_cast<std::size_t>(num_rows) * p || region.h.size() != num_rows ||
+        K.size() != static_cast<std::size_t>(num_vars) * p || region.k.size() != num_vars ||
+        region.lower.size() != p || region.upper.size() != p) {
+      throw std::runtime_error(path + " is not a consistent explicit QP.");
+    }
+    region.H = Eigen::Map<const Eigen::MatrixXd>(H.data(), num_rows, p);
+    region.K = Eigen::Map<const Eigen::MatrixXd>(K.data(), num_vars, p);
+  }
+  if (upper.size() != p) {
+    throw std::runtime_error(path + " is not a consistent explicit QP.");
+  }
+  return ExplicitQp(lower, upper, num_vars, regions, complete);
+}
+
+struct ExplicitQpSolution {
+  Eigen::VectorXd x;
+  bool success{false};
+  // Region the solution was read from, or -1 if the program was solved.
+  int region{-1};
+};
+
+/*
+ * Online evaluation of a family with a precomputed ExplicitQp: inside the map the solution is
+ * read from the region that contains the parameters, anywhere else the family's program is
+ * solved with SolveWithSmallQpFastPath(). Not thread-safe; it owns one program instance.
+ */
+class ExplicitQpEvaluator {
+ public:
+  ExplicitQpEvaluator(std::shared_ptr<const ExplicitQp> map, const ProgramFamily& family)
+      : map_(std::move(map)), family_(family), prog_(family.build()) {}
+
+  ExplicitQpSolution Solve(const Eigen::VectorXd& parameters) {
+    ExplicitQpSolution solution;
+    solution.region = map_->Locate(parameters);
+    if (solution.region >= 0) {
+      solution.x = map_->Solution(solution.region, parameters);
+      solution.success = true;
+      return solution;
+    }
+    family_.set_parameters(parameters, prog_.get());
+    const auto result = SolveWithSmallQpFastPath(*prog_);
+    solution.x = result.get_x_val();
+    solution.success = result.is_success();
+    return solution;
+  }
+
+ private:
+  std::shared_ptr<const ExplicitQp> map_;
+  ProgramFamily family_;
+  std::unique_ptr<drake::solvers::MathematicalProgram> prog_;
+};
+
+}  // namespace drake_tutorials
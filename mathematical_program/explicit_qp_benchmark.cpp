@@ -0,0 +1,157 @@
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/solve.h>
+
+#include <gflags/gflags.h>
+
+#include "benchmark_statistics.h"
+#include "explicit_qp.h"
+#include "tutorial_programs.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+DEFINE_int32(horizon, 5, "Number of steps of the MPC problem.");
+DEFINE_int32(queries, 20000, "Number of parameter vectors looked up per measurement.");
+DEFINE_string(path, "/tmp/explicit_qp_benchmark.bin", "Where the solution map is written.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+constexpr double kTimeStep = 0.1;
+
+// MPC of a double integrator (position, velocity) with the initial state as the parameter:
+// inputs |u| <= 1, velocities |v| <= 1.5, and a quadratic cost on inputs and states. The
+// parameter only enters the right-hand side of the first dynamics constraint.
+drake_tutorials::ProgramFamily MakeMpcFamily(int horizon) {
+  drake_tutorials::ProgramFamily family;
+  family.build = [horizon] {
+    const double dt = kTimeStep;
+    auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+    const auto u = prog->NewContinuousVariables(horizon, "u");
+    const auto x = prog->NewContinuousVariables(2, horizon, "x");
+    // x_1 = A x_0 + B u_0, with A x_0 as the bounds; set_parameters() fills them in.
+    prog->AddLinearEqualityConstraint(x(0, 0) - dt * dt / 2 * u(0) == 0);
+    prog->AddLinearEqualityConstraint(x(1, 0) - dt * u(0) == 0);
+    for (int k = 1; k < horizon; ++k) {
+      const auto position = x(0, k - 1) + dt * x(1, k - 1) + dt * dt / 2 * u(k);
+      prog->AddLinearEqualityConstraint(x(0, k) - position == 0);
+      prog->AddLinearEqualityConstraint(x(1, k) - x(1, k - 1) - dt * u(k) == 0);
+    }
+    prog->AddBoundingBoxConstraint(-1, 1, u);
+    prog->AddBoundingBoxConstraint(-1.5, 1.5, x.row(1).transpose());
+    drake::symbolic::Expression cost;
+    for (int k = 0; k < horizon; ++k) {
+      cost += 0.1 * u(k) * u(k) + x(0, k) * x(0, k) + x(1, k) * x(1, k);
+    }
+    prog->AddQuadraticCost(cost);
+    return prog;
+  };
+  family.set_parameters = [](const Eigen::VectorXd& p, drake::solvers::MathematicalProgram* prog) {
+    const auto& equalities = prog->linear_equality_constraints();
+    auto& position = *equalities[0].evaluator();
+    auto& velocity = *equalities[1].evaluator();
+    position.UpdateCoefficients(position.GetDenseA(), drake::Vector1d(p(0) + kTimeStep * p(1)));
+    velocity.UpdateCoefficients(velocity.GetDenseA(), drake::Vector1d(p(1)));
+  };
+  return family;
+}
+
+// Builds the map of `family` over [lower, upper], checks it against SolveSmallQp() and Solve()
+// at random parameters, and reports lookup and solve latencies. Returns false on a wrong
+// solution.
+bool Run(const std::string& name, const drake_tutorials::ProgramFamily& family,
+         const Eigen::VectorXd& lower, const Eigen::VectorXd& upper) {
+  auto start = std::chrono::steady_clock::now();
+  const auto map = std::make_shared<const drake_tutorials::ExplicitQp>(
+      drake_tutorials::ComputeExplicitQp(family, lower, upper));
+  const std::chrono::duration<double> build_time = std::chrono::steady_clock::now() - start;
+  drake_tutorials::WriteExplicitQp(*map, FLAGS_path);
+  const drake_tutorials::ExplicitQp loaded = drake_tutorials::ReadExplicitQp(FLAGS_path);
+  print(name, ": ", map->num_regions(), " regions", map->complete() ? "" : " (incomplete)",
+        " over ", map->num_parameters(), " parameters, built in ", build_time.count(), " s");
+
+  // Parameters from a box twice as wide as the map's in every direction, so that many of them
+  // need the fallback solve.
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> distribution(-0.5, 1.5);
+  auto prog = family.build();
+  drake_tutorials::ExplicitQpEvaluator evaluator(map, family);
+  std::vector<double> lookup_latencies, fallback_latencies, small_qp_latencies, solve_latencies;
+  double error = 0;
+  int num_wrong = 0;
+  for (int i = 0; i < FLAGS_queries; ++i) {
+    const Eigen::VectorXd p =
+        lower + (upper - lower).cwiseProduct(Eigen::VectorXd::NullaryExpr(
+                    lower.size(), [&] { return distribution(generator); }));
+    start = std::chrono::steady_clock::now();
+    const drake_tutorials::ExplicitQpSolution solution = evaluator.Solve(p);
+    const std::chrono::duration<double, std::micro> latency =
+        std::chrono::steady_clock::now() - start;
+    (solution.region >= 0 ? lookup_latencies : fallback_latencies).push_back(latency.count());
+    num_wrong += loaded.Locate(p) != solution.region;
+
+    family.set_parameters(p, prog.get());
+    drake::solvers::MathematicalProgramResult result;
+    start = std::chrono::steady_clock::now();
+    const auto status = drake_tutorials::SolveSmallQp(*prog, &result);
+    small_qp_latencies.push_back(
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+            .count());
+    if (i % 10 == 0) {
+      start = std::chrono::steady_clock::now();
+      drake::solvers::Solve(*prog);
+      solve_latencies.push_back(
+          std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+              .count());
+    }
+    if (status != drake_tutorials::SmallQpStatus::kSolved) {
+      num_wrong += solution.region >= 0 || solution.success;
+      continue;
+    }
+    error = std::max(error, (solution.x - result.get_x_val()).cwiseAbs().maxCoeff());
+  }
+  num_wrong += !(error <= 1e-6);
+  const auto report = [](const std::string& what, const std::vector<double>& latencies) {
+    if (latencies.empty()) {
+      return;
+    }
+    print("  ", what, ": ", latencies.size(), " queries, median ",
+          drake_tutorials::Percentile(latencies, 0.5), " us, p99 ",
+          drake_tutorials::Percentile(latencies, 0.99), " us");
+  };
+  report("lookup in the map", lookup_latencies);
+  report("fallback solve outside the map", fallback_latencies);
+  report("SolveSmallQp()", small_qp_latencies);
+  report("Solve()", solve_latencies);
+  print("  largest difference to SolveSmallQp() ", error, ", wrong answers ", num_wrong);
+  return num_wrong == 0;
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  bool ok = true;
+
+  // simple_optimization_problem_feasible.cpp with b in x(0) + x(1) == b as the parameter.
+  drake_tutorials::ProgramFamily feasible;
+  feasible.build = [] { return drake_tutorials::MakeFeasibleProgram(0); };
+  feasible.set_parameters = [](const Eigen::VectorXd& p,
+                               drake::solvers::MathematicalProgram* prog) {
+    prog->linear_equality_constraints().front().evaluator()->UpdateCoefficients(
+        Eigen::RowVector2d(1, 1), p);
+  };
+  ok &= Run("simple_optimization_problem_feasible", feasible, drake::Vector1d(-10),
+            drake::Vector1d(10));
+
+  ok &= Run("double integrator MPC", MakeMpcFamily(FLAGS_horizon), Eigen::Vector2d(-5, -2),
+            Eigen::Vector2d(5, 2));
+  std::filesystem::remove(FLAGS_path);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+#include <drake/solvers/mathematical_program.h>
+
+#include <gflags/gflags.h>
+
+#include "iis_finder.h"
+#include "thread_pool.h"
+#include "tutorial_programs.h"
+
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+
+DEFINE_int32(num_vars, 50, "Number of variables of the generated LP.");
+DEFINE_int32(num_constraints, 1000, "Number of random constraints of the generated LP.");
+DEFINE_int32(chain, 6, "Length of the conflicting chain planted in the generated LP.");
+DEFINE_int32(num_threads, 1,
+             "Number of worker threads; 0 means one per hardware thread. See "
+             "solver_concurrency.h for when Ipopt solves run in parallel.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+/*
+ * Random constraints a'x <= b that all hold at a point z, plus the chain
+ *    x(0) >= 1, x(i) - x(i - 1) >= 1 for 0 < i < chain, x(chain - 1) <= chain - 1,
+ * whose last link z violates. Every constraint is its own binding.
+ */
+std::unique_ptr<drake::solvers::MathematicalProgram> MakePlantedConflict() {
+  std::mt19937 generator(0);
+  std::normal_distribution<double> normal(0, 1);
+  std::uniform_real_distribution<double> margin(0.1, 1);
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  const auto x = prog->NewContinuousVariables(FLAGS_num_vars, "x");
+  Eigen::VectorXd z =
+      Eigen::VectorXd::NullaryExpr(FLAGS_num_vars, [&] { return normal(generator); });
+  for (int i = 0; i < FLAGS_chain; ++i) {
+    z(i) = i + 1;
+  }
+  for (int k = 0; k < FLAGS_num_constraints; ++k) {
+    const Eigen::RowVectorXd a =
+        Eigen::RowVectorXd::NullaryExpr(FLAGS_num_vars, [&] { return normal(generator); });
+    prog->AddLinearConstraint(a, -std::numeric_limits<double>::infinity(),
+                              a.dot(z) + margin(generator), x);
+  }
+  prog->AddLinearConstraint(x(0) >= 1);
+  for (int i = 1; i < FLAGS_chain; ++i) {
+    prog->AddLinearConstraint(x(i) - x(i - 1) >= 1);
+  }
+  prog->AddLinearConstraint(x(FLAGS_chain - 1) <= FLAGS_chain - 1);
+  return prog;
+}
+
+void Report(const std::string& name, const drake_tutorials::IisReport& report) {
+  print("  ", name, ": ", report.constraints.size(), " constraints in the IIS, ",
+        report.num_solves, " feasibility solves + ", report.num_elastic_solves,
+        " elastic solves, ", report.wall_time, " s");
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  const int num_threads = FLAGS_num_threads > 0 ? FLAGS_num_threads
+                                                : drake_tutorials::ThreadPool::DefaultNumThreads();
+  drake_tutorials::ThreadPool pool(num_threads);
+
+  // simple_optimization_problem_infeasible.cpp: both constraints conflict.
+  const auto tutorial = drake_tutorials::MakeInfeasibleProgram();
+  const auto tutorial_iis = drake_tutorials::FindIis(*tutorial, {}, &pool);
+  print("simple_optimization_problem_infeasible:");
+  for (const auto& binding : tutorial_iis.constraints) {
+    print("  conflicting: ", binding);
+  }
+
+  const auto prog = MakePlantedConflict();
+  print("generated LP with ", prog->GetAllConstraints().size(), " constraints on ",
+        FLAGS_num_vars, " variables, ", num_threads, " thread(s):");
+  const auto sequential = drake_tutorials::FindIisSequential(*prog);
+  Report("sequential deletion filter", sequential);
+  drake_tutorials::IisOptions options;
+  options.elastic_filter = false;
+  const auto grouped = drake_tutorials::FindIis(*prog, options, &pool);
+  Report("parallel grouped deletion filter", grouped);
+  options.filter = drake_tutorials::IisFilter::kAddition;
+  const auto addition = drake_tutorials::FindIis(*prog, options, &pool);
+  Report("parallel grouped addition filter", addition);
+  options.elastic_filter = true;
+  options.filter = drake_tutorials::IisFilter::kDeletion;
+  const auto elastic = drake_tutorials::FindIis(*prog, options, &pool);
+  Report("elastic filter + parallel grouped deletion filter", elastic);
+  print("  speedup over the sequential filter: ", sequential.wall_time / grouped.wall_time,
+        "x with deletion, ", sequential.wall_time / addition.wall_time, "x with addition and ",
+        sequential.wall_time / elastic.wall_time, "x with the elastic filter");
+  const bool ok =
+      sequential.infeasible && grouped.infeasible && addition.infeasible && elastic.infeasible;
+  return ok ? 0 : 1;
+}
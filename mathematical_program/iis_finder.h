@@ -0,0 +1,417 @@
+#pragma once
+
+#include <drake/solvers/choose_best_solver.h>
+#include <drake/solvers/constraint.h>
+#include <drake/solvers/mathematical_program.h>
+
+#include "batch_solve.h"
+#include "infeasibility_precheck.h"
+#include "solver_concurrency.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace drake_tutorials {
+
+enum class IisFilter {
+  // Drops blocks of candidates whose removal keeps the set infeasible; suits IISs that make up a
+  // large part of the candidates.
+  kDeletion,
+  // Grows the IIS one member at a time from the smallest infeasible prefix of the candidates;
+  // suits small IISs among many candidates.
+  kAddition,
+};
+
+struct IisOptions {
+  // Shrink the candidate set with the elastic filter before the deletion or addition filter.
+  bool elastic_filter{true};
+  IisFilter filter{IisFilter::kDeletion};
+  // Elastic variables above this count as a violated constraint.
+  double tolerance{1e-6};
+  std::optional<drake::solvers::SolverOptions> solver_options;
+};
+
+struct IisReport {
+  // False if the program turned out to be feasible; `constraints` is empty then.
+  bool infeasible{false};
+  // An irreducible infeasible subset: infeasible together, feasible without any one of them.
+  std::vector<drake::solvers::Binding<drake::solvers::Constraint>> constraints;
+  // Feasibility solves of the deletion or addition filter, and solves of the elastic filter.
+  int num_solves{0};
+  int num_elastic_solves{0};
+  // Wall-clock time in seconds.
+  double wall_time{0};
+};
+
+namespace internal {
+
+// lb <= g(x) + s_lower - s_upper <= ub for a constraint lb <= g(x) <= ub, over [x; s_lower;
+// s_upper]. With s >= 0 it can always be satisfied, and the slacks measure the violation.
+class ElasticConstraint : public drake::solvers::Constraint {
+ public:
+  explicit ElasticConstraint(std::shared_ptr<drake::solvers::Constraint> constraint)
+      : Constraint(constraint->num_constraints(),
+                   constraint->num_vars() + 2 * constraint->num_constraints(),
+                   constraint->lower_bound(), constraint->upper_bound(),
+                   constraint->get_description()),
+        constraint_(std::move(constraint)) {}
+
+ private:
+  template <typename X, typename Y>
+  void Elastic(const X& x, Y* y) const {
+    const int n = constraint_->num_vars();
+    const int m = constraint_->num_constraints();
+    constraint_->Eval(x.head(n), y);
+    for (int i = 0; i < m; ++i) {
+      (*y)(i) += x(n + i) - x(n + m + i);
+    }
+  }
+
+  void DoEval(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::VectorXd* y) const override {
+    Elastic(x, y);
+  }
+  void DoEval(const Eigen::Ref<const drake::AutoDiffVecXd>& x,
+              drake::AutoDiffVecXd* y) const override {
+    Elastic(x, y);
+  }
+  void DoEval(const Eigen::Ref<const drake::VectorX<drake::symbolic::Variable>>& x,
+              drake::VectorX<drake::symbolic::Expression>* y) const override {
+    Elastic(x, y);
+  }
+
+  std::shared_ptr<drake::solvers::Constraint> constraint_;
+};
+
+// Feasibility tests of subsets of the constraints of one program. Each test builds a program with
+// the same decision variables, no costs and only the chosen constraints, and solves it with the
+// solver ChooseBestSolver() picks for it.
+class SubsetFeasibility {
+ public:
+  SubsetFeasibility(const drake::solvers::MathematicalProgram& prog, const IisOptions& options)
+      : prog_(prog), bindings_(prog.GetAllConstraints()), options_(options) {}
+
+  int num_constraints() const { return bindings_.size(); }
+  const drake::solvers::Binding<drake::solvers::Constraint>& binding(int k) const {
+    return bindings_[k];
+  }
+  int num_solves() const { return num_solves_; }
+
+  // Local solvers may report a feasible subset as infeasible; the IIS is only as reliable as the
+  // solver's verdict.
+  bool IsFeasible(const std::vector<int>& subset, WorkerSolvers* solvers) {
+    if (subset.empty()) {
+      return true;
+    }
+    drake::solvers::MathematicalProgram sub;
+    sub.AddDecisionVariables(prog_.decision_variables());
+    for (int k : subset) {
+      sub.AddConstraint(bindings_[k]);
+    }
+    ++num_solves_;
+    drake::solvers::MathematicalProgramResult result;
+    SolveConcurrently(solvers->Get(drake::solvers::ChooseBestSolver(sub)), sub, std::nullopt,
+                      options_.solver_options, &result);
+    return result.is_success();
+  }
+
+  /*
+   * Chinneck's elastic filter: every constraint not yet in the hard set gets elastic variables,
+   * whose sum is minimized, and the constraints with nonzero elastic variables join the hard set,
+   * until the elastic program is infeasible. Its hard constraints then contain an IIS, usually
+   * with far fewer constraints than the program.
+   *
+   * Returns nullopt if the elastic program meets every constraint, i.e. the program is feasible.
+   */
+  std::optional<std::vector<int>> ElasticFilter(WorkerSolvers* solvers, int* num_elastic_solves) {
+    const double kInf = std::numeric_limits<double>::infinity();
+    const int num_constraints = bindings_.size();
+    std::vector<bool> hard(num_constraints, false);
+    std::vector<int> hard_set;
+    while (true) {
+      drake::solvers::MathematicalProgram elastic;
+      elastic.AddDecisionVariables(prog_.decision_variables());
+      std::vector<drake::solvers::VectorXDecisionVariable> slacks(num_constraints);
+      for (int k = 0; k < num_constraints; ++k) {
+        const auto& binding = bindings_[k];
+        if (hard[k]) {
+          elastic.AddConstraint(binding);
+          continue;
+        }
+        const int m = binding.evaluator()->num_constraints();
+        const int n = binding.variables().size();
+        slacks[k] = elastic.NewContinuousVariables(2 * m, "elastic");
+        elastic.AddBoundingBoxConstraint(0, kInf, slacks[k]);
+        elastic.AddLinearCost(Eigen::VectorXd::Ones(2 * m), slacks[k]);
+        drake::solvers::VectorXDecisionVariable vars(n + 2 * m);
+        vars << binding.variables(), slacks[k];
+        // Linear constraints (including bounding boxes) stay linear, so an LP stays an LP.
+        if (const auto* linear =
+                dynamic_cast<const drake::solvers::LinearConstraint*>(binding.evaluator().get())) {
+          Eigen::MatrixXd A(m, n + 2 * m);
+          A << linear->GetDenseA(), Eigen::MatrixXd::Identity(m, m),
+              -Eigen::MatrixXd::Identity(m, m);
+          elastic.AddLinearConstraint(A, linear->lower_bound(), linear->upper_bound(), vars);
+        } else {
+          elastic.AddConstraint(std::make_shared<ElasticConstraint>(binding.evaluator()), vars);
+        }
+      }
+      ++*num_elastic_solves;
+      drake::solvers::MathematicalProgramResult result;
+      SolveConcurrently(solvers->Get(drake::solvers::ChooseBestSolver(elastic)), elastic,
+                        std::nullopt, options_.solver_options, &result);
+      if (!result.is_success()) {
+        return hard_set;
+      }
+      bool violated = false;
+      for (int k = 0; k < num_constraints; ++k) {
+        if (!hard[k] && result.GetSolution(slacks[k]).sum() > options_.tolerance) {
+          hard[k] = true;
+          hard_set.push_back(k);
+          violated = true;
+        }
+      }
+      if (!violated) {
+        return std::nullopt;
+      }
+    }
+  }
+
+ private:
+  const drake::solvers::MathematicalProgram& prog_;
+  const std::vector<drake::solvers::Binding<drake::solvers::Constraint>> bindings_;
+  const IisOptions options_;
+  std::atomic<int> num_solves_{0};
+};
+
+// `set` without the members of `removed`; both sorted.
+inline std::vector<int> Difference(const std::vector<int>& set, const std::vector<int>& removed) {
+  std::vector<int> difference;
+  std::set_difference(set.begin(), set.end(), removed.begin(), removed.end(),
+                      std::back_inserter(difference));
+  return difference;
+}
+
+/*
+ * Grouped deletion filter: the infeasible set `current` is split into blocks, and the removal of
+ * every untested block is tested in parallel. A block whose removal keeps the set infeasible is
+ * dropped (all such blocks at once, if that still leaves the set infeasible); a block whose
+ * removal makes it feasible holds an IIS member and stays needed for every smaller infeasible
+ * subset, so it is only split in halves once no block can be dropped. The filter ends when every
+ * block is a single needed constraint.
+ */
+inline std::vector<int> GroupedDeletionFilter(std::vector<int> current,
+                                              SubsetFeasibility* feasibility, ThreadPool* pool) {
+  struct Block {
+    std::vector<int> members;
+    bool needed{false};
+  };
+  std::vector<WorkerSolvers> solvers(pool->num_threads());
+  WorkerSolvers own_solvers;
+  std::vector<Block> blocks;
+  const int num_blocks = std::min<int>(current.size(), std::max(2, pool->num_threads()));
+  for (int b = 0; b < num_blocks; ++b) {
+    Block block;
+    for (size_t i = b * current.size() / num_blocks; i < (b + 1) * current.size() / num_blocks;
+         ++i) {
+      block.members.push_back(current[i]);
+    }
+    blocks.push_back(std::move(block));
+  }
+  while (true) {
+    std::vector<int> untested;
+    for (size_t b = 0; b < blocks.size(); ++b) {
+      if (!blocks[b].needed) {
+        untested.push_back(b);
+      }
+    }
+    if (untested.empty()) {
+      std::vector<Block> split;
+      bool any = false;
+      for (Block& block : blocks) {
+        if (block.members.size() == 1) {
+          split.push_back(std::move(block));
+          continue;
+        }
+        any = true;
+        const auto middle = block.members.begin() + block.members.size() / 2;
+        split.push_back({std::vector<int>(block.members.begin(), middle), false});
+        split.push_back({std::vector<int>(middle, block.members.end()), false});
+      }
+      blocks = std::move(split);
+      if (!any) {
+        return current;
+      }
+      continue;
+    }
+    std::vector<char> feasible(untested.size());
+    pool->ParallelFor(untested.size(), [&](int worker, int i) {
+      feasible[i] = feasibility->IsFeasible(Difference(current, blocks[untested[i]].members),
+                                            &solvers[worker]);
+    });
+    std::vector<int> droppable;
+    for (size_t i = 0; i < untested.size(); ++i) {
+      if (feasible[i]) {
+        blocks[untested[i]].needed = true;
+      } else {
+        droppable.push_back(untested[i]);
+      }
+    }
+    if (droppable.empty()) {
+      continue;
+    }
+    std::vector<int> removed;
+    for (int b : droppable) {
+      MergeInto(&removed, blocks[b].members);
+    }
+    if (droppable.size() > 1 &&
+        feasibility->IsFeasible(Difference(current, removed), &own_solvers)) {
+      droppable.resize(1);
+      removed = blocks[droppable[0]].members;
+    }
+    current = Difference(current, removed);
+    for (auto it = droppable.rbegin(); it != droppable.rend(); ++it) {
+      blocks.erase(blocks.begin() + *it);
+    }
+  }
+}
+
+/*
+ * Grouped addition filter for the infeasible set `candidates` (sorted). The IIS grows one member
+ * at a time: with the members found so far, the prefixes of the remaining candidates turn
+ * infeasible from some length on, and the candidate at that length is a member. The length is
+ * bracketed by testing pool->num_threads() evenly spaced prefixes in parallel per round, and the
+ * candidates after the new member are dropped, since the set stays infeasible without them. The
+ * filter ends when the members alone are infeasible, after about |IIS| * log(candidates) /
+ * log(threads + 1) rounds.
+ */
+inline std::vector<int> GroupedAdditionFilter(std::vector<int> candidates,
+                                              SubsetFeasibility* feasibility, ThreadPool* pool) {
+  std::vector<WorkerSolvers> solvers(pool->num_threads());
+  std::vector<int> iis;
+  const auto with_prefix = [&](int length) {
+    std::vector<int> subset = iis;
+    MergeInto(&subset, std::vector<int>(candidates.begin(), candidates.begin() + length));
+    return subset;
+  };
+  while (!candidates.empty()) {
+    // `iis` plus the first `feasible` candidates is feasible, plus the first `infeasible` is not.
+    int feasible = 0;
+    int infeasible = candidates.size();
+    while (infeasible - feasible > 1) {
+      const int gap = infeasible - feasible;
+      const int num_probes = std::min(gap - 1, pool->num_threads());
+      std::vector<int> lengths(num_probes);
+      for (int i = 0; i < num_probes; ++i) {
+        lengths[i] = feasible + (i + 1) * gap / (num_probes + 1);
+      }
+      std::vector<char> probe_feasible(num_probes);
+      pool->ParallelFor(num_probes, [&](int worker, int i) {
+        probe_feasible[i] = feasibility->IsFeasible(with_prefix(lengths[i]), &solvers[worker]);
+      });
+      for (int i = 0; i < num_probes; ++i) {
+        if (!probe_feasible[i]) {
+          infeasible = lengths[i];
+          break;
+        }
+        feasible = lengths[i];
+      }
+    }
+    MergeInto(&iis, {candidates[infeasible - 1]});
+    candidates.resize(infeasible - 1);
+    if (!feasibility->IsFeasible(iis, &solvers[0])) {
+      break;
+    }
+  }
+  return iis;
+}
+
+// `iis` is nullopt for a feasible program.
+inline IisReport MakeIisReport(const std::optional<std::vector<int>>& iis,
+                               const SubsetFeasibility& feasibility, int num_elastic_solves,
+                               std::chrono::steady_clock::time_point start) {
+  IisReport report;
+  report.infeasible = iis.has_value();
+  for (int k : iis.value_or(std::vector<int>())) {
+    report.constraints.push_back(feasibility.binding(k));
+  }
+  report.num_solves = feasibility.num_solves();
+  report.num_elastic_solves = num_elastic_solves;
+  report.wall_time =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return report;
+}
+
+}  // namespace internal
+
+/*
+ * Finds an irreducible infeasible subset of the constraints of `prog`; costs are ignored.
+ *
+ * The elastic filter (see IisOptions::elastic_filter) first narrows the constraints down to a
+ * hard set that contains an IIS, with one solve per round of newly violated constraints. A grouped
+ * deletion or addition filter (see IisOptions::filter) then tests blocks or prefixes of the
+ * candidates in parallel on `pool`, so a program with thousands of constraints needs on the order
+ * of |IIS| * log(candidates) solves in parallel rounds instead of one solve per constraint. See
+ * solver_concurrency.h for when the solves of a round actually overlap.
+ */
+inline IisReport FindIis(const drake::solvers::MathematicalProgram& prog,
+                         const IisOptions& options, ThreadPool* pool) {
+  const auto start = std::chrono::steady_clock::now();
+  internal::SubsetFeasibility feasibility(prog, options);
+  internal::WorkerSolvers solvers;
+  std::vector<int> all(feasibility.num_constraints());
+  std::iota(all.begin(), all.end(), 0);
+  int num_elastic_solves = 0;
+  std::vector<int> candidates = all;
+  if (options.elastic_filter) {
+    const auto hard = feasibility.ElasticFilter(&solvers, &num_elastic_solves);
+    if (!hard) {
+      return internal::MakeIisReport(std::nullopt, feasibility, num_elastic_solves, start);
+    }
+    std::vector<int> sorted = *hard;
+    std::sort(sorted.begin(), sorted.end());
+    // A solver failure on the elastic program can leave a feasible hard set; start over then.
+    if (!sorted.empty() && !feasibility.IsFeasible(sorted, &solvers)) {
+      candidates = std::move(sorted);
+    } else if (feasibility.IsFeasible(all, &solvers)) {
+      return internal::MakeIisReport(std::nullopt, feasibility, num_elastic_solves, start);
+    }
+  } else if (feasibility.IsFeasible(all, &solvers)) {
+    return internal::MakeIisReport(std::nullopt, feasibility, num_elastic_solves, start);
+  }
+  std::vector<int> iis =
+      options.filter == IisFilter::kAddition
+          ? internal::GroupedAdditionFilter(std::move(candidates), &feasibility, pool)
+          : internal::GroupedDeletionFilter(std::move(candidates), &feasibility, pool);
+  return internal::MakeIisReport(iis, feasibility, num_elastic_solves, start);
+}
+
+// The plain deletion filter for comparison: one feasibility solve per constraint, in order.
+inline IisReport FindIisSequential(const drake::solvers::MathematicalProgram& prog,
+                                   const IisOptions& options = {}) {
+  const auto start = std::chrono::steady_clock::now();
+  internal::SubsetFeasibility feasibility(prog, options);
+  internal::WorkerSolvers solvers;
+  std::vector<int> current(feasibility.num_constraints());
+  std::iota(current.begin(), current.end(), 0);
+  if (feasibility.IsFeasible(current, &solvers)) {
+    return internal::MakeIisReport(std::nullopt, feasibility, 0, start);
+  }
+  for (int k = 0; k < feasibility.num_constraints(); ++k) {
+    const std::vector<int> without = internal::Difference(current, {k});
+    if (!feasibility.IsFeasible(without, &solvers)) {
+      current = without;
+    }
+  }
+  return internal::MakeIisReport(current, feasibility, 0, start);
+}
+
+}  // namespace drake_tutorials
@@ -0,0 +1,454 @@
+#pragma once
+
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/solve.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace drake_tutorials {
+
+struct InfeasibilityPrecheckOptions {
+  // Absolute feasibility tolerance.
+  double tolerance{1e-9};
+  // Number of sweeps of bound propagation over the linear constraints.
+  int max_propagation_passes{10};
+  // The phase-1 LP is skipped if the linear part of the program has more inequalities than this.
+  int max_phase_one_inequalities{500};
+};
+
+// Why a program was found infeasible without running a solver.
+struct InfeasibilityReport {
+  // kInfeasibleConstraints with an infinite cost, under the solver id "InfeasibilityPrecheck".
+  drake::solvers::MathematicalProgramResult result;
+  // Constraints that are infeasible together. Every constraint of the program that is not listed
+  // can be dropped and the rest stays infeasible.
+  std::vector<drake::solvers::Binding<drake::solvers::Constraint>> conflicting_constraints;
+  std::string reason;
+};
+
+namespace internal {
+
+// One row lower <= sum_j coefficient_j * x(variable_j) <= upper of a linear constraint, with
+// variables referred to by their index in the program.
+struct LinearRow {
+  int constraint;
+  std::vector<std::pair<int, double>> terms;
+  double lower;
+  double upper;
+};
+
+// Merges the sorted index sets `b` into `a`.
+inline void MergeInto(std::vector<int>* a, const std::vector<int>& b) {
+  std::vector<int> merged;
+  std::set_union(a->begin(), a->end(), b.begin(), b.end(), std::back_inserter(merged));
+  *a = std::move(merged);
+}
+
+/*
+ * Minimizes c'y subject to A y = b, y >= 0 for b >= 0, with the dense two-phase tableau simplex
+ * method and Bland's rule. Returns nullopt if the LP is infeasible or unbounded. Only meant for the
+ * small LPs of the infeasibility pre-check.
+ */
+inline std::optional<Eigen::VectorXd> SolveStandardFormLp(const Eigen::MatrixXd& A,
+                                                          const Eigen::VectorXd& b,
+                                                          const Eigen::VectorXd& c,
+                                                          double tolerance) {
+  const int p = A.rows();
+  const int q = A.cols();
+  // Columns: q structural variables, p artificial variables, right-hand side. The last row holds
+  // the reduced costs and the negated objective.
+  Eigen::MatrixXd T = Eigen::MatrixXd::Zero(p + 1, q + p + 1);
+  T.topLeftCorner(p, q) = A;
+  T.block(0, q, p, p).setIdentity();
+  T.col(q + p).head(p) = b;
+  std::vector<int> basis(p);
+  for (int i = 0; i < p; ++i) {
+    basis[i] = q + i;
+  }
+
+  auto pivot = [&](int r, int s) {
+    T.row(r) /= T(r, s);
+    for (int i = 0; i <= p; ++i) {
+      if (i != r && T(i, s) != 0) {
+        T.row(i) -= T(i, s) * T.row(r);
+      }
+    }
+    basis[r] = s;
+  };
+  // Pivots until no column < num_columns has a negative reduced cost. Returns false if unbounded.
+  auto iterate = [&](int num_columns) {
+    const int max_iterations = 50 * (p + q + 1);
+    for (int iteration = 0; iteration < max_iterations; ++iteration) {
+      int s = 0;
+      while (s < num_columns && T(p, s) >= -tolerance) {
+        ++s;
+      }
+      if (s == num_columns) {
+        return true;
+      }
+      int r = -1;
+      for (int i = 0; i < p; ++i) {
+        if (T(i, s) > tolerance) {
+          const double ratio = T(i, q + p) / T(i, s);
+          const double best = r < 0 ? 0 : T(r, q + p) / T(r, s);
+          if (r < 0 || ratio < best - tolerance ||
+              (ratio <= best + tolerance && basis[i] < basis[r])) {
+            r = i;
+          }
+        }
+      }
+      if (r < 0) {
+        return false;
+      }
+      pivot(r, s);
+    }
+    return true;
+  };
+
+  // Phase 1: minimize the sum of the artificial variables.
+  T.row(p).head(q) = -A.colwise().sum();
+  T(p, q + p) = -b.sum();
+  iterate(q);
+  if (-T(p, q + p) > tolerance * std::max(1.0, b.cwiseAbs().sum())) {
+    return std::nullopt;
+  }
+  // Drive the remaining artificial variables out of the basis; rows where that is impossible are
+  // redundant and keep their artificial variable at zero.
+  for (int i = 0; i < p; ++i) {
+    if (basis[i] >= q) {
+      for (int j = 0; j < q; ++j) {
+        if (std::abs(T(i, j)) > tolerance) {
+          pivot(i, j);
+          break;
+        }
+      }
+    }
+  }
+
+  // Phase 2: the original objective, never letting an artificial variable enter again.
+  T.row(p).setZero();
+  T.row(p).head(q) = c.transpose();
+  for (int i = 0; i < p; ++i) {
+    if (basis[i] < q) {
+      T.row(p) -= c(basis[i]) * T.row(i);
+    }
+  }
+  if (!iterate(q)) {
+    return std::nullopt;
+  }
+  Eigen::VectorXd y = Eigen::VectorXd::Zero(q);
+  for (int i = 0; i < p; ++i) {
+    if (basis[i] < q) {
+      y(basis[i]) = T(i, q + p);
+    }
+  }
+  return y;
+}
+
+class InfeasibilityPrecheck {
+ public:
+  InfeasibilityPrecheck(const drake::solvers::MathematicalProgram& prog,
+                        const InfeasibilityPrecheckOptions& options)
+      : prog_(prog), options_(options) {
+    const double kInf = std::numeric_limits<double>::infinity();
+    lower_.assign(prog.num_vars(), -kInf);
+    upper_.assign(prog.num_vars(), kInf);
+    lower_reason_.resize(prog.num_vars());
+    upper_reason_.resize(prog.num_vars());
+    for (const auto& binding : prog.bounding_box_constraints()) {
+      const int k = AddConstraint(binding);
+      const auto indices = prog.FindDecisionVariableIndices(binding.variables());
+      for (size_t i = 0; i < indices.size(); ++i) {
+        const int j = indices[i];
+        bounds_.push_back({k, {{j, 1.0}}, binding.evaluator()->lower_bound()(i),
+                           binding.evaluator()->upper_bound()(i)});
+        if (bounds_.back().lower > lower_[j]) {
+          lower_[j] = bounds_.back().lower;
+          lower_reason_[j] = {k};
+        }
+        if (bounds_.back().upper < upper_[j]) {
+          upper_[j] = bounds_.back().upper;
+          upper_reason_[j] = {k};
+        }
+      }
+    }
+    for (const auto& binding : prog.GetAllLinearConstraints()) {
+      const int k = AddConstraint(binding);
+      const auto indices = prog.FindDecisionVariableIndices(binding.variables());
+      const Eigen::SparseMatrix<double, Eigen::RowMajor> A = binding.evaluator()->get_sparse_A();
+      for (int r = 0; r < A.rows(); ++r) {
+        LinearRow row{k, {}, binding.evaluator()->lower_bound()(r),
+                      binding.evaluator()->upper_bound()(r)};
+        for (Eigen::SparseMatrix<double, Eigen::RowMajor>::InnerIterator it(A, r); it; ++it) {
+          if (it.value() != 0) {
+            row.terms.emplace_back(indices[it.col()], it.value());
+          }
+        }
+        rows_.push_back(std::move(row));
+      }
+    }
+  }
+
+  std::optional<InfeasibilityReport> Run() {
+    for (const auto& binding : prog_.GetAllConstraints()) {
+      const auto& evaluator = *binding.evaluator();
+      if (evaluator.num_constraints() == 0) {
+        continue;
+      }
+      if ((evaluator.lower_bound() - evaluator.upper_bound()).maxCoeff() > options_.tolerance) {
+        return Report({AddConstraint(binding)}, "a constraint has a lower bound above its upper "
+                                                "bound");
+      }
+    }
+    for (int j = 0; j < prog_.num_vars(); ++j) {
+      if (lower_[j] > upper_[j] + options_.tolerance) {
+        return ReportBoundConflict(j);
+      }
+    }
+    if (auto report = Propagate()) {
+      return report;
+    }
+    return PhaseOne();
+  }
+
+ private:
+  int AddConstraint(const drake::solvers::Binding<drake::solvers::Constraint>& binding) {
+    constraints_.push_back(binding);
+    return static_cast<int>(constraints_.size()) - 1;
+  }
+
+  InfeasibilityReport Report(std::vector<int> constraint_indices, const std::string& reason) {
+    std::sort(constraint_indices.begin(), constraint_indices.end());
+    constraint_indices.erase(std::unique(constraint_indices.begin(), constraint_indices.end()),
+                             constraint_indices.end());
+    InfeasibilityReport report;
+    report.result.set_decision_variable_index(prog_.decision_variable_index());
+    report.result.set_x_val(
+        Eigen::VectorXd::Constant(prog_.num_vars(), std::numeric_limits<double>::quiet_NaN()));
+    report.result.set_solution_result(drake::solvers::SolutionResult::kInfeasibleConstraints);
+    report.result.set_optimal_cost(drake::solvers::MathematicalProgram::kGlobalInfeasibleCost);
+    report.result.set_solver_id(drake::solvers::SolverId("InfeasibilityPrecheck"));
+    for (int k : constraint_indices) {
+      report.conflicting_constraints.push_back(constraints_[k]);
+    }
+    report.reason = reason;
+    return report;
+  }
+
+  InfeasibilityReport ReportBoundConflict(int j) {
+    std::vector<int> reason = lower_reason_[j];
+    MergeInto(&reason, upper_reason_[j]);
+    return Report(reason, "the bounds of " + prog_.decision_variable(j).get_name() +
+                              " contradict each other");
+  }
+
+  // Tightens the variable bounds with the linear rows. Every bound remembers the constraints it
+  // was derived from, so a contradiction can be traced back to them.
+  std::optional<InfeasibilityReport> Propagate() {
+    const double kInf = std::numeric_limits<double>::infinity();
+    for (int pass = 0; pass < options_.max_propagation_passes; ++pass) {
+      bool tightened = false;
+      for (const LinearRow& row : rows_) {
+        // The smallest and largest value of the row over the current bounds, split into the finite
+        // part and the number of terms that are unbounded in that direction.
+        double min_finite = 0, max_finite = 0;
+        int min_infinite = 0, max_infinite = 0;
+        for (const auto& [j, a] : row.terms) {
+          const double low = a > 0 ? a * lower_[j] : a * upper_[j];
+          const double high = a > 0 ? a * upper_[j] : a * lower_[j];
+          if (std::isinf(low)) {
+            ++min_infinite;
+          } else {
+            min_finite += low;
+          }
+          if (std::isinf(high)) {
+            ++max_infinite;
+          } else {
+            max_finite += high;
+          }
+        }
+        if (min_infinite == 0 && min_finite > row.upper + options_.tolerance) {
+          return Report(RowReason(row, true, -1), "a linear constraint cannot reach its upper "
+                                                  "bound within the variable bounds");
+        }
+        if (max_infinite == 0 && max_finite < row.lower - options_.tolerance) {
+          return Report(RowReason(row, false, -1), "a linear constraint cannot reach its lower "
+                                                   "bound within the variable bounds");
+        }
+        for (const auto& [j, a] : row.terms) {
+          const double low = a > 0 ? a * lower_[j] : a * upper_[j];
+          const double high = a > 0 ? a * upper_[j] : a * lower_[j];
+          // Bounds on the rest of the row, excluding x(j).
+          const double rest_min = std::isinf(low) ? (min_infinite == 1 ? min_finite : -kInf)
+                                                  : (min_infinite == 0 ? min_finite - low : -kInf);
+          const double rest_max = std::isinf(high) ? (max_infinite == 1 ? max_finite : kInf)
+                                                   : (max_infinite == 0 ? max_finite - high : kInf);
+          // a * x(j) <= upper - rest_min and a * x(j) >= lower - rest_max.
+          if (std::isfinite(row.upper) && std::isfinite(rest_min)) {
+            const double bound = (row.upper - rest_min) / a;
+            tightened |= a > 0 ? TightenUpper(j, bound, RowReason(row, true, j))
+                               : TightenLower(j, bound, RowReason(row, true, j));
+          }
+          if (std::isfinite(row.lower) && std::isfinite(rest_max)) {
+            const double bound = (row.lower - rest_max) / a;
+            tightened |= a > 0 ? TightenLower(j, bound, RowReason(row, false, j))
+                               : TightenUpper(j, bound, RowReason(row, false, j));
+          }
+          if (lower_[j] > upper_[j] + options_.tolerance) {
+            return ReportBoundConflict(j);
+          }
+        }
+      }
+      if (!tightened) {
+        break;
+      }
+    }
+    return std::nullopt;
+  }
+
+  // The constraints behind the bounds used for the minimum (or maximum) of `row`, skipping x(skip).
+  std::vector<int> RowReason(const LinearRow& row, bool minimum, int skip) const {
+    std::vector<int> reason{row.constraint};
+    for (const auto& [j, a] : row.terms) {
+      if (j != skip) {
+        MergeInto(&reason, (a > 0) == minimum ? lower_reason_[j] : upper_reason_[j]);
+      }
+    }
+    return reason;
+  }
+
+  bool TightenLower(int j, double bound, std::vector<int> reason) {
+    if (bound <= lower_[j] + options_.tolerance * (1 + std::abs(bound))) {
+      return false;
+    }
+    lower_[j] = bound;
+    lower_reason_[j] = std::move(reason);
+    return true;
+  }
+
+  bool TightenUpper(int j, double bound, std::vector<int> reason) {
+    if (bound >= upper_[j] - options_.tolerance * (1 + std::abs(bound))) {
+      return false;
+    }
+    upper_[j] = bound;
+    upper_reason_[j] = std::move(reason);
+    return true;
+  }
+
+  /*
+   * Farkas' lemma: G x <= h has no solution iff some y >= 0 has G'y = 0 and h'y < 0. The phase-1
+   * LP minimizes h'y over {y >= 0, G'y = 0, sum(y) = 1}; a negative optimum proves infeasibility,
+   * and since the optimum is a vertex its support is an irreducible set of conflicting rows.
+   */
+  std::optional<InfeasibilityReport> PhaseOne() {
+    // Every finite side of a linear row or a variable bound becomes one inequality g'x <= h.
+    std::vector<const LinearRow*> sources;
+    std::vector<double> signs;
+    for (const auto* rows : {&bounds_, &rows_}) {
+      for (const LinearRow& row : *rows) {
+        if (std::isfinite(row.upper)) {
+          sources.push_back(&row);
+          signs.push_back(1);
+        }
+        if (std::isfinite(row.lower)) {
+          sources.push_back(&row);
+          signs.push_back(-1);
+        }
+      }
+    }
+    const int m = sources.size();
+    if (m < 2 || m > options_.max_phase_one_inequalities) {
+      return std::nullopt;
+    }
+    // Only variables that appear in some inequality become rows of G'y = 0.
+    std::vector<int> compact(prog_.num_vars(), -1);
+    int n = 0;
+    for (const LinearRow* row : sources) {
+      for (const auto& term : row->terms) {
+        if (compact[term.first] < 0) {
+          compact[term.first] = n++;
+        }
+      }
+    }
+    Eigen::MatrixXd A = Eigen::MatrixXd::Zero(n + 1, m);
+    Eigen::VectorXd h(m);
+    for (int k = 0; k < m; ++k) {
+      for (const auto& [j, a] : sources[k]->terms) {
+        A(compact[j], k) += signs[k] * a;
+      }
+      A(n, k) = 1;
+      h(k) = signs[k] > 0 ? sources[k]->upper : -sources[k]->lower;
+    }
+    Eigen::VectorXd b = Eigen::VectorXd::Zero(n + 1);
+    b(n) = 1;
+    const auto y = SolveStandardFormLp(A, b, h, options_.tolerance);
+    if (!y || h.dot(*y) >= -options_.tolerance) {
+      return std::nullopt;
+    }
+    std::vector<int> reason;
+    for (int k = 0; k < m; ++k) {
+      if ((*y)(k) > options_.tolerance) {
+        reason.push_back(sources[k]->constraint);
+      }
+    }
+    return Report(reason, "the linear constraints have no common solution");
+  }
+
+  const drake::solvers::MathematicalProgram& prog_;
+  const InfeasibilityPrecheckOptions options_;
+  std::vector<drake::solvers::Binding<drake::solvers::Constraint>> constraints_;
+  // Bounding box rows (one per variable and bounding box) and the rows of the linear constraints.
+  std::vector<LinearRow> bounds_;
+  std::vector<LinearRow> rows_;
+  std::vector<double> lower_;
+  std::vector<double> upper_;
+  std::vector<std::vector<int>> lower_reason_;
+  std::vector<std::vector<int>> upper_reason_;
+};
+
+}  // namespace internal
+
+/*
+ * Looks for infeasibility that is visible without running a solver: constraints with lb > ub,
+ * contradictory variable bounds, linear constraints that bound propagation shows cannot be met, and
+ * linear constraints without a common solution according to a small phase-1 LP. Nonlinear
+ * constraints are not examined, so a program without a report may still be infeasible.
+ *
+ * Returns nullopt if no infeasibility was found.
+ */
+inline std::optional<InfeasibilityReport> CheckObviousInfeasibility(
+    const drake::solvers::MathematicalProgram& prog,
+    const InfeasibilityPrecheckOptions& options = {}) {
+  return internal::InfeasibilityPrecheck(prog, options).Run();
+}
+
+// Solve() that returns the pre-check's result instead of running a solver on obviously infeasible
+// programs. `report` receives the pre-check's report if not null.
+inline drake::solvers::MathematicalProgramResult SolveWithInfeasibilityPrecheck(
+    const drake::solvers::MathematicalProgram& prog,
+    const std::optional<Eigen::VectorXd>& initial_guess = std::nullopt,
+    const std::optional<drake::solvers::SolverOptions>& solver_options = std::nullopt,
+    std::optional<InfeasibilityReport>* report = nullptr,
+    const InfeasibilityPrecheckOptions& options = {}) {
+  auto found = CheckObviousInfeasibility(prog, options);
+  if (found) {
+    auto result = found->result;
+    if (report != nullptr) {
+      *report = std::move(found);
+    }
+    return result;
+  }
+  if (report != nullptr) {
+    report->reset();
+  }
+  return drake::solvers::Solve(prog, initial_guess, solver_options);
+}
+
+}  // namespace drake_tutorials
@@ -0,0 +1,80 @@
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/solve.h>
+
+#include <gflags/gflags.h>
+
+#include "infeasibility_precheck.h"
+#include "tutorial_programs.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+DEFINE_int32(num_programs, 2000, "Number of generated programs, about half of them infeasible.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  // The program of simple_optimization_problem_infeasible.cpp.
+  auto prog = drake_tutorials::MakeInfeasibleProgram();
+  const auto report = drake_tutorials::CheckObviousInfeasibility(*prog);
+  if (report) {
+    print("Solution result: ", report->result.get_solution_result(), " (", report->reason, ")");
+    for (const auto& binding : report->conflicting_constraints) {
+      print("conflicting: ", binding);
+    }
+  }
+
+  // A pipeline of generated programs x + y >= lower, x + y <= 0 with lower in [-1, 1]. The box
+  // -10 <= x, y <= 10 bounds the cost x, so the feasible half has an optimum instead of being
+  // unbounded.
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> lower(-1, 1);
+  std::vector<std::unique_ptr<drake::solvers::MathematicalProgram>> programs;
+  for (int i = 0; i < FLAGS_num_programs; ++i) {
+    auto p = drake_tutorials::MakeInfeasibleProgram(lower(generator));
+    p->AddBoundingBoxConstraint(-10, 10, p->decision_variables());
+    programs.push_back(std::move(p));
+  }
+
+  int num_infeasible = 0;
+  int num_optimal = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto& p : programs) {
+    const auto result = drake::solvers::Solve(*p);
+    num_infeasible += result.get_solution_result() ==
+                      drake::solvers::SolutionResult::kInfeasibleConstraints;
+    num_optimal += result.is_success();
+  }
+  const std::chrono::duration<double> solve_only = std::chrono::steady_clock::now() - start;
+  print("Solve(): ", solve_only.count(), " s, ", num_infeasible, " infeasible, ", num_optimal,
+        " optimal");
+
+  num_infeasible = 0;
+  num_optimal = 0;
+  int num_prechecked = 0;
+  start = std::chrono::steady_clock::now();
+  for (const auto& p : programs) {
+    std::optional<drake_tutorials::InfeasibilityReport> found;
+    const auto result = drake_tutorials::SolveWithInfeasibilityPrecheck(*p, std::nullopt,
+                                                                        std::nullopt, &found);
+    num_infeasible += result.get_solution_result() ==
+                      drake::solvers::SolutionResult::kInfeasibleConstraints;
+    num_optimal += result.is_success();
+    num_prechecked += found.has_value();
+  }
+  const std::chrono::duration<double> prechecked = std::chrono::steady_clock::now() - start;
+  print("with pre-check: ", prechecked.count(), " s, ", num_infeasible, " infeasible, ",
+        num_optimal, " optimal, ", num_prechecked, " caught without a solver, speedup ",
+        solve_only.count() / prechecked.count());
+  return 0;
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <drake/solvers/mathematical_program.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace drake_tutorials {
+
+/*
+ * Records solver iterates from a visualization callback without stalling the solver.
+ *
+ * The callback (the single producer) copies each iterate into a preallocated lock-free ring buffer
+ * and returns; a background thread drains the buffer into a binary trace file or hands the
+ * iterates to a consumer function. The producer never allocates, locks or does I/O. If the
+ * consumer falls behind and the buffer is full, the iterate is dropped and counted instead of
+ * blocking the solver.
+ *
+ * The trace file starts with the magic "ITRC", a uint32 version (1) and a uint32 dimension,
+ * followed by one record per iterate: int64 iteration, double seconds since the recorder was
+ * created, and `dimension` doubles.
+ */
+class IterateRecorder {
+ public:
+  using Consumer = std::function<void(std::int64_t iteration, double time,
+                                      const Eigen::Ref<const Eigen::VectorXd>& x)>;
+
+  // Writes the iterates to the trace file at `path`. `capacity` is rounded up to a power of two.
+  IterateRecorder(int dimension, const std::string& path, int capacity = 4096)
+      : IterateRecorder(dimension, capacity) {
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr) {
+      throw std::runtime_error("IterateRecorder: cannot open '" + path + "' for writing.");
+    }
+    const std::uint32_t header[2] = {kVersion, static_cast<std::uint32_t>(dimension)};
+    std::fwrite(kMagic, 1, 4, file_);
+    std::fwrite(header, sizeof(header), 1, file_);
+    consumer_thread_ = std::thread([this] { Drain(); });
+  }
+
+  // Hands every iterate to `consumer`, called on the background thread.
+  IterateRecorder(int dimension, Consumer consumer, int capacity = 4096)
+      : IterateRecorder(dimension, capacity) {
+    consumer_ = std::move(consumer);
+    consumer_thread_ = std::thread([this] { Drain(); });
+  }
+
+  IterateRecorder(const IterateRecorder&) = delete;
+  IterateRecorder& operator=(const IterateRecorder&) = delete;
+
+  // Drains the remaining iterates and closes the trace file.
+  ~IterateRecorder() {
+    stop_.store(true, std::memory_order_release);
+    // Not started if a constructor threw after the delegated one had finished.
+    if (consumer_thread_.joinable()) {
+      consumer_thread_.join();
+    }
+    if (file_ != nullptr) {
+      std::fclose(file_);
+    }
+  }
+
+  // Copies `x` into the ring buffer. Must only be called from one thread at a time. Throws
+  // std::invalid_argument if `x` does not have the recorder's dimension.
+  void Push(const Eigen::Ref<const Eigen::VectorXd>& x) {
+    if (x.size() != dimension_) {
+      throw std::invalid_argument("IterateRecorder: expected an iterate of size " +
+                                  std::to_string(dimension_) + ", got " +
+                                  std::to_string(x.size()) + ".");
+    }
+    const std::uint64_t head = head_.load(std::memory_order_relaxed);
+    const std::int64_t iteration = num_pushed_++;
+    if (head - tail_.load(std::memory_order_acquire) == capacity_) {
+      num_dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    const std::size_t slot = head & (capacity_ - 1);
+    iterations_[slot] = iteration;
+    times_[slot] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    Eigen::Map<Eigen::VectorXd>(&values_[slot * dimension_], dimension_) = x;
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  // A visualization callback that pushes into this recorder, for
+  // MathematicalProgram::AddVisualizationCallback().
+  drake::solvers::MathematicalProgram::VisualizationCallbackFunction callback() {
+    return [this](const Eigen::Ref<const Eigen::VectorXd>& x) { Push(x); };
+  }
+
+  std::int64_t num_dropped() const { return num_dropped_.load(std::memory_order_relaxed); }
+  std::int64_t num_recorded() const { return num_recorded_.load(std::memory_order_relaxed); }
+
+ private:
+  static constexpr char kMagic[4] = {'I', 'T', 'R', 'C'};
+  static constexpr std::uint32_t kVersion = 1;
+
+  IterateRecorder(int dimension, int capacity)
+      : dimension_(dimension), start_(std::chrono::steady_clock::now()) {
+    capacity_ = 1;
+    while (capacity_ < static_cast<std::uint64_t>(capacity)) {
+      capacity_ <<= 1;
+    }
+    iterations_.resize(capacity_);
+    times_.resize(capacity_);
+    values_.resize(capacity_ * dimension_);
+  }
+
+  void Drain() {
+    while (true) {
+      const bool stopping = stop_.load(std::memory_order_acquire);
+      const std::uint64_t head = head_.load(std::memory_order_acquire);
+      std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+      for (; tail != head; ++tail) {
+        Consume(tail & (capacity_ - 1));
+        tail_.store(tail + 1, std::memory_order_release);
+      }
+      if (stopping) {
+        return;
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  }
+
+  void Consume(std::size_t slot) {
+    const double* x = &values_[slot * dimension_];
+    if (file_ != nullptr) {
+      std::fwrite(&iterations_[slot], sizeof(std::int64_t), 1, file_);
+      std::fwrite(&times_[slot], sizeof(double), 1, file_);
+      std::fwrite(x, sizeof(double), dimension_, file_);
+    } else {
+      consumer_(iterations_[slot], times_[slot], Eigen::Map<const Eigen::VectorXd>(x, dimension_));
+    }
+    num_recorded_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  const int dimension_;
+  const std::chrono::steady_clock::time_point start_;
+  std::uint64_t capacity_;
+  std::vector<std::int64_t> iterations_;
+  std::vector<double> times_;
+  std::vector<double> values_;
+  // head_ is only written by the producer, tail_ only by the consumer thread.
+  std::atomic<std::uint64_t> head_{0};
+  std::atomic<std::uint64_t> tail_{0};
+  std::int64_t num_pushed_{0};
+  std::atomic<std::int64_t> num_dropped_{0};
+  std::atomic<std::int64_t> num_recorded_{0};
+  std::atomic<bool> stop_{false};
+  std::FILE* file_{nullptr};
+  Consumer consumer_;
+  std::thread consumer_thread_;
+};
+
+// Reads a trace written by IterateRecorder. Returns the iterates column-wise; `iterations` and
+// `times` receive the iteration numbers and time stamps if not null.
+inline Eigen::MatrixXd ReadIterateTrace(const std::string& path,
+                                        std::vector<std::int64_t>* iterations = nullptr,
+                                        std::vector<double>* times = nullptr) {
+  std::FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    throw std::runtime_error("ReadIterateTrace: cannot open '" + path + "'.");
+  }
+  char magic[4];
+  std::uint32_t header[2];
+  if (std::fread(magic, 1, 4, file) != 4 || std::string(magic, 4) != "ITRC" ||
+      std::fread(header, sizeof(header), 1, file) != 1 || header[0] != 1) {
+    std::fclose(file);
+    throw std::runtime_error("ReadIterateTrace: '" + path + "' is not an iterate trace.");
+  }
+  const int dimension = header[1];
+  std::vector<double> values;
+  if (dimension == 0) {
+    std::fclose(file);
+    return Eigen::MatrixXd(0, 0);
+  }
+  std::int64_t iteration;
+  double time;
+  std::vector<double> x(dimension);
+  while (std::fread(&iteration, sizeof(iteration), 1, file) == 1 &&
+         std::fread(&time, sizeof(time), 1, file) == 1 &&
+         std::fread(x.data(), sizeof(double), dimension, file) == static_cast<size_t>(dimension)) {
+    if (iterations != nullptr) {
+      iterations->push_back(iteration);
+    }
+    if (times != nullptr) {
+      times->push_back(time);
+    }
+    values.insert(values.end(), x.begin(), x.end());
+  }
+  std::fclose(file);
+  return Eigen::Map<Eigen::MatrixXd>(values.data(), dimension, values.size() / dimension);
+}
+
+}  // namespace drake_tutorials
@@ -0,0 +1,87 @@
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+
+#include <gflags/gflags.h>
+
+#include "iterate_recorder.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+DEFINE_int32(num_pairs, 500, "Number of (x(2i), x(2i+1)) pairs, each with x(2i) * x(2i+1) = 9.");
+DEFINE_int32(repetitions, 10, "Number of solves per variant.");
+DEFINE_string(trace, "iterates.bin", "Path of the binary trace written by the async recorder.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+/*
+ * add_callback.cpp scaled up to many variables:
+ *    min sum_i x(i)^2
+ * subject to x(2i) * x(2i+1) = 9
+ */
+std::unique_ptr<drake::solvers::MathematicalProgram> MakeProgram(int num_pairs) {
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  auto x = prog->NewContinuousVariables(2 * num_pairs);
+  for (int i = 0; i < num_pairs; ++i) {
+    prog->AddConstraint(x[2 * i] * x[2 * i + 1] == 9);
+  }
+  prog->AddQuadraticCost(Eigen::MatrixXd::Identity(x.size(), x.size()) * 2,
+                         Eigen::VectorXd::Zero(x.size()), x);
+  return prog;
+}
+
+// Returns the mean solve time in seconds.
+double TimeSolves(const drake::solvers::MathematicalProgram& prog) {
+  drake::solvers::IpoptSolver solver;
+  drake::solvers::SolverOptions options;
+  options.SetOption(drake::solvers::IpoptSolver::id(), "print_level", 0);
+  const Eigen::VectorXd initial_guess =
+      Eigen::Vector2d(4, 5).replicate(prog.num_vars() / 2, 1);
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < FLAGS_repetitions; ++i) {
+    solver.Solve(prog, initial_guess, options);
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / FLAGS_repetitions;
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  auto prog = MakeProgram(FLAGS_num_pairs);
+  const double baseline = TimeSolves(*prog);
+  print("no callback: ", baseline * 1e3, " ms per solve");
+
+  // The tutorial's update(): format every iterate synchronously inside the solver loop. The text
+  // goes to a file instead of the terminal to keep the comparison fair.
+  {
+    auto sync_prog = prog->Clone();
+    std::ofstream out("iterates.txt");
+    sync_prog->AddVisualizationCallback(
+        [&out](const Eigen::Ref<const Eigen::VectorXd>& x) {
+          out << "x = " << x.transpose() << "\n---\n";
+        },
+        sync_prog->decision_variables());
+    const double sync = TimeSolves(*sync_prog);
+    print("synchronous text output: ", sync * 1e3, " ms per solve, overhead ",
+          100 * (sync - baseline) / baseline, " %");
+  }
+
+  {
+    auto async_prog = prog->Clone();
+    drake_tutorials::IterateRecorder recorder(async_prog->num_vars(), FLAGS_trace);
+    async_prog->AddVisualizationCallback(recorder.callback(), async_prog->decision_variables());
+    const double async = TimeSolves(*async_prog);
+    print("asynchronous recorder: ", async * 1e3, " ms per solve, overhead ",
+          100 * (async - baseline) / baseline, " %, dropped iterates: ", recorder.num_dropped());
+  }
+
+  const Eigen::MatrixXd iterates = drake_tutorials::ReadIterateTrace(FLAGS_trace);
+  print("read back ", iterates.cols(), " iterates of dimension ", iterates.rows(), " from ",
+        FLAGS_trace);
+  return 0;
+}
@@ -0,0 +1,441 @@
+#pragma once
+
+#include <drake/math/autodiff.h>
+#include <drake/math/autodiff_gradient.h>
+#include <drake/solvers/constraint.h>
+#include <drake/solvers/cost.h>
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/solve.h>
+
+#include <Eigen/OrderingMethods>
+#include <Eigen/SparseCore>
+#include <Eigen/SparseQR>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace drake_tutorials {
+
+namespace internal {
+
+// The original variables x_v of a binding as an affine function offset + matrix * z of the
+// reduced variables z it depends on. The matrix is sparse, since a binding over many variables
+// (e.g. a bounding box over all of them) sees most of the null-space basis.
+struct AffineRestriction {
+  Eigen::VectorXd offset;
+  Eigen::SparseMatrix<double> matrix;
+  drake::solvers::VectorXDecisionVariable z;
+};
+
+// Evaluates an evaluator of the original program at x_v = offset + matrix * z.
+class AffineSubstitution {
+ public:
+  AffineSubstitution(std::shared_ptr<drake::solvers::EvaluatorBase> evaluator,
+                     AffineRestriction restriction)
+      : evaluator_(std::move(evaluator)), restriction_(std::move(restriction)) {}
+
+  void Eval(const Eigen::Ref<const Eigen::VectorXd>& z, Eigen::VectorXd* y) const {
+    evaluator_->Eval(restriction_.offset + restriction_.matrix * z, y);
+  }
+
+  void Eval(const Eigen::Ref<const drake::AutoDiffVecXd>& z, drake::AutoDiffVecXd* y) const {
+    const Eigen::VectorXd value =
+        restriction_.offset + restriction_.matrix * drake::math::ExtractValue(z);
+    const Eigen::MatrixXd gradient = restriction_.matrix * drake::math::ExtractGradient(z);
+    evaluator_->Eval(drake::math::InitializeAutoDiff(value, gradient), y);
+  }
+
+  void Eval(const Eigen::Ref<const drake::VectorX<drake::symbolic::Variable>>&,
+            drake::VectorX<drake::symbolic::Expression>*) const {
+    throw std::logic_error("Symbolic evaluation of an eliminated program is not supported.");
+  }
+
+  const drake::solvers::EvaluatorBase& evaluator() const { return *evaluator_; }
+  int num_vars() const { return restriction_.matrix.cols(); }
+
+ private:
+  std::shared_ptr<drake::solvers::EvaluatorBase> evaluator_;
+  AffineRestriction restriction_;
+};
+
+class SubstitutedCost : public drake::solvers::Cost {
+ public:
+  explicit SubstitutedCost(AffineSubstitution substitution)
+      : Cost(substitution.num_vars(), substitution.evaluator().get_description()),
+        substitution_(std::move(substitution)) {}
+
+ private:
+  void DoEval(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::VectorXd* y) const override {
+    substitution_.Eval(x, y);
+  }
+  void DoEval(const Eigen::Ref<const drake::AutoDiffVecXd>& x,
+              drake::AutoDiffVecXd* y) const override {
+    substitution_.Eval(x, y);
+  }
+  void DoEval(const Eigen::Ref<const drake::VectorX<drake::symbolic::Variable>>& x,
+              drake::VectorX<drake::symbolic::Expression>* y) const override {
+    substitution_.Eval(x, y);
+  }
+
+  AffineSubstitution substitution_;
+};
+
+class SubstitutedConstraint : public drake::solvers::Constraint {
+ public:
+  SubstitutedConstraint(AffineSubstitution substitution, const Eigen::VectorXd& lb,
+                        const Eigen::VectorXd& ub)
+      : Constraint(lb.size(), substitution.num_vars(), lb, ub,
+                   substitution.evaluator().get_description()),
+        substitution_(std::move(substitution)) {}
+
+ private:
+  void DoEval(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::VectorXd* y) const override {
+    substitution_.Eval(x, y);
+  }
+  void DoEval(const Eigen::Ref<const drake::AutoDiffVecXd>& x,
+              drake::AutoDiffVecXd* y) const override {
+    substitution_.Eval(x, y);
+  }
+  void DoEval(const Eigen::Ref<const drake::VectorX<drake::symbolic::Variable>>& x,
+              drake::VectorX<drake::symbolic::Expression>* y) const override {
+    substitution_.Eval(x, y);
+  }
+
+  AffineSubstitution substitution_;
+};
+
+}  // namespace internal
+
+/*
+ * Presolve that eliminates the linear equality constraints of a program by substitution.
+ *
+ * The stacked equalities A x = b are factored with a sparse QR decomposition with column pivoting,
+ * A P = Q [R1 R2], which splits x into rank(A) basic variables and free variables z. Every
+ * solution is x = x0 + Z z with a particular solution x0 (the free variables at zero) and the
+ * null-space basis Z = P [-R1^-1 R2; I], so the reduced program only has the free variables and
+ * no equalities.
+ * Linear and quadratic costs and linear constraints stay linear and quadratic in z; any other cost
+ * or constraint is wrapped in an evaluator that substitutes x before calling the original.
+ *
+ * The solution is mapped back to x. The multipliers of the remaining constraints carry over
+ * unchanged; those of the eliminated equalities are recovered from the stationarity condition
+ * A' lambda = grad f(x) - sum_i J_i(x)' lambda_i in the least-squares sense.
+ */
+class LinearEqualityElimination {
+ public:
+  // Throws std::invalid_argument if the program has costs or constraints other than generic,
+  // linear and quadratic ones, bounding boxes and linear (equality) constraints. Keeps a clone of
+  // `prog`, which shares its evaluators, so `prog` may be destroyed first and results still refer
+  // to its bindings.
+  explicit LinearEqualityElimination(const drake::solvers::MathematicalProgram& prog,
+                                     double tolerance = 1e-8)
+      : prog_(prog.Clone()), reduced_(std::make_unique<drake::solvers::MathematicalProgram>()) {
+    const int n = prog.num_vars();
+    StackEqualities();
+    int rank = 0;
+    x0_ = Eigen::VectorXd::Zero(n);
+    permutation_.setIdentity(n);
+    Eigen::SparseMatrix<double> W(0, n);
+    if (A_.rows() > 0) {
+      Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int>> qr;
+      qr.setPivotThreshold(tolerance);
+      qr.compute(A_);
+      rank = qr.rank();
+      x0_ = qr.solve(b_);
+      consistent_ = (A_ * x0_ - b_).cwiseAbs().maxCoeff() <=
+                    tolerance * (1 + b_.cwiseAbs().maxCoeff());
+      // A P = Q [R1 R2]; the free variables are the last n - rank entries of P' x.
+      permutation_ = qr.colsPermutation();
+      const Eigen::SparseMatrix<double> R = qr.matrixR();
+      const Eigen::SparseMatrix<double> R1 = R.topLeftCorner(rank, rank);
+      W = R.block(0, rank, rank, n - rank);
+      R1.triangularView<Eigen::Upper>().solveInPlace(W);
+      W.prune(1.0, tolerance);
+    }
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int k = 0; k < W.outerSize(); ++k) {
+      for (Eigen::SparseMatrix<double>::InnerIterator it(W, k); it; ++it) {
+        triplets.emplace_back(permutation_.indices()(it.row()), it.col(), -it.value());
+      }
+    }
+    for (int j = 0; j < n - rank; ++j) {
+      triplets.emplace_back(permutation_.indices()(rank + j), j, 1.0);
+    }
+    Z_.resize(n, n - rank);
+    Z_.setFromTriplets(triplets.begin(), triplets.end());
+    z_ = reduced_->NewContinuousVariables(n - rank, "z");
+    BuildReducedProgram();
+  }
+
+  const drake::solvers::MathematicalProgram& reduced_prog() const { return *reduced_; }
+  // x = particular_solution() + null_space() * z.
+  const Eigen::VectorXd& particular_solution() const { return x0_; }
+  const Eigen::SparseMatrix<double, Eigen::RowMajor>& null_space() const { return Z_; }
+  int num_eliminated() const { return prog_->num_vars() - Z_.cols(); }
+  // False if the equalities have no common solution.
+  bool consistent() const { return consistent_; }
+
+  // The free variables that reproduce `x` as well as possible.
+  Eigen::VectorXd Reduce(const Eigen::Ref<const Eigen::VectorXd>& x) const {
+    const Eigen::VectorXd permuted = permutation_.transpose() * (x - x0_);
+    return permuted.tail(Z_.cols());
+  }
+
+  Eigen::VectorXd Expand(const Eigen::Ref<const Eigen::VectorXd>& z) const { return x0_ + Z_ * z; }
+
+  // Solves the reduced program and returns the result in terms of the original program.
+  drake::solvers::MathematicalProgramResult Solve(
+      const std::optional<Eigen::VectorXd>& initial_guess = std::nullopt,
+      const std::optional<drake::solvers::SolverOptions>& solver_options = std::nullopt) const {
+    drake::solvers::MathematicalProgramResult result;
+    result.set_decision_variable_index(prog_->decision_variable_index());
+    if (!consistent_) {
+      result.set_x_val(
+          Eigen::VectorXd::Constant(prog_->num_vars(), std::numeric_limits<double>::quiet_NaN()));
+      result.set_solution_result(drake::solvers::SolutionResult::kInfeasibleConstraints);
+      result.set_optimal_cost(drake::solvers::MathematicalProgram::kGlobalInfeasibleCost);
+      return result;
+    }
+    std::optional<Eigen::VectorXd> z_guess;
+    if (initial_guess) {
+      z_guess = Reduce(*initial_guess);
+    }
+    const auto reduced_result = drake::solvers::Solve(*reduced_, z_guess, solver_options);
+    const Eigen::VectorXd x = Expand(reduced_result.get_x_val());
+    result.set_x_val(x);
+    result.set_solution_result(reduced_result.get_solution_result());
+    result.set_optimal_cost(reduced_result.get_optimal_cost());
+    result.set_solver_id(reduced_result.get_solver_id());
+    if (reduced_result.is_success()) {
+      SetDualSolutions(reduced_result, x, &result);
+    }
+    return result;
+  }
+
+ private:
+  void StackEqualities() {
+    std::vector<Eigen::Triplet<double>> triplets;
+    std::vector<double> b;
+    for (const auto& binding : prog_->linear_equality_constraints()) {
+      const auto indices = prog_->FindDecisionVariableIndices(binding.variables());
+      const Eigen::SparseMatrix<double>& A = binding.evaluator()->get_sparse_A();
+      for (int k = 0; k < A.outerSize(); ++k) {
+        for (Eigen::SparseMatrix<double>::InnerIterator it(A, k); it; ++it) {
+          triplets.emplace_back(b.size() + it.row(), indices[it.col()], it.value());
+        }
+      }
+      equality_rows_.push_back(b.size());
+      const Eigen::VectorXd& beq = binding.evaluator()->lower_bound();
+      b.insert(b.end(), beq.data(), beq.data() + beq.size());
+    }
+    A_.resize(b.size(), prog_->num_vars());
+    A_.setFromTriplets(triplets.begin(), triplets.end());
+    A_.makeCompressed();
+    b_ = Eigen::Map<const Eigen::VectorXd>(b.data(), b.size());
+  }
+
+  // The rows of x = x0 + Z z for the variables of `binding`, restricted to the columns of z they
+  // depend on.
+  template <typename C>
+  internal::AffineRestriction Restrict(const drake::solvers::Binding<C>& binding) const {
+    const auto indices = prog_->FindDecisionVariableIndices(binding.variables());
+    std::vector<int> columns;
+    std::vector<int> position(Z_.cols(), -1);
+    for (int i : indices) {
+      for (Eigen::SparseMatrix<double, Eigen::RowMajor>::InnerIterator it(Z_, i); it; ++it) {
+        if (position[it.col()] < 0) {
+          position[it.col()] = columns.size();
+          columns.push_back(it.col());
+        }
+      }
+    }
+    internal::AffineRestriction restriction;
+    restriction.offset.resize(indices.size());
+    restriction.z.resize(columns.size());
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (size_t r = 0; r < indices.size(); ++r) {
+      restriction.offset(r) = x0_(indices[r]);
+      for (Eigen::SparseMatrix<double, Eigen::RowMajor>::InnerIterator it(Z_, indices[r]); it;
+           ++it) {
+        triplets.emplace_back(r, position[it.col()], it.value());
+      }
+    }
+    restriction.matrix.resize(indices.size(), columns.size());
+    restriction.matrix.setFromTriplets(triplets.begin(), triplets.end());
+    for (size_t c = 0; c < columns.size(); ++c) {
+      restriction.z(c) = z_(columns[c]);
+    }
+    return restriction;
+  }
+
+  static bool IsIdentity(const Eigen::SparseMatrix<double>& matrix) {
+    if (matrix.rows() != matrix.cols() || matrix.nonZeros() != matrix.rows()) {
+      return false;
+    }
+    for (int k = 0; k < matrix.outerSize(); ++k) {
+      for (Eigen::SparseMatrix<double>::InnerIterator it(matrix, k); it; ++it) {
+        if (it.row() != it.col() || it.value() != 1) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  void BuildReducedProgram() {
+    const size_t num_supported_costs = prog_->generic_costs().size() +
+                                       prog_->linear_costs().size() +
+                                       prog_->quadratic_costs().size();
+    const size_t num_supported_constraints =
+        prog_->generic_constraints().size() + prog_->bounding_box_constraints().size() +
+        prog_->linear_constraints().size() + prog_->linear_equality_constraints().size();
+    if (prog_->GetAllCosts().size() != num_supported_costs ||
+        prog_->GetAllConstraints().size() != num_supported_constraints) {
+      throw std::invalid_argument(
+          "LinearEqualityElimination: only generic, linear and quadratic costs and generic, "
+          "bounding box and linear constraints are supported.");
+    }
+
+    for (const auto& binding : prog_->linear_costs()) {
+      const auto r = Restrict(binding);
+      const auto& cost = *binding.evaluator();
+      const Eigen::VectorXd a = r.matrix.transpose() * cost.a();
+      reduced_->AddLinearCost(a, cost.a().dot(r.offset) + cost.b(), r.z);
+    }
+    for (const auto& binding : prog_->quadratic_costs()) {
+      const auto r = Restrict(binding);
+      const auto& cost = *binding.evaluator();
+      // Drake keeps the Hessian of a QuadraticCost dense anyway.
+      const Eigen::MatrixXd QZ = cost.Q() * r.matrix;
+      const Eigen::MatrixXd Q = r.matrix.transpose() * QZ;
+      const Eigen::VectorXd q = r.matrix.transpose() * (cost.Q() * r.offset + cost.b());
+      reduced_->AddQuadraticCost(
+          Q, q, 0.5 * r.offset.dot(cost.Q() * r.offset) + cost.b().dot(r.offset) + cost.c(), r.z);
+    }
+    for (const auto& binding : prog_->generic_costs()) {
+      auto r = Restrict(binding);
+      const auto z = r.z;
+      reduced_->AddCost(std::make_shared<internal::SubstitutedCost>(
+                            internal::AffineSubstitution(binding.evaluator(), std::move(r))),
+                        z);
+    }
+
+    for (const auto& binding : prog_->bounding_box_constraints()) {
+      const auto r = Restrict(binding);
+      const auto& constraint = *binding.evaluator();
+      const Eigen::VectorXd lb = constraint.lower_bound() - r.offset;
+      const Eigen::VectorXd ub = constraint.upper_bound() - r.offset;
+      // Bounds on free variables stay bounds, so the solver can still treat them as such.
+      if (IsIdentity(r.matrix)) {
+        constraint_pairs_.emplace_back(binding, reduced_->AddBoundingBoxConstraint(lb, ub, r.z));
+      } else {
+        constraint_pairs_.emplace_back(binding,
+                                       reduced_->AddLinearConstraint(r.matrix, lb, ub, r.z));
+      }
+    }
+    for (const auto& binding : prog_->linear_constraints()) {
+      const auto r = Restrict(binding);
+      const auto& constraint = *binding.evaluator();
+      const Eigen::SparseMatrix<double>& A = constraint.get_sparse_A();
+      const Eigen::VectorXd shift = A * r.offset;
+      const Eigen::SparseMatrix<double> AZ = A * r.matrix;
+      constraint_pairs_.emplace_back(
+          binding, reduced_->AddLinearConstraint(AZ, constraint.lower_bound() - shift,
+                                                 constraint.upper_bound() - shift, r.z));
+    }
+    for (const auto& binding : prog_->generic_constraints()) {
+      auto r = Restrict(binding);
+      const auto z = r.z;
+      const auto& constraint = *binding.evaluator();
+      constraint_pairs_.emplace_back(
+          binding, reduced_->AddConstraint(
+                       std::make_shared<internal::SubstitutedConstraint>(
+                           internal::AffineSubstitution(binding.evaluator(), std::move(r)),
+                           constraint.lower_bound(), constraint.upper_bound()),
+                       z));
+    }
+  }
+
+  // Accumulates J' * weights of the evaluator of `binding` at `x` into `gradient`.
+  template <typename C>
+  void AddGradient(const drake::solvers::Binding<C>& binding, const Eigen::VectorXd& x,
+                   const Eigen::VectorXd& weights, Eigen::VectorXd* gradient) const {
+    const auto indices = prog_->FindDecisionVariableIndices(binding.variables());
+    Eigen::VectorXd x_binding(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+      x_binding(i) = x(indices[i]);
+    }
+    drake::AutoDiffVecXd y;
+    binding.evaluator()->Eval(drake::math::InitializeAutoDiff(x_binding), &y);
+    const Eigen::VectorXd g =
+        drake::math::ExtractGradient(y, indices.size()).transpose() * weights;
+    for (size_t i = 0; i < indices.size(); ++i) {
+      (*gradient)(indices[i]) += g(i);
+    }
+  }
+
+  void SetDualSolutions(const drake::solvers::MathematicalProgramResult& reduced_result,
+                        const Eigen::VectorXd& x,
+                        drake::solvers::MathematicalProgramResult* result) const {
+    // All multipliers are computed before any is written, so `result` gets either all of them or
+    // none.
+    std::vector<Eigen::VectorXd> duals;
+    duals.reserve(constraint_pairs_.size());
+    for (const auto& pair : constraint_pairs_) {
+      try {
+        duals.push_back(reduced_result.GetDualSolution(pair.second));
+      } catch (const std::invalid_argument&) {
+        // The solver does not report multipliers.
+        return;
+      }
+    }
+    Eigen::VectorXd residual = Eigen::VectorXd::Zero(prog_->num_vars());
+    for (const auto& binding : prog_->GetAllCosts()) {
+      AddGradient(binding, x, Eigen::VectorXd::Ones(1), &residual);
+    }
+    for (size_t i = 0; i < constraint_pairs_.size(); ++i) {
+      AddGradient(constraint_pairs_[i].first, x, -duals[i], &residual);
+    }
+    Eigen::VectorXd lambda;
+    if (A_.rows() > 0) {
+      // A' lambda = residual in the least-squares sense.
+      Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int>> qr;
+      Eigen::SparseMatrix<double> At = A_.transpose();
+      At.makeCompressed();
+      qr.compute(At);
+      lambda = qr.solve(residual);
+    }
+    for (size_t i = 0; i < constraint_pairs_.size(); ++i) {
+      result->set_dual_solution(constraint_pairs_[i].first, duals[i]);
+    }
+    const auto& equalities = prog_->linear_equality_constraints();
+    for (size_t i = 0; i < equalities.size(); ++i) {
+      result->set_dual_solution(
+          equalities[i],
+          lambda.segment(equality_rows_[i], equalities[i].evaluator()->num_constraints()));
+    }
+  }
+
+  std::unique_ptr<drake::solvers::MathematicalProgram> prog_;
+  std::unique_ptr<drake::solvers::MathematicalProgram> reduced_;
+  drake::solvers::VectorXDecisionVariable z_;
+  // The stacked equalities A x = b; equality_rows_[i] is the first row of the i-th equality.
+  Eigen::SparseMatrix<double> A_;
+  Eigen::VectorXd b_;
+  std::vector<int> equality_rows_;
+  Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> permutation_;
+  Eigen::VectorXd x0_;
+  Eigen::SparseMatrix<double, Eigen::RowMajor> Z_;
+  bool consistent_{true};
+  // Every remaining constraint of the original program and its counterpart in the reduced one.
+  std::vector<std::pair<drake::solvers::Binding<drake::solvers::Constraint>,
+                        drake::solvers::Binding<drake::solvers::Constraint>>>
+      constraint_pairs_;
+};
+
+}  // namespace drake_tutorials
@@ -0,0 +1,86 @@
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/solve.h>
+
+#include <gflags/gflags.h>
+
+#include "linear_equality_elimination.h"
+
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+
+DEFINE_string(sizes, "250,500,1000,2000,4000", "Comma-separated numbers of variable triples.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+/*
+ * simple_optimization_problem_feasible.cpp scaled up to many coupled triples:
+ *    min sum_j (x(j) - c(j))^2
+ * subject to x(3i) + x(3i+1) + x(3i+2) = 1
+ *            x(3i+2) = x(3i+3)
+ *            x >= 0
+ * which has about two equality rows per three variables.
+ */
+std::unique_ptr<drake::solvers::MathematicalProgram> MakeProgram(int num_triples) {
+  std::mt19937 generator(num_triples);
+  std::uniform_real_distribution<double> target(-0.5, 1);
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  auto x = prog->NewContinuousVariables(3 * num_triples, "x");
+  for (int i = 0; i < num_triples; ++i) {
+    prog->AddLinearEqualityConstraint(Eigen::RowVector3d(1, 1, 1), 1, x.segment<3>(3 * i));
+    if (i + 1 < num_triples) {
+      prog->AddLinearEqualityConstraint(Eigen::RowVector2d(1, -1), 0, x.segment<2>(3 * i + 2));
+    }
+  }
+  for (int j = 0; j < x.size(); ++j) {
+    const double c = target(generator);
+    prog->AddQuadraticCost(2 * Eigen::Matrix<double, 1, 1>::Identity(), drake::Vector1d(-2 * c),
+                           c * c, x.segment<1>(j));
+  }
+  prog->AddBoundingBoxConstraint(0, std::numeric_limits<double>::infinity(), x);
+  return prog;
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  std::stringstream sizes(FLAGS_sizes);
+  std::string size;
+  while (std::getline(sizes, size, ',')) {
+    const int num_triples = std::stoi(size);
+    const auto prog = MakeProgram(num_triples);
+
+    auto start = std::chrono::steady_clock::now();
+    const auto original = drake::solvers::Solve(*prog);
+    const std::chrono::duration<double> original_time = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    const drake_tutorials::LinearEqualityElimination elimination(*prog);
+    const std::chrono::duration<double> presolve_time = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+    const auto reduced = elimination.Solve();
+    const std::chrono::duration<double> reduced_time = std::chrono::steady_clock::now() - start;
+
+    print(prog->num_vars(), " variables, ", prog->linear_equality_constraints().size(),
+          " equalities -> ", elimination.reduced_prog().num_vars(), " variables, null-space ",
+          elimination.null_space().nonZeros(), " nonzeros");
+    print("  original: ", original.get_solver_id().name(), " ", original.get_solution_result(),
+          ", ", original_time.count(), " s");
+    print("  eliminated: ", reduced.get_solver_id().name(), " ", reduced.get_solution_result(),
+          ", presolve ", presolve_time.count(), " s + solve ", reduced_time.count(), " s");
+    if (original.is_success() && reduced.is_success()) {
+      print("  max |x difference| ",
+            (original.get_x_val() - reduced.get_x_val()).cwiseAbs().maxCoeff(),
+            ", cost difference ", reduced.get_optimal_cost() - original.get_optimal_cost(),
+            ", speedup ", original_time.count() / (presolve_time + reduced_time).count());
+    }
+  }
+  return 0;
+}
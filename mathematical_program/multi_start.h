@@ -0,0 +1,244 @@
+#pragma once
+
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+
+#include "solver_concurrency.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace drake_tutorials {
+
+enum class SamplingMethod { kUniform, kLatinHypercube, kSobol };
+
+namespace internal {
+
+// Sobol direction numbers (Joe & Kuo, new-joe-kuo-6.21201) for dimensions 2 to 10. The first
+// dimension is the van der Corput sequence and needs no entry.
+struct SobolPolynomial {
+  int s;
+  unsigned a;
+  std::array<std::uint32_t, 5> m;
+};
+constexpr std::array<SobolPolynomial, 9> kSobolPolynomials{{{1, 0, {1}},
+                                                            {2, 1, {1, 3}},
+                                                            {3, 1, {1, 3, 1}},
+                                                            {3, 2, {1, 1, 1}},
+                                                            {4, 1, {1, 1, 3, 3}},
+                                                            {4, 4, {1, 3, 5, 13}},
+                                                            {5, 2, {1, 1, 5, 5, 17}},
+                                                            {5, 4, {1, 1, 5, 5, 5}},
+                                                            {5, 7, {1, 1, 7, 11, 19}}}};
+
+inline std::array<std::uint32_t, 32> SobolDirections(int dimension) {
+  std::array<std::uint32_t, 32> v{};
+  if (dimension == 0) {
+    for (int k = 0; k < 32; ++k) {
+      v[k] = std::uint32_t{1} << (31 - k);
+    }
+    return v;
+  }
+  const SobolPolynomial& poly = kSobolPolynomials[dimension - 1];
+  for (int k = 0; k < 32; ++k) {
+    if (k < poly.s) {
+      v[k] = poly.m[k] << (31 - k);
+    } else {
+      v[k] = v[k - poly.s] ^ (v[k - poly.s] >> poly.s);
+      for (int l = 1; l < poly.s; ++l) {
+        if ((poly.a >> (poly.s - 1 - l)) & 1) {
+          v[k] ^= v[k - l];
+        }
+      }
+    }
+  }
+  return v;
+}
+
+}  // namespace internal
+
+// Returns `num_samples` points in the box [lower, upper], one per column.
+inline Eigen::MatrixXd SampleInitialGuesses(SamplingMethod method, int num_samples,
+                                            const Eigen::VectorXd& lower,
+                                            const Eigen::VectorXd& upper, std::mt19937* generator) {
+  const int dim = lower.size();
+  if (upper.size() != dim) {
+    throw std::invalid_argument("SampleInitialGuesses: lower and upper differ in size.");
+  }
+  std::uniform_real_distribution<double> unit(0, 1);
+  Eigen::MatrixXd unit_samples(dim, num_samples);
+  switch (method) {
+    case SamplingMethod::kUniform: {
+      for (int j = 0; j < num_samples; ++j) {
+        for (int i = 0; i < dim; ++i) {
+          unit_samples(i, j) = unit(*generator);
+        }
+      }
+      break;
+    }
+    case SamplingMethod::kLatinHypercube: {
+      // Every dimension gets one sample per stratum, in a random order.
+      std::vector<int> strata(num_samples);
+      for (int i = 0; i < dim; ++i) {
+        for (int j = 0; j < num_samples; ++j) {
+          strata[j] = j;
+        }
+        std::shuffle(strata.begin(), strata.end(), *generator);
+        for (int j = 0; j < num_samples; ++j) {
+          unit_samples(i, j) = (strata[j] + unit(*generator)) / num_samples;
+        }
+      }
+      break;
+    }
+    case SamplingMethod::kSobol: {
+      if (dim > static_cast<int>(internal::kSobolPolynomials.size()) + 1) {
+        throw std::invalid_argument("SampleInitialGuesses: Sobol sampling supports at most 10 "
+                                    "dimensions.");
+      }
+      std::vector<std::array<std::uint32_t, 32>> directions;
+      for (int i = 0; i < dim; ++i) {
+        directions.push_back(internal::SobolDirections(i));
+      }
+      // Gray-code construction; the all-zero first point is skipped.
+      std::vector<std::uint32_t> x(dim, 0);
+      for (int j = 0; j < num_samples; ++j) {
+        int c = 0;
+        for (std::uint32_t value = j; value & 1; value >>= 1) {
+          ++c;
+        }
+        for (int i = 0; i < dim; ++i) {
+          x[i] ^= directions[i][c];
+          unit_samples(i, j) = x[i] / 4294967296.0;
+        }
+      }
+      break;
+    }
+  }
+  return lower.replicate(1, num_samples) +
+         ((upper - lower).asDiagonal() * unit_samples).eval();
+}
+
+struct MultiStartOptions {
+  int num_starts{64};
+  SamplingMethod sampling{SamplingMethod::kSobol};
+  // The box the initial guesses are drawn from.
+  Eigen::VectorXd lower;
+  Eigen::VectorXd upper;
+  // A known lower bound on the optimal cost. Once a start reaches a cost within `tolerance` of it,
+  // the starts that have not begun yet are cancelled.
+  std::optional<double> known_bound;
+  double tolerance{1e-6};
+  std::optional<drake::solvers::SolverOptions> solver_options;
+  unsigned seed{0};
+};
+
+struct StartStatistics {
+  Eigen::VectorXd initial_guess;
+  // False if the start was cancelled before it was solved.
+  bool solved{false};
+  bool success{false};
+  double cost{std::numeric_limits<double>::infinity()};
+  // Number of Ipopt iterations, counted through a visualization callback.
+  int iterations{0};
+  double solve_time{0};
+};
+
+struct MultiStartResult {
+  // The successful result with the lowest cost, or the first solved result if none succeeded.
+  drake::solvers::MathematicalProgramResult best;
+  int best_start{-1};
+  std::vector<StartStatistics> starts;
+  int num_solved{0};
+  int num_cancelled{0};
+  double wall_time{0};
+};
+
+/*
+ * Solves `prog` with IpoptSolver from `options.num_starts` initial guesses on `pool`. Every worker
+ * solves its own clone of the program with its own IpoptSolver instance. The starts only run in
+ * parallel when `options.solver_options` select a reentrant Ipopt linear solver; see
+ * solver_concurrency.h.
+ */
+inline MultiStartResult SolveMultiStart(const drake::solvers::MathematicalProgram& prog,
+                                        const MultiStartOptions& options, ThreadPool* pool) {
+  const int n = options.num_starts;
+  std::mt19937 generator(options.seed);
+  const Eigen::MatrixXd guesses =
+      SampleInitialGuesses(options.sampling, n, options.lower, options.upper, &generator);
+
+  struct WorkerState {
+    std::unique_ptr<drake::solvers::MathematicalProgram> prog;
+    std::unique_ptr<drake::solvers::IpoptSolver> solver;
+    int iterations{0};
+  };
+  std::vector<WorkerState> states(pool->num_threads());
+  std::vector<drake::solvers::MathematicalProgramResult> results(n);
+  MultiStartResult output;
+  output.starts.resize(n);
+  std::atomic<bool> cancelled{false};
+
+  const auto start = std::chrono::steady_clock::now();
+  pool->ParallelFor(n, [&](int worker, int i) {
+    StartStatistics& stats = output.starts[i];
+    stats.initial_guess = guesses.col(i);
+    if (cancelled) {
+      return;
+    }
+    WorkerState& state = states[worker];
+    if (state.prog == nullptr) {
+      state.prog = prog.Clone();
+      state.prog->AddVisualizationCallback(
+          [&state](const Eigen::Ref<const Eigen::VectorXd>&) { ++state.iterations; },
+          state.prog->decision_variables());
+      state.solver = std::make_unique<drake::solvers::IpoptSolver>();
+    }
+    state.iterations = 0;
+    const auto solve_start = std::chrono::steady_clock::now();
+    SolveConcurrently(*state.solver, *state.prog, stats.initial_guess, options.solver_options,
+                      &results[i]);
+    const std::chrono::duration<double> solve_time = std::chrono::steady_clock::now() - solve_start;
+    stats.solved = true;
+    stats.success = results[i].is_success();
+    stats.cost = results[i].get_optimal_cost();
+    stats.iterations = state.iterations;
+    stats.solve_time = solve_time.count();
+    if (stats.success && options.known_bound.has_value() &&
+        stats.cost <= *options.known_bound + options.tolerance) {
+      cancelled = true;
+    }
+  });
+  const std::chrono::duration<double> wall_time = std::chrono::steady_clock::now() - start;
+
+  output.wall_time = wall_time.count();
+  for (int i = 0; i < n; ++i) {
+    const StartStatistics& stats = output.starts[i];
+    if (!stats.solved) {
+      ++output.num_cancelled;
+      continue;
+    }
+    ++output.num_solved;
+    const bool better = output.best_start < 0 ||
+                        (stats.success && !output.starts[output.best_start].success) ||
+                        (stats.success == output.starts[output.best_start].success &&
+                         stats.cost < output.starts[output.best_start].cost);
+    if (better) {
+      output.best_start = i;
+    }
+  }
+  if (output.best_start >= 0) {
+    output.best = results[output.best_start];
+  }
+  return output;
+}
+
+}  // namespace drake_tutorials
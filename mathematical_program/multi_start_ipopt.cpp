@@ -0,0 +1,82 @@
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+
+#include <gflags/gflags.h>
+
+#include "multi_start.h"
+#include "solver_concurrency.h"
+
+#include <iostream>
+
+DEFINE_int32(num_starts, 256, "Number of initial guesses.");
+DEFINE_int32(num_threads, 0, "Number of worker threads; 0 means one per hardware thread.");
+DEFINE_string(linear_solver, "mumps",
+              "Ipopt linear solver. The starts only run in parallel with a reentrant one (ma27, "
+              "ma57, ma77, ma86 or ma97), see solver_concurrency.h.");
+DEFINE_double(tolerance, 1e-6,
+              "Cancel the remaining starts once a cost this close to -100 is found.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+void PrintSummary(const std::string& name, const drake_tutorials::MultiStartResult& result) {
+  int num_success = 0;
+  int total_iterations = 0;
+  for (const auto& start : result.starts) {
+    num_success += start.success;
+    total_iterations += start.iterations;
+  }
+  print(name, ": ", result.num_solved, " solved, ", result.num_cancelled, " cancelled, ",
+        num_success, " successful, ", total_iterations, " Ipopt iterations, wall time ",
+        result.wall_time, " s");
+  if (result.best_start >= 0) {
+    const auto& best = result.starts[result.best_start];
+    print("  best start #", result.best_start, " from ", best.initial_guess.transpose(),
+          ": cost ", best.cost, ", x* = ", result.best.get_x_val().transpose());
+  }
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  const int num_threads = FLAGS_num_threads > 0 ? FLAGS_num_threads
+                                                : drake_tutorials::ThreadPool::DefaultNumThreads();
+
+  // The program of good_or_bad_initial_guess.cpp. Its global minimum is -100 at (0, +-10), while
+  // Ipopt stops at the stationary point (0, 0) without an initial guess.
+  auto prog = drake::solvers::MathematicalProgram();
+  auto x = prog.NewContinuousVariables(2);
+  prog.AddConstraint(pow(x[0], 2) + pow(x[1], 2) == 100.);
+  prog.AddCost(pow(x[0], 2) - pow(x[1], 2));
+
+  drake_tutorials::MultiStartOptions options;
+  options.num_starts = FLAGS_num_starts;
+  options.lower = Eigen::Vector2d(-10, -10);
+  options.upper = Eigen::Vector2d(10, 10);
+  drake::solvers::SolverOptions solver_options;
+  solver_options.SetOption(drake::solvers::IpoptSolver::id(), "print_level", 0);
+  solver_options.SetOption(drake::solvers::IpoptSolver::id(), "linear_solver",
+                           FLAGS_linear_solver);
+  options.solver_options = solver_options;
+  if (num_threads > 1 && !drake_tutorials::IpoptIsReentrant(solver_options)) {
+    print("linear_solver=", FLAGS_linear_solver, " is not reentrant, so the ", num_threads,
+          " workers solve one start at a time.");
+  }
+
+  drake_tutorials::ThreadPool pool(num_threads);
+  const std::vector<std::pair<std::string, drake_tutorials::SamplingMethod>> methods{
+      {"uniform", drake_tutorials::SamplingMethod::kUniform},
+      {"latin hypercube", drake_tutorials::SamplingMethod::kLatinHypercube},
+      {"sobol", drake_tutorials::SamplingMethod::kSobol}};
+  for (const auto& [name, method] : methods) {
+    options.sampling = method;
+    options.known_bound = std::nullopt;
+    PrintSummary(name + ", all starts", drake_tutorials::SolveMultiStart(prog, options, &pool));
+    options.known_bound = -100;
+    options.tolerance = FLAGS_tolerance;
+    PrintSummary(name + ", early cancellation",
+                 drake_tutorials::SolveMultiStart(prog, options, &pool));
+  }
+  return 0;
+}
@@ -0,0 +1,368 @@
+#pragma once
+
+#include <drake/common/eigen_types.h>
+#include <drake/common/symbolic/codegen.h>
+#include <drake/common/symbolic/expression.h>
+#include <drake/math/autodiff.h>
+#include <drake/math/autodiff_gradient.h>
+#include <drake/solvers/constraint.h>
+#include <drake/solvers/cost.h>
+#include <drake/solvers/mathematical_program.h>
+
+#include <dlfcn.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace drake_tutorials {
+
+/*
+ * A shared library compiled from C source by the system C compiler and loaded with dlopen().
+ *
+ * Libraries are cached in `cache_dir` under the hash of their source and compiler flags, so the
+ * compiler only runs the first time a source is seen. Flags that tune for the host ("=native")
+ * add the host CPU's model and feature flags to the hash, so a cache directory shared between
+ * machines never hands one machine a library built for another's instruction set. The cache may
+ * be shared between processes: a library is compiled under a name of its own and renamed into
+ * place, so other processes never load a partly written file.
+ */
+class NativeLibrary {
+ public:
+  NativeLibrary(const std::string& source, const std::string& flags = "-O2",
+                const std::string& cache_dir = DefaultCacheDirectory()) {
+    std::ostringstream name;
+    const std::string host =
+        flags.find("=native") != std::string::npos ? HostCpuSignature() + "\n" : "";
+    name << std::hex << std::hash<std::string>{}(flags + "\n" + host + source);
+    const std::filesystem::path directory(cache_dir);
+    const std::filesystem::path source_path = directory / (name.str() + ".c");
+    const std::filesystem::path library_path = directory / (name.str() + ".so");
+    if (!IsCached(source_path, library_path, source)) {
+      std::filesystem::create_directories(directory);
+      static std::atomic<int> counter{0};
+      const std::string suffix = "." + std::to_string(getpid()) + "." + std::to_string(counter++);
+      const std::filesystem::path temp_source = directory / (name.str() + suffix + ".c");
+      const std::filesystem::path temp_library = directory / (name.str() + suffix + ".so");
+      std::ofstream(temp_source) << source;
+      std::vector<std::string> args{"cc"};
+      std::istringstream flag_stream(flags);
+      for (std::string flag; flag_stream >> flag;) {
+        args.push_back(flag);
+      }
+      args.insert(args.end(),
+                  {"-fPIC", "-shared", "-o", temp_library.string(), temp_source.string(), "-lm"});
+      const bool compiled = RunCompiler(args);
+      std::error_code ignored;
+      if (!compiled) {
+        std::filesystem::remove(temp_source, ignored);
+        std::filesystem::remove(temp_library, ignored);
+        throw std::runtime_error("NativeLibrary: failed to compile " + source_path.string());
+      }
+      // The library first: a matching source next to an old library would be taken as cached.
+      std::filesystem::rename(temp_library, library_path);
+      std::filesystem::rename(temp_source, source_path);
+    }
+    handle_ = dlopen(library_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle_ == nullptr) {
+      throw std::runtime_error(std::string("NativeLibrary: ") + dlerror());
+    }
+    path_ = library_path.string();
+  }
+
+  NativeLibrary(const NativeLibrary&) = delete;
+  NativeLibrary& operator=(const NativeLibrary&) = delete;
+
+  ~NativeLibrary() { dlclose(handle_); }
+
+  static std::string DefaultCacheDirectory() {
+    return (std::filesystem::temp_directory_path() / "drake_tutorials_codegen").string();
+  }
+
+  // Returns the function `name` of the library.
+  template <typename Function>
+  Function Symbol(const std::string& name) const {
+    void* symbol = dlsym(handle_, name.c_str());
+    if (symbol == nullptr) {
+      throw std::runtime_error("NativeLibrary: " + path_ + " has no symbol " + name + ".");
+    }
+    return reinterpret_cast<Function>(symbol);
+  }
+
+ private:
+  // Runs the compiler with the arguments `args` (args[0] is looked up in PATH) without a shell.
+  // Returns whether it ran and exited with status 0.
+  static bool RunCompiler(const std::vector<std::string>& args) {
+    std::vector<char*> argv;
+    for (const std::string& arg : args) {
+      argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+    const pid_t pid = fork();
+    if (pid < 0) {
+      return false;
+    }
+    if (pid == 0) {
+      execvp(argv[0], argv.data());
+      _exit(127);
+    }
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0) {
+      if (errno != EINTR) {
+        return false;
+      }
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  }
+
+  // The "model name" and "flags" lines of /proc/cpuinfo, which is what -march=native resolves
+  // to. Empty where there is no /proc/cpuinfo.
+  static std::string HostCpuSignature() {
+    static const std::string signature = [] {
+      std::ifstream in("/proc/cpuinfo");
+      std::string model, features;
+      for (std::string line; std::getline(in, line) && (model.empty() || features.empty());) {
+        if (model.empty() && line.rfind("model name", 0) == 0) {
+          model = line;
+        } else if (features.empty() && line.rfind("flags", 0) == 0) {
+          features = line;
+        }
+      }
+      return model + "\n" + features;
+    }();
+    return signature;
+  }
+
+  static bool IsCached(const std::filesystem::path& source_path,
+                       const std::filesystem::path& library_path, const std::string& source) {
+    if (!std::filesystem::exists(library_path)) {
+      return false;
+    }
+    std::ifstream in(source_path);
+    std::stringstream cached;
+    cached << in.rdbuf();
+    return cached.str() == source;
+  }
+
+  void* handle_{nullptr};
+  std::string path_;
+};
+
+/*
+ * A vector function f(x) and its Jacobian, turned into native code.
+ *
+ * The expressions are printed as C with drake::symbolic::CodeGen() and compiled into a
+ * NativeLibrary.
+ */
+class NativeFunction {
+ public:
+  NativeFunction(const drake::VectorX<drake::symbolic::Expression>& f,
+                 const std::vector<drake::symbolic::Variable>& variables,
+                 const std::string& cache_dir = DefaultCacheDirectory())
+      : num_outputs_(f.size()), num_variables_(variables.size()) {
+    // One matrix [f, df/dx], so a single call returns the values and the Jacobian.
+    drake::MatrixX<drake::symbolic::Expression> f_and_jacobian(num_outputs_, 1 + num_variables_);
+    f_and_jacobian.col(0) = f;
+    if (num_variables_ > 0) {
+      f_and_jacobian.rightCols(num_variables_) = drake::symbolic::Jacobian(f, variables);
+    }
+    library_ = std::make_unique<NativeLibrary>(
+        drake::symbolic::CodeGen("f", variables, f_and_jacobian), "-O2", cache_dir);
+    function_ = library_->Symbol<Function>("f");
+  }
+
+  static std::string DefaultCacheDirectory() { return NativeLibrary::DefaultCacheDirectory(); }
+
+  int num_outputs() const { return num_outputs_; }
+  int num_variables() const { return num_variables_; }
+
+  // Writes f(x) followed by the column-major Jacobian into `out`, which must hold
+  // num_outputs() * (1 + num_variables()) doubles.
+  void Evaluate(const double* x, double* out) const { function_(x, out); }
+
+ private:
+  using Function = void (*)(const double*, double*);
+
+  int num_outputs_;
+  int num_variables_;
+  std::unique_ptr<NativeLibrary> library_;
+  Function function_{nullptr};
+};
+
+namespace internal {
+
+// Shared DoEval() implementations of NativeCost and NativeConstraint.
+class NativeEvaluation {
+ public:
+  NativeEvaluation(const drake::VectorX<drake::symbolic::Expression>& f,
+                   const std::vector<drake::symbolic::Variable>& variables,
+                   const std::string& cache_dir)
+      : f_(f), variables_(variables), function_(std::make_shared<NativeFunction>(f, variables,
+                                                                                 cache_dir)) {}
+
+  void Eval(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::VectorXd* y) const {
+    const double* out = Call(x.data());
+    *y = Eigen::Map<const Eigen::VectorXd>(out, f_.size());
+  }
+
+  void Eval(const Eigen::Ref<const drake::AutoDiffVecXd>& x, drake::AutoDiffVecXd* y) const {
+    const Eigen::VectorXd x_value = drake::math::ExtractValue(x);
+    const Eigen::MatrixXd x_gradient = drake::math::ExtractGradient(x);
+    const double* out = Call(x_value.data());
+    const int m = f_.size();
+    const Eigen::Map<const Eigen::MatrixXd> jacobian(out + m, m, variables_.size());
+    y->resize(m);
+    for (int i = 0; i < m; ++i) {
+      (*y)(i).value() = out[i];
+      (*y)(i).derivatives() = (jacobian.row(i) * x_gradient).transpose();
+    }
+  }
+
+  void Eval(const Eigen::Ref<const drake::VectorX<drake::symbolic::Variable>>& x,
+            drake::VectorX<drake::symbolic::Expression>* y) const {
+    drake::symbolic::Substitution substitution;
+    for (size_t i = 0; i < variables_.size(); ++i) {
+      substitution.emplace(variables_[i], x(i));
+    }
+    y->resize(f_.size());
+    for (int i = 0; i < f_.size(); ++i) {
+      (*y)(i) = f_(i).Substitute(substitution);
+    }
+  }
+
+  const drake::VectorX<drake::symbolic::Expression>& f() const { return f_; }
+  const std::vector<drake::symbolic::Variable>& variables() const { return variables_; }
+  const NativeFunction& function() const { return *function_; }
+
+ private:
+  // Evaluates into a per-thread buffer, so solver threads do not allocate per evaluation.
+  const double* Call(const double* x) const {
+    thread_local std::vector<double> buffer;
+    buffer.resize(function_->num_outputs() * (1 + function_->num_variables()));
+    function_->Evaluate(x, buffer.data());
+    return buffer.data();
+  }
+
+  drake::VectorX<drake::symbolic::Expression> f_;
+  std::vector<drake::symbolic::Variable> variables_;
+  std::shared_ptr<NativeFunction> function_;
+};
+
+inline std::vector<drake::symbolic::Variable> SortedVariables(
+    const drake::VectorX<drake::symbolic::Expression>& f) {
+  std::vector<drake::symbolic::Variable> variables;
+  drake::symbolic::Variables all;
+  for (int i = 0; i < f.size(); ++i) {
+    all += f(i).GetVariables();
+  }
+  for (const auto& variable : all) {
+    variables.push_back(variable);
+  }
+  return variables;
+}
+
+inline drake::solvers::VectorXDecisionVariable ToVector(
+    const std::vector<drake::symbolic::Variable>& variables) {
+  drake::solvers::VectorXDecisionVariable vector(variables.size());
+  for (size_t i = 0; i < variables.size(); ++i) {
+    vector(i) = variables[i];
+  }
+  return vector;
+}
+
+}  // namespace internal
+
+// A cost whose value and gradient are evaluated by generated native code.
+class NativeCost : public drake::solvers::Cost {
+ public:
+  NativeCost(const drake::symbolic::Expression& e,
+             const std::vector<drake::symbolic::Variable>& variables,
+             const std::string& cache_dir = NativeFunction::DefaultCacheDirectory())
+      : Cost(variables.size(), "native cost"),
+        evaluation_(drake::Vector1<drake::symbolic::Expression>(e), variables, cache_dir) {}
+
+  const drake::symbolic::Expression& expression() const { return evaluation_.f()(0); }
+  // The variables of the expression, in the order of the evaluator's inputs.
+  const std::vector<drake::symbolic::Variable>& variables() const {
+    return evaluation_.variables();
+  }
+
+ private:
+  void DoEval(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::VectorXd* y) const override {
+    evaluation_.Eval(x, y);
+  }
+  void DoEval(const Eigen::Ref<const drake::AutoDiffVecXd>& x,
+              drake::AutoDiffVecXd* y) const override {
+    evaluation_.Eval(x, y);
+  }
+  void DoEval(const Eigen::Ref<const drake::VectorX<drake::symbolic::Variable>>& x,
+              drake::VectorX<drake::symbolic::Expression>* y) const override {
+    evaluation_.Eval(x, y);
+  }
+
+  internal::NativeEvaluation evaluation_;
+};
+
+// A constraint lb <= f(x) <= ub whose values and Jacobian are evaluated by generated native code.
+class NativeConstraint : public drake::solvers::Constraint {
+ public:
+  NativeConstraint(const drake::VectorX<drake::symbolic::Expression>& f,
+                   const std::vector<drake::symbolic::Variable>& variables,
+                   const Eigen::Ref<const Eigen::VectorXd>& lb,
+                   const Eigen::Ref<const Eigen::VectorXd>& ub,
+                   const std::string& cache_dir = NativeFunction::DefaultCacheDirectory())
+      : Constraint(f.size(), variables.size(), lb, ub, "native constraint"),
+        evaluation_(f, variables, cache_dir) {}
+
+  const drake::VectorX<drake::symbolic::Expression>& expressions() const {
+    return evaluation_.f();
+  }
+  const std::vector<drake::symbolic::Variable>& variables() const {
+    return evaluation_.variables();
+  }
+
+ private:
+  void DoEval(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::VectorXd* y) const override {
+    evaluation_.Eval(x, y);
+  }
+  void DoEval(const Eigen::Ref<const drake::AutoDiffVecXd>& x,
+              drake::AutoDiffVecXd* y) const override {
+    evaluation_.Eval(x, y);
+  }
+  void DoEval(const Eigen::Ref<const drake::VectorX<drake::symbolic::Variable>>& x,
+              drake::VectorX<drake::symbolic::Expression>* y) const override {
+    evaluation_.Eval(x, y);
+  }
+
+  internal::NativeEvaluation evaluation_;
+};
+
+// Adds `e` as a natively evaluated cost, bound to the variables of `e`.
+inline drake::solvers::Binding<NativeCost> AddNativeCost(
+    drake::solvers::MathematicalProgram* prog, const drake::symbolic::Expression& e) {
+  const auto variables = internal::SortedVariables(drake::Vector1<drake::symbolic::Expression>(e));
+  return prog->AddCost(std::make_shared<NativeCost>(e, variables), internal::ToVector(variables));
+}
+
+// Adds lb <= f <= ub as a natively evaluated constraint, bound to the variables of `f`.
+inline drake::solvers::Binding<NativeConstraint> AddNativeConstraint(
+    drake::solvers::MathematicalProgram* prog,
+    const drake::VectorX<drake::symbolic::Expression>& f,
+    const Eigen::Ref<const Eigen::VectorXd>& lb, const Eigen::Ref<const Eigen::VectorXd>& ub) {
+  const auto variables = internal::SortedVariables(f);
+  return prog->AddConstraint(std::make_shared<NativeConstraint>(f, variables, lb, ub),
+                             internal::ToVector(variables));
+}
+
+}  // namespace drake_tutorials
@@ -0,0 +1,107 @@
+#include <drake/math/autodiff.h>
+#include <drake/solvers/constraint.h>
+#include <drake/solvers/cost.h>
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+
+#include <gflags/gflags.h>
+
+#include "native_evaluator.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <type_traits>
+
+DEFINE_int32(evaluations, 200000, "Number of evaluations per evaluator and scalar type.");
+DEFINE_int32(solves, 200, "Number of Ipopt solves per program.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+// Returns evaluations per second of `evaluator` at random points, with double or AutoDiffXd.
+template <typename T>
+double MeasureEvaluationRate(const drake::solvers::EvaluatorBase& evaluator) {
+  const Eigen::MatrixXd points = 10 * Eigen::MatrixXd::Random(evaluator.num_vars(), 64);
+  drake::VectorX<T> y;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < FLAGS_evaluations; ++i) {
+    const Eigen::VectorXd x = points.col(i % points.cols());
+    if constexpr (std::is_same_v<T, double>) {
+      evaluator.Eval(x, &y);
+    } else {
+      evaluator.Eval(drake::math::InitializeAutoDiff(x), &y);
+    }
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return FLAGS_evaluations / elapsed.count();
+}
+
+// Returns the mean Ipopt solve time in milliseconds.
+double MeasureSolveTime(const drake::solvers::MathematicalProgram& prog) {
+  drake::solvers::IpoptSolver solver;
+  drake::solvers::SolverOptions options;
+  options.SetOption(drake::solvers::IpoptSolver::id(), "print_level", 0);
+  drake::solvers::MathematicalProgramResult result;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < FLAGS_solves; ++i) {
+    solver.Solve(prog, Eigen::Vector2d(-5, 0), options, &result);
+  }
+  const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  print("  solution ", result.get_x_val().transpose(), ", cost ", result.get_optimal_cost());
+  return elapsed.count() / FLAGS_solves;
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  // The cost and constraint of good_or_bad_initial_guess.cpp.
+  drake::solvers::MathematicalProgram symbolic_prog;
+  auto x = symbolic_prog.NewContinuousVariables(2);
+  const drake::symbolic::Expression cost = pow(x[0], 2) - pow(x[1], 2);
+  const drake::symbolic::Expression circle = pow(x[0], 2) + pow(x[1], 2);
+  // AddCost() and AddConstraint() would parse the polynomials into a QuadraticCost and a
+  // QuadraticConstraint, so the expression evaluators are constructed explicitly.
+  const auto expression_cost = std::make_shared<drake::solvers::ExpressionCost>(cost);
+  const auto symbolic_cost = symbolic_prog.AddCost(expression_cost, expression_cost->vars());
+  const auto expression_constraint = std::make_shared<drake::solvers::ExpressionConstraint>(
+      drake::Vector1<drake::symbolic::Expression>(circle), drake::Vector1d(100),
+      drake::Vector1d(100));
+  const auto symbolic_constraint =
+      symbolic_prog.AddConstraint(expression_constraint, expression_constraint->vars());
+
+  // The same program with natively evaluated cost and constraint. Constructing them compiles the
+  // generated code, or loads it from the cache on later runs.
+  drake::solvers::MathematicalProgram native_prog;
+  native_prog.AddDecisionVariables(x);
+  const auto start = std::chrono::steady_clock::now();
+  const auto native_cost = drake_tutorials::AddNativeCost(&native_prog, cost);
+  const auto native_constraint = drake_tutorials::AddNativeConstraint(
+      &native_prog, drake::Vector1<drake::symbolic::Expression>(circle), drake::Vector1d(100),
+      drake::Vector1d(100));
+  const std::chrono::duration<double> setup = std::chrono::steady_clock::now() - start;
+  print("code generation and loading: ", setup.count(), " s");
+
+  const drake::solvers::EvaluatorBase* evaluators[2][2] = {
+      {symbolic_cost.evaluator().get(), symbolic_constraint.evaluator().get()},
+      {native_cost.evaluator().get(), native_constraint.evaluator().get()}};
+  const char* kinds[2] = {"symbolic", "native"};
+  for (int kind = 0; kind < 2; ++kind) {
+    for (const auto* evaluator : evaluators[kind]) {
+      print(kinds[kind], " ", evaluator->get_description(), ": ",
+            MeasureEvaluationRate<double>(*evaluator), " evaluations/s (double), ",
+            MeasureEvaluationRate<drake::AutoDiffXd>(*evaluator), " evaluations/s (AutoDiffXd)");
+    }
+  }
+
+  print("symbolic program:");
+  const double symbolic_time = MeasureSolveTime(symbolic_prog);
+  print("  ", symbolic_time, " ms per solve");
+  print("native program:");
+  const double native_time = MeasureSolveTime(native_prog);
+  print("  ", native_time, " ms per solve, speedup ", symbolic_time / native_time);
+  return 0;
+}
@@ -0,0 +1,464 @@
+#pragma once
+
+#include <drake/math/autodiff.h>
+#include <drake/math/autodiff_gradient.h>
+#include <drake/solvers/constraint.h>
+#include <drake/solvers/cost.h>
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/solve.h>
+
+#include "linear_equality_elimination.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace drake_tutorials {
+
+struct ProblemScalingOptions {
+  // Passes that divide by the geometric mean sqrt(max * min) of the magnitudes in each row and
+  // column, followed by passes that divide by the largest magnitude (Ruiz equilibration).
+  int geometric_passes{4};
+  int equilibration_passes{10};
+  // Bounds on every variable, constraint and cost factor.
+  double min_scale{1e-4};
+  double max_scale{1e4};
+};
+
+namespace internal {
+
+// s * f(x) with x = D z.
+class ScaledCost : public drake::solvers::Cost {
+ public:
+  ScaledCost(AffineSubstitution substitution, double scale)
+      : Cost(substitution.num_vars(), substitution.evaluator().get_description()),
+        substitution_(std::move(substitution)),
+        scale_(scale) {}
+
+ private:
+  template <typename X, typename Y>
+  void Scaled(const X& x, Y* y) const {
+    substitution_.Eval(x, y);
+    for (int i = 0; i < y->size(); ++i) {
+      (*y)(i) *= scale_;
+    }
+  }
+
+  void DoEval(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::VectorXd* y) const override {
+    Scaled(x, y);
+  }
+  void DoEval(const Eigen::Ref<const drake::AutoDiffVecXd>& x,
+              drake::AutoDiffVecXd* y) const override {
+    Scaled(x, y);
+  }
+  void DoEval(const Eigen::Ref<const drake::VectorX<drake::symbolic::Variable>>& x,
+              drake::VectorX<drake::symbolic::Expression>* y) const override {
+    Scaled(x, y);
+  }
+
+  AffineSubstitution substitution_;
+  double scale_;
+};
+
+// r .* g(x) with x = D z, within the bounds r .* lb and r .* ub.
+class ScaledConstraint : public drake::solvers::Constraint {
+ public:
+  ScaledConstraint(AffineSubstitution substitution, const Eigen::VectorXd& row_scale,
+                   const Eigen::VectorXd& lb, const Eigen::VectorXd& ub)
+      : Constraint(lb.size(), substitution.num_vars(), row_scale.cwiseProduct(lb),
+                   row_scale.cwiseProduct(ub), substitution.evaluator().get_description()),
+        substitution_(std::move(substitution)),
+        row_scale_(row_scale) {}
+
+ private:
+  template <typename X, typename Y>
+  void Scaled(const X& x, Y* y) const {
+    substitution_.Eval(x, y);
+    for (int i = 0; i < y->size(); ++i) {
+      (*y)(i) *= row_scale_(i);
+    }
+  }
+
+  void DoEval(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::VectorXd* y) const override {
+    Scaled(x, y);
+  }
+  void DoEval(const Eigen::Ref<const drake::AutoDiffVecXd>& x,
+              drake::AutoDiffVecXd* y) const override {
+    Scaled(x, y);
+  }
+  void DoEval(const Eigen::Ref<const drake::VectorX<drake::symbolic::Variable>>& x,
+              drake::VectorX<drake::symbolic::Expression>* y) const override {
+    Scaled(x, y);
+  }
+
+  AffineSubstitution substitution_;
+  Eigen::VectorXd row_scale_;
+};
+
+// A magnitude |value| at (row, col), where rows are constraint rows or, for the cost Hessian,
+// variables.
+struct Magnitude {
+  int row;
+  int col;
+  double value;
+};
+
+}  // namespace internal
+
+/*
+ * Presolve that rescales a program before handing it to the solver: x = D z for the variables,
+ * the constraint rows multiplied by r, and the cost by s, so that the entries of the constraint
+ * Jacobian and the cost Hessian are of similar magnitude.
+ *
+ * D and r come from the KKT matrix [H J'; J 0] with the Hessian H of the quadratic costs and the
+ * constraint Jacobian J, which is exact for linear constraints and evaluated at the initial guess
+ * for the others. A few geometric-mean passes bring entries spread over many orders
+ * of magnitude together, and Ruiz equilibration passes then bring the largest entry of every row
+ * and column of diag(D, r) [H J'; J 0] diag(D, r) close to one. As in OSQP, the cost factor s
+ * normalizes the larger of the mean column norm of D H D and the scaled gradient D grad f at the
+ * initial guess.
+ *
+ * Linear and quadratic costs and linear constraints stay linear and quadratic in z; bounding
+ * boxes become bounds on z; any other cost or constraint is wrapped in an evaluator that
+ * substitutes x and scales the output (see internal::AffineSubstitution). The solution is mapped
+ * back with x = D z, the cost divided by s, and every multiplier lambda = r lambda_scaled / s.
+ */
+class ProblemScaling {
+ public:
+  // Throws std::invalid_argument for programs with non-continuous variables or with costs or
+  // constraints other than generic, linear and quadratic ones, bounding boxes and linear
+  // (equality) constraints.
+  explicit ProblemScaling(const drake::solvers::MathematicalProgram& prog,
+                          const std::optional<Eigen::VectorXd>& initial_guess = std::nullopt,
+                          const ProblemScalingOptions& options = {})
+      : prog_(prog),
+        options_(options),
+        scaled_(std::make_unique<drake::solvers::MathematicalProgram>()) {
+    CheckSupported();
+    const int n = prog.num_vars();
+    for (int i = 0; i < n; ++i) {
+      if (prog.decision_variable(i).get_type() !=
+          drake::symbolic::Variable::Type::CONTINUOUS) {
+        throw std::invalid_argument("ProblemScaling: only continuous variables are supported.");
+      }
+    }
+    Eigen::VectorXd point = initial_guess.value_or(prog.initial_guess());
+    point = point.unaryExpr([](double v) { return std::isnan(v) ? 0.0 : v; });
+    ComputeScaling(point);
+    z_ = scaled_->NewContinuousVariables(n, "z");
+    BuildScaledProgram();
+    scaled_->SetInitialGuessForAllVariables(prog.initial_guess().cwiseQuotient(d_));
+  }
+
+  const drake::solvers::MathematicalProgram& scaled_prog() const { return *scaled_; }
+  // For adding visualization callbacks to the scaled program.
+  drake::solvers::MathematicalProgram* mutable_scaled_prog() { return scaled_.get(); }
+
+  // x = variable_scaling() .* z.
+  const Eigen::VectorXd& variable_scaling() const { return d_; }
+  // The factor of every constraint row: those of the linear constraints, then the linear
+  // equality, quadratic and generic constraints, each in program order.
+  const Eigen::VectorXd& constraint_scaling() const { return r_; }
+  double cost_scaling() const { return s_; }
+
+  Eigen::VectorXd Scale(const Eigen::Ref<const Eigen::VectorXd>& x) const {
+    return x.cwiseQuotient(d_);
+  }
+  Eigen::VectorXd Unscale(const Eigen::Ref<const Eigen::VectorXd>& z) const {
+    return z.cwiseProduct(d_);
+  }
+
+  // Solves the scaled program and returns the result in terms of the original program.
+  drake::solvers::MathematicalProgramResult Solve(
+      const std::optional<Eigen::VectorXd>& initial_guess = std::nullopt,
+      const std::optional<drake::solvers::SolverOptions>& solver_options = std::nullopt) const {
+    std::optional<Eigen::VectorXd> z_guess;
+    if (initial_guess) {
+      z_guess = Scale(*initial_guess);
+    }
+    return UnscaleResult(drake::solvers::Solve(*scaled_, z_guess, solver_options));
+  }
+
+  // Maps a result of scaled_prog(), e.g. from a solver chosen by the caller, back to the original
+  // program.
+  drake::solvers::MathematicalProgramResult UnscaleResult(
+      const drake::solvers::MathematicalProgramResult& scaled_result) const {
+    drake::solvers::MathematicalProgramResult result;
+    result.set_decision_variable_index(prog_.decision_variable_index());
+    result.set_x_val(Unscale(scaled_result.get_x_val()));
+    result.set_solution_result(scaled_result.get_solution_result());
+    result.set_optimal_cost(scaled_result.get_optimal_cost() / s_);
+    result.set_solver_id(scaled_result.get_solver_id());
+    for (const auto& pair : constraint_pairs_) {
+      try {
+        result.set_dual_solution(
+            pair.original,
+            scaled_result.GetDualSolution(pair.scaled).cwiseProduct(pair.dual_scale) / s_);
+      } catch (const std::exception&) {
+        // The solver does not report multipliers for this constraint.
+      }
+    }
+    return result;
+  }
+
+ private:
+  struct ConstraintPair {
+    drake::solvers::Binding<drake::solvers::Constraint> original;
+    drake::solvers::Binding<drake::solvers::Constraint> scaled;
+    // lambda = dual_scale .* lambda_scaled / s.
+    Eigen::VectorXd dual_scale;
+  };
+
+  void CheckSupported() const {
+    const size_t num_supported_costs = prog_.generic_costs().size() +
+                                       prog_.linear_costs().size() +
+                                       prog_.quadratic_costs().size();
+    const size_t num_supported_constraints =
+        prog_.generic_constraints().size() + prog_.quadratic_constraints().size() +
+        prog_.bounding_box_constraints().size() + prog_.linear_constraints().size() +
+        prog_.linear_equality_constraints().size();
+    if (prog_.GetAllCosts().size() != num_supported_costs ||
+        prog_.GetAllConstraints().size() != num_supported_constraints) {
+      throw std::invalid_argument(
+          "ProblemScaling: only generic, linear and quadratic costs and generic, quadratic, "
+          "bounding box and linear constraints are supported.");
+    }
+  }
+
+  // The constraints with a row factor, in the order in which the factors are stored in r_.
+  std::vector<drake::solvers::Binding<drake::solvers::Constraint>> RowScaledConstraints() const {
+    std::vector<drake::solvers::Binding<drake::solvers::Constraint>> constraints;
+    for (const auto& binding : prog_.linear_constraints()) {
+      constraints.emplace_back(binding);
+    }
+    for (const auto& binding : prog_.linear_equality_constraints()) {
+      constraints.emplace_back(binding);
+    }
+    for (const auto& binding : prog_.quadratic_constraints()) {
+      constraints.emplace_back(binding);
+    }
+    for (const auto& binding : prog_.generic_constraints()) {
+      constraints.emplace_back(binding);
+    }
+    return constraints;
+  }
+
+  // The Jacobian of the evaluator of `binding` at the program point `x`.
+  template <typename C>
+  Eigen::MatrixXd Jacobian(const drake::solvers::Binding<C>& binding,
+                           const Eigen::VectorXd& x) const {
+    const auto indices = prog_.FindDecisionVariableIndices(binding.variables());
+    Eigen::VectorXd x_binding(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+      x_binding(i) = x(indices[i]);
+    }
+    drake::AutoDiffVecXd y;
+    binding.evaluator()->Eval(drake::math::InitializeAutoDiff(x_binding), &y);
+    return drake::math::ExtractGradient(y, indices.size());
+  }
+
+  double Clamp(double scale) const {
+    return std::clamp(scale, options_.min_scale, options_.max_scale);
+  }
+
+  void ComputeScaling(const Eigen::VectorXd& point) {
+    const int n = prog_.num_vars();
+    std::vector<internal::Magnitude> hessian, jacobian;
+    for (const auto& binding : prog_.quadratic_costs()) {
+      const auto indices = prog_.FindDecisionVariableIndices(binding.variables());
+      const Eigen::MatrixXd& Q = binding.evaluator()->Q();
+      for (int i = 0; i < Q.rows(); ++i) {
+        for (int j = 0; j < Q.cols(); ++j) {
+          if (Q(i, j) != 0) {
+            hessian.push_back({indices[i], indices[j], std::abs(Q(i, j))});
+          }
+        }
+      }
+    }
+    int m = 0;
+    for (const auto& binding : RowScaledConstraints()) {
+      const auto indices = prog_.FindDecisionVariableIndices(binding.variables());
+      const Eigen::MatrixXd J = Jacobian(binding, point);
+      for (int i = 0; i < J.rows(); ++i) {
+        for (int j = 0; j < J.cols(); ++j) {
+          if (J(i, j) != 0) {
+            jacobian.push_back({m + i, indices[j], std::abs(J(i, j))});
+          }
+        }
+      }
+      m += J.rows();
+    }
+
+    d_ = Eigen::VectorXd::Ones(n);
+    r_ = Eigen::VectorXd::Ones(m);
+    const double kInf = std::numeric_limits<double>::infinity();
+    for (int pass = 0; pass < options_.geometric_passes + options_.equilibration_passes; ++pass) {
+      Eigen::VectorXd col_max = Eigen::VectorXd::Zero(n);
+      Eigen::VectorXd col_min = Eigen::VectorXd::Constant(n, kInf);
+      Eigen::VectorXd row_max = Eigen::VectorXd::Zero(m);
+      Eigen::VectorXd row_min = Eigen::VectorXd::Constant(m, kInf);
+      for (const auto& h : hessian) {
+        const double v = h.value * d_(h.row) * d_(h.col);
+        col_max(h.col) = std::max(col_max(h.col), v);
+        col_min(h.col) = std::min(col_min(h.col), v);
+      }
+      for (const auto& a : jacobian) {
+        const double v = a.value * r_(a.row) * d_(a.col);
+        col_max(a.col) = std::max(col_max(a.col), v);
+        col_min(a.col) = std::min(col_min(a.col), v);
+        row_max(a.row) = std::max(row_max(a.row), v);
+        row_min(a.row) = std::min(row_min(a.row), v);
+      }
+      const bool geometric = pass < options_.geometric_passes;
+      const auto norm = [geometric](double max, double min) {
+        return geometric ? std::sqrt(max * min) : max;
+      };
+      for (int j = 0; j < n; ++j) {
+        if (col_max(j) > 0) {
+          d_(j) = Clamp(d_(j) / std::sqrt(norm(col_max(j), col_min(j))));
+        }
+      }
+      for (int i = 0; i < m; ++i) {
+        if (row_max(i) > 0) {
+          r_(i) = Clamp(r_(i) / std::sqrt(norm(row_max(i), row_min(i))));
+        }
+      }
+    }
+
+    // The mean column norm of D H D and the scaled gradient D grad f at the point.
+    Eigen::VectorXd col_max = Eigen::VectorXd::Zero(n);
+    for (const auto& h : hessian) {
+      col_max(h.col) = std::max(col_max(h.col), h.value * d_(h.row) * d_(h.col));
+    }
+    Eigen::VectorXd gradient = Eigen::VectorXd::Zero(n);
+    for (const auto& binding : prog_.GetAllCosts()) {
+      const auto indices = prog_.FindDecisionVariableIndices(binding.variables());
+      const Eigen::MatrixXd J = Jacobian(binding, point);
+      for (size_t j = 0; j < indices.size(); ++j) {
+        gradient(indices[j]) += J(0, j);
+      }
+    }
+    const double norm =
+        n > 0 ? std::max(col_max.mean(), gradient.cwiseProduct(d_).cwiseAbs().maxCoeff()) : 0;
+    s_ = norm > 0 ? Clamp(1 / norm) : 1;
+  }
+
+  // x = D z for the variables of `binding`.
+  template <typename C>
+  internal::AffineRestriction Restrict(const drake::solvers::Binding<C>& binding) const {
+    const auto indices = prog_.FindDecisionVariableIndices(binding.variables());
+    internal::AffineRestriction restriction;
+    restriction.offset = Eigen::VectorXd::Zero(indices.size());
+    restriction.z.resize(indices.size());
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (size_t i = 0; i < indices.size(); ++i) {
+      triplets.emplace_back(i, i, d_(indices[i]));
+      restriction.z(i) = z_(indices[i]);
+    }
+    restriction.matrix.resize(indices.size(), indices.size());
+    restriction.matrix.setFromTriplets(triplets.begin(), triplets.end());
+    return restriction;
+  }
+
+  void BuildScaledProgram() {
+    for (const auto& binding : prog_.linear_costs()) {
+      const auto r = Restrict(binding);
+      const auto& cost = *binding.evaluator();
+      const Eigen::VectorXd d = r.matrix.diagonal();
+      scaled_->AddLinearCost(s_ * d.cwiseProduct(cost.a()), s_ * cost.b(), r.z);
+    }
+    for (const auto& binding : prog_.quadratic_costs()) {
+      const auto r = Restrict(binding);
+      const auto& cost = *binding.evaluator();
+      const Eigen::VectorXd d = r.matrix.diagonal();
+      const auto D = d.asDiagonal();
+      scaled_->AddQuadraticCost(s_ * (D * cost.Q() * D), s_ * (D * cost.b()), s_ * cost.c(),
+                                r.z);
+    }
+    for (const auto& binding : prog_.generic_costs()) {
+      auto r = Restrict(binding);
+      const auto z = r.z;
+      scaled_->AddCost(std::make_shared<internal::ScaledCost>(
+                           internal::AffineSubstitution(binding.evaluator(), std::move(r)), s_),
+                       z);
+    }
+
+    for (const auto& binding : prog_.bounding_box_constraints()) {
+      const auto r = Restrict(binding);
+      const auto& constraint = *binding.evaluator();
+      const Eigen::VectorXd d = r.matrix.diagonal();
+      constraint_pairs_.push_back(
+          {binding,
+           scaled_->AddBoundingBoxConstraint(constraint.lower_bound().cwiseQuotient(d),
+                                             constraint.upper_bound().cwiseQuotient(d), r.z),
+           d.cwiseInverse()});
+    }
+    int row = 0;
+    for (const auto& binding : prog_.linear_constraints()) {
+      const auto r = Restrict(binding);
+      const auto& constraint = *binding.evaluator();
+      const Eigen::VectorXd rows = r_.segment(row, constraint.num_constraints());
+      row += rows.size();
+      const Eigen::SparseMatrix<double> A =
+          rows.asDiagonal() * constraint.get_sparse_A() * r.matrix;
+      constraint_pairs_.push_back(
+          {binding,
+           scaled_->AddLinearConstraint(A, rows.cwiseProduct(constraint.lower_bound()),
+                                        rows.cwiseProduct(constraint.upper_bound()), r.z),
+           rows});
+    }
+    for (const auto& binding : prog_.linear_equality_constraints()) {
+      const auto r = Restrict(binding);
+      const auto& constraint = *binding.evaluator();
+      const Eigen::VectorXd rows = r_.segment(row, constraint.num_constraints());
+      row += rows.size();
+      const Eigen::SparseMatrix<double> A =
+          rows.asDiagonal() * constraint.get_sparse_A() * r.matrix;
+      constraint_pairs_.push_back(
+          {binding,
+           scaled_->AddLinearEqualityConstraint(A, rows.cwiseProduct(constraint.lower_bound()),
+                                                r.z),
+           rows});
+    }
+    std::vector<drake::solvers::Binding<drake::solvers::Constraint>> nonlinear;
+    for (const auto& binding : prog_.quadratic_constraints()) {
+      nonlinear.emplace_back(binding);
+    }
+    for (const auto& binding : prog_.generic_constraints()) {
+      nonlinear.emplace_back(binding);
+    }
+    for (const auto& binding : nonlinear) {
+      auto r = Restrict(binding);
+      const auto z = r.z;
+      const auto& constraint = *binding.evaluator();
+      const Eigen::VectorXd rows = r_.segment(row, constraint.num_constraints());
+      row += rows.size();
+      constraint_pairs_.push_back(
+          {binding,
+           scaled_->AddConstraint(
+               std::make_shared<internal::ScaledConstraint>(
+                   internal::AffineSubstitution(binding.evaluator(), std::move(r)), rows,
+                   constraint.lower_bound(), constraint.upper_bound()),
+               z),
+           rows});
+    }
+  }
+
+  const drake::solvers::MathematicalProgram& prog_;
+  ProblemScalingOptions options_;
+  std::unique_ptr<drake::solvers::MathematicalProgram> scaled_;
+  drake::solvers::VectorXDecisionVariable z_;
+  Eigen::VectorXd d_;
+  Eigen::VectorXd r_;
+  double s_{1};
+  // Every constraint of the original program, its counterpart in the scaled one and its
+  // multiplier factors.
+  std::vector<ConstraintPair> constraint_pairs_;
+};
+
+}  // namespace drake_tutorials
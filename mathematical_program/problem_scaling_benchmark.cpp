@@ -0,0 +1,137 @@
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+
+#include <gflags/gflags.h>
+
+#include "problem_scaling.h"
+#include "tutorial_programs.h"
+
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+DEFINE_double(spread, 1e3, "Factor by which the variables, constraints and costs are mis-scaled.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+/*
+ * The tutorial programs in badly scaled variables y with x = scale .* y, where
+ * scale = (spread, 1 / spread), every constraint multiplied by spread and every cost divided by
+ * spread. The solutions are those of MakeTutorialPrograms() divided by scale.
+ */
+std::vector<drake_tutorials::TutorialProgram> MakeBadlyScaledPrograms(
+    const Eigen::Vector2d& scale) {
+  const double row = scale(0);
+  const double cost = 1 / scale(0);
+  std::vector<drake_tutorials::TutorialProgram> programs;
+  const auto add = [&](const char* name, const std::optional<Eigen::VectorXd>& initial_guess,
+                       const auto& build) {
+    auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+    const auto y = prog->NewContinuousVariables(2, "y");
+    const drake::Vector2<drake::symbolic::Expression> x(scale(0) * y(0), scale(1) * y(1));
+    build(x, prog.get());
+    std::optional<Eigen::VectorXd> y_guess;
+    if (initial_guess) {
+      y_guess = initial_guess->cwiseQuotient(scale);
+    }
+    programs.push_back({name, std::move(prog), y_guess});
+  };
+  add("simple_optimization_problem_feasible", std::nullopt, [&](const auto& x, auto* prog) {
+    prog->AddConstraint(row * (x[0] + x[1]) == row);
+    prog->AddConstraint(row * x[0] <= row * x[1]);
+    prog->AddCost(cost * (pow(x[0], 2) + pow(x[1], 2)));
+  });
+  add("simple_optimization_problem_infeasible", std::nullopt, [&](const auto& x, auto* prog) {
+    prog->AddConstraint(row * (x[0] + x[1]) >= row);
+    prog->AddConstraint(row * (x[0] + x[1]) <= 0);
+    prog->AddCost(cost * x[0]);
+  });
+  add("manually_choosing_a_solver", Eigen::Vector2d(1, 1), [&](const auto& x, auto* prog) {
+    prog->AddConstraint(row * (x[0] + x[1]) == row);
+    prog->AddConstraint(0 <= row * x[1]);
+    prog->AddConstraint(row * x[1] <= row);
+    prog->AddCost(cost * x[0]);
+  });
+  add("good_or_bad_initial_guess", Eigen::Vector2d(-5, 0), [&](const auto& x, auto* prog) {
+    prog->AddConstraint(row * (pow(x[0], 2) + pow(x[1], 2)) == row * 100);
+    prog->AddCost(cost * (pow(x[0], 2) - pow(x[1], 2)));
+  });
+  add("add_callback", Eigen::Vector2d(4, 5), [&](const auto& x, auto* prog) {
+    prog->AddConstraint(row * x[0] * x[1] == row * 9);
+    prog->AddCost(cost * (pow(x[0], 2) + pow(x[1], 2)));
+  });
+  return programs;
+}
+
+struct Run {
+  drake::solvers::MathematicalProgramResult result;
+  int iterations{0};
+};
+
+// Solves with Ipopt, counting its iterations with a visualization callback. Returns the result
+// of `prog`, which is mapped through `scaling` if there is one.
+Run SolveCounting(drake::solvers::MathematicalProgram* prog,
+                  const std::optional<Eigen::VectorXd>& initial_guess,
+                  const drake::solvers::SolverOptions& options,
+                  const drake_tutorials::ProblemScaling* scaling = nullptr) {
+  Run run;
+  prog->AddVisualizationCallback(
+      [&run](const Eigen::Ref<const Eigen::VectorXd>&) { ++run.iterations; },
+      prog->decision_variables());
+  drake::solvers::IpoptSolver().Solve(*prog, initial_guess, options, &run.result);
+  if (scaling) {
+    run.result = scaling->UnscaleResult(run.result);
+  }
+  return run;
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  drake::solvers::SolverOptions options;
+  options.SetOption(drake::solvers::IpoptSolver::id(), "print_level", 0);
+  const Eigen::Vector2d scale(FLAGS_spread, 1 / FLAGS_spread);
+
+  auto references = drake_tutorials::MakeTutorialPrograms();
+  auto programs = MakeBadlyScaledPrograms(scale);
+  int regressions = 0;
+  for (size_t i = 0; i < programs.size(); ++i) {
+    auto& program = programs[i];
+    const Run reference =
+        SolveCounting(references[i].prog.get(), references[i].initial_guess, options);
+
+    drake_tutorials::ProblemScaling scaling(*program.prog, program.initial_guess);
+    std::optional<Eigen::VectorXd> z_guess;
+    if (program.initial_guess) {
+      z_guess = scaling.Scale(*program.initial_guess);
+    }
+    const Run scaled = SolveCounting(scaling.mutable_scaled_prog(), z_guess, options, &scaling);
+    const Run direct = SolveCounting(program.prog.get(), program.initial_guess, options);
+
+    print(program.name, ": variable scaling ", scaling.variable_scaling().transpose(),
+          ", constraint scaling ", scaling.constraint_scaling().transpose(), ", cost scaling ",
+          scaling.cost_scaling());
+    const auto report = [&](const char* label, const Run& run) {
+      std::cout << "  " << label << ": " << run.result.get_solution_result() << " after "
+                << run.iterations << " iterations";
+      if (run.result.is_success() && reference.result.is_success()) {
+        const Eigen::VectorXd x = run.result.get_x_val().cwiseProduct(scale);
+        std::cout << ", max |x difference| to the reference "
+                  << (x - reference.result.get_x_val()).cwiseAbs().maxCoeff();
+      }
+      std::cout << "\n";
+    };
+    report("badly scaled", direct);
+    report("ProblemScaling", scaled);
+    print("  reference: ", reference.result.get_solution_result(), " after ",
+          reference.iterations, " iterations");
+    regressions += reference.result.is_success() && !scaled.result.is_success();
+  }
+  print(regressions, " of ", programs.size(),
+        " programs solved by the reference but not after ProblemScaling");
+  return regressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,803 @@
+#pragma once
+
+#include <drake/common/symbolic/expression.h>
+#include <drake/solvers/choose_best_solver.h>
+#include <drake/solvers/constraint.h>
+#include <drake/solvers/cost.h>
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/mathematical_program_result.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace drake_tutorials {
+
+// Appends plain values and arrays to a byte string. Arrays are stored as their length followed
+// by the elements, starting at an 8-byte aligned offset.
+class ByteWriter {
+ public:
+  template <typename T>
+  void Put(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    bytes_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  void PutArray(const T* data, std::size_t size) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    Put<std::uint64_t>(size);
+    bytes_.resize((bytes_.size() + 7) & ~std::size_t{7});
+    bytes_.append(reinterpret_cast<const char*>(data), size * sizeof(T));
+  }
+
+  void PutVector(const Eigen::VectorXd& v) { PutArray(v.data(), v.size()); }
+  void PutString(const std::string& s) { PutArray(s.data(), s.size()); }
+
+  // Overwrites a value written earlier at byte `offset`.
+  template <typename T>
+  void PutAt(std::size_t offset, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    std::memcpy(bytes_.data() + offset, &value, sizeof(T));
+  }
+
+  std::size_t size() const { return bytes_.size(); }
+  const std::string& bytes() const { return bytes_; }
+  std::string Release() { return std::move(bytes_); }
+
+ private:
+  std::string bytes_;
+};
+
+// An array inside the input of a ByteReader, viewed in place.
+template <typename T>
+struct ArrayView {
+  const T* data{nullptr};
+  std::size_t size{0};
+};
+
+// Reads what a ByteWriter wrote. Throws std::runtime_error when the input ends early.
+class ByteReader {
+ public:
+  ByteReader(const char* data, std::size_t size) : data_(data), size_(size) {}
+  explicit ByteReader(const std::string& bytes) : ByteReader(bytes.data(), bytes.size()) {}
+
+  template <typename T>
+  T Get() {
+    static_assert(std::is_trivially_copyable_v<T>);
+    T value;
+    std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  template <typename T>
+  std::vector<T> GetArray() {
+    const std::size_t size = GetArraySize(sizeof(T));
+    std::vector<T> values(size);
+    if (size > 0) {
+      std::memcpy(values.data(), Take(size * sizeof(T)), size * sizeof(T));
+    }
+    return values;
+  }
+
+  Eigen::VectorXd GetVector() {
+    const std::size_t size = GetArraySize(sizeof(double));
+    Eigen::VectorXd v(size);
+    if (size > 0) {
+      std::memcpy(v.data(), Take(size * sizeof(double)), size * sizeof(double));
+    }
+    return v;
+  }
+
+  std::string GetString() {
+    const std::size_t size = GetArraySize(1);
+    return std::string(Take(size), size);
+  }
+
+  // Returns an array without copying it. The view points into the input, which must therefore
+  // outlive it, and requires the input to start at an 8-byte aligned address.
+  template <typename T>
+  ArrayView<T> GetArrayView() {
+    static_assert(std::is_trivially_copyable_v<T> && alignof(T) <= 8);
+    ArrayView<T> view;
+    view.size = GetArraySize(sizeof(T));
+    const char* p = Take(view.size * sizeof(T));
+    if (reinterpret_cast<std::uintptr_t>(p) % alignof(T) != 0) {
+      throw std::runtime_error("ByteReader: misaligned array; the input must be 8-byte aligned.");
+    }
+    view.data = reinterpret_cast<const T*>(p);
+    return view;
+  }
+
+  void Skip(std::size_t n) { Take(n); }
+
+  std::size_t position() const { return position_; }
+  std::size_t size() const { return size_; }
+  bool done() const { return position_ == size_; }
+
+ private:
+  // Reads an array length and skips the alignment padding in front of the elements.
+  std::size_t GetArraySize(std::size_t element_size) {
+    const auto size = Get<std::uint64_t>();
+    Take(((position_ + 7) & ~std::size_t{7}) - position_);
+    if (element_size > 0 && size > (size_ - position_) / element_size) {
+      throw std::runtime_error("ByteReader: array runs past the end of the input.");
+    }
+    return size;
+  }
+
+  const char* Take(std::size_t n) {
+    if (n > size_ - position_) {
+      throw std::runtime_error("ByteReader: unexpected end of input.");
+    }
+    const char* p = data_ + position_;
+    position_ += n;
+    return p;
+  }
+
+  const char* data_;
+  std::size_t size_;
+  std::size_t position_{0};
+};
+
+// Version of the encoding written by EncodeProgram(). Decoders reject other versions.
+constexpr std::uint32_t kProgramEncodingVersion = 1;
+
+namespace internal {
+
+// Tags of the encoded expression nodes. They are spelled out instead of casting
+// drake::symbolic::ExpressionKind, so the encoding does not depend on Drake's enum order.
+enum class ExpressionTag : std::uint8_t {
+  kConstant = 1, kVariable, kAdd, kMul,
+  kDiv, kPow, kAtan2, kMin, kMax,
+  kLog, kAbs, kExp, kSqrt, kSin, kCos, kTan, kAsin, kAcos, kAtan, kSinh, kCosh, kTanh, kCeil,
+  kFloor,
+};
+
+enum class CostTag : std::uint8_t { kLinear = 1, kQuadratic, kExpression };
+enum class ConstraintTag : std::uint8_t {
+  kBoundingBox = 1, kLinear, kLinearEquality, kExpression, kQuadratic,
+};
+
+struct UnaryFunction {
+  drake::symbolic::ExpressionKind kind;
+  ExpressionTag tag;
+  drake::symbolic::Expression (*apply)(const drake::symbolic::Expression&);
+};
+
+struct BinaryFunction {
+  drake::symbolic::ExpressionKind kind;
+  ExpressionTag tag;
+  drake::symbolic::Expression (*apply)(const drake::symbolic::Expression&,
+                                       const drake::symbolic::Expression&);
+};
+
+inline const std::vector<UnaryFunction>& UnaryFunctions() {
+  using drake::symbolic::Expression;
+  using Kind = drake::symbolic::ExpressionKind;
+  static const std::vector<UnaryFunction> functions{
+      {Kind::Log, ExpressionTag::kLog, [](const Expression& a) { return log(a); }},
+      {Kind::Abs, ExpressionTag::kAbs, [](const Expression& a) { return abs(a); }},
+      {Kind::Exp, ExpressionTag::kExp, [](const Expression& a) { return exp(a); }},
+      {Kind::Sqrt, ExpressionTag::kSqrt, [](const Expression& a) { return sqrt(a); }},
+      {Kind::Sin, ExpressionTag::kSin, [](const Expression& a) { return sin(a); }},
+      {Kind::Cos, ExpressionTag::kCos, [](const Expression& a) { return cos(a); }},
+      {Kind::Tan, ExpressionTag::kTan, [](const Expression& a) { return tan(a); }},
+      {Kind::Asin, ExpressionTag::kAsin, [](const Expression& a) { return asin(a); }},
+      {Kind::Acos, ExpressionTag::kAcos, [](const Expression& a) { return acos(a); }},
+      {Kind::Atan, ExpressionTag::kAtan, [](const Expression& a) { return atan(a); }},
+      {Kind::Sinh, ExpressionTag::kSinh, [](const Expression& a) { return sinh(a); }},
+      {Kind::Cosh, ExpressionTag::kCosh, [](const Expression& a) { return cosh(a); }},
+      {Kind::Tanh, ExpressionTag::kTanh, [](const Expression& a) { return tanh(a); }},
+      {Kind::Ceil, ExpressionTag::kCeil, [](const Expression& a) { return ceil(a); }},
+      {Kind::Floor, ExpressionTag::kFloor, [](const Expression& a) { return floor(a); }},
+  };
+  return functions;
+}
+
+inline const std::vector<BinaryFunction>& BinaryFunctions() {
+  using drake::symbolic::Expression;
+  using Kind = drake::symbolic::ExpressionKind;
+  static const std::vector<BinaryFunction> functions{
+      {Kind::Div, ExpressionTag::kDiv,
+       [](const Expression& a, const Expression& b) { return a / b; }},
+      {Kind::Pow, ExpressionTag::kPow,
+       [](const Expression& a, const Expression& b) { return pow(a, b); }},
+      {Kind::Atan2, ExpressionTag::kAtan2,
+       [](const Expression& a, const Expression& b) { return atan2(a, b); }},
+      {Kind::Min, ExpressionTag::kMin,
+       [](const Expression& a, const Expression& b) { return min(a, b); }},
+      {Kind::Max, ExpressionTag::kMax,
+       [](const Expression& a, const Expression& b) { return max(a, b); }},
+  };
+  return functions;
+}
+
+// Writes expressions over the decision variables of `prog`. Variables are stored by their index
+// in the program.
+class ExpressionEncoder {
+ public:
+  ExpressionEncoder(const drake::solvers::MathematicalProgram& prog, ByteWriter* writer)
+      : prog_(prog), writer_(writer) {}
+
+  void Encode(const drake::symbolic::Expression& e) {
+    namespace sym = drake::symbolic;
+    using Kind = sym::ExpressionKind;
+    const Kind kind = e.get_kind();
+    switch (kind) {
+      case Kind::Constant:
+        PutTag(ExpressionTag::kConstant);
+        writer_->Put<double>(sym::get_constant_value(e));
+        return;
+      case Kind::Var:
+        PutTag(ExpressionTag::kVariable);
+        writer_->Put<std::uint32_t>(prog_.FindDecisionVariableIndex(sym::get_variable(e)));
+        return;
+      case Kind::Add:
+        PutTag(ExpressionTag::kAdd);
+        writer_->Put<double>(sym::get_constant_in_addition(e));
+        writer_->Put<std::uint32_t>(sym::get_expr_to_coeff_map_in_addition(e).size());
+        for (const auto& [term, coefficient] : sym::get_expr_to_coeff_map_in_addition(e)) {
+          Encode(term);
+          writer_->Put<double>(coefficient);
+        }
+        return;
+      case Kind::Mul:
+        PutTag(ExpressionTag::kMul);
+        writer_->Put<double>(sym::get_constant_in_multiplication(e));
+        writer_->Put<std::uint32_t>(sym::get_base_to_exponent_map_in_multiplication(e).size());
+        for (const auto& [base, exponent] : sym::get_base_to_exponent_map_in_multiplication(e)) {
+          Encode(base);
+          Encode(exponent);
+        }
+        return;
+      default:
+        break;
+    }
+    for (const auto& function : UnaryFunctions()) {
+      if (function.kind == kind) {
+        PutTag(function.tag);
+        Encode(sym::get_argument(e));
+        return;
+      }
+    }
+    for (const auto& function : BinaryFunctions()) {
+      if (function.kind == kind) {
+        PutTag(function.tag);
+        Encode(sym::get_first_argument(e));
+        Encode(sym::get_second_argument(e));
+        return;
+      }
+    }
+    throw std::invalid_argument("EncodeProgram: cannot encode the expression " + e.to_string());
+  }
+
+ private:
+  void PutTag(ExpressionTag tag) { writer_->Put<std::uint8_t>(static_cast<std::uint8_t>(tag)); }
+
+  const drake::solvers::MathematicalProgram& prog_;
+  ByteWriter* writer_;
+};
+
+// Reads expressions written by ExpressionEncoder, with `variables` in program order.
+class ExpressionDecoder {
+ public:
+  ExpressionDecoder(const drake::solvers::VectorXDecisionVariable& variables, ByteReader* reader)
+      : variables_(variables), reader_(reader) {}
+
+  drake::symbolic::Expression Decode() {
+    using drake::symbolic::Expression;
+    const auto tag = static_cast<ExpressionTag>(reader_->Get<std::uint8_t>());
+    switch (tag) {
+      case ExpressionTag::kConstant:
+        return reader_->Get<double>();
+      case ExpressionTag::kVariable: {
+        const auto index = reader_->Get<std::uint32_t>();
+        if (index >= static_cast<std::uint32_t>(variables_.size())) {
+          throw std::runtime_error("DecodeProgram: variable index out of range.");
+        }
+        return variables_(index);
+      }
+      case ExpressionTag::kAdd: {
+        Expression sum = reader_->Get<double>();
+        const auto num_terms = reader_->Get<std::uint32_t>();
+        for (std::uint32_t i = 0; i < num_terms; ++i) {
+          const Expression term = Decode();
+          sum += reader_->Get<double>() * term;
+        }
+        return sum;
+      }
+      case ExpressionTag::kMul: {
+        Expression product = reader_->Get<double>();
+        const auto num_factors = reader_->Get<std::uint32_t>();
+        for (std::uint32_t i = 0; i < num_factors; ++i) {
+          const Expression base = Decode();
+          product = product * pow(base, Decode());
+        }
+        return product;
+      }
+      default:
+        break;
+    }
+    for (const auto& function : UnaryFunctions()) {
+      if (function.tag == tag) {
+        return function.apply(Decode());
+      }
+    }
+    for (const auto& function : BinaryFunctions()) {
+      if (function.tag == tag) {
+        const Expression first = Decode();
+        return function.apply(first, Decode());
+      }
+    }
+    throw std::runtime_error("DecodeProgram: unknown expression tag " +
+                             std::to_string(static_cast<int>(tag)) + ".");
+  }
+
+ private:
+  const drake::solvers::VectorXDecisionVariable& variables_;
+  ByteReader* reader_;
+};
+
+// Every cost and constraint is a record: its tag, the byte length of its body, and the body.
+// The length lets readers skip records without parsing them.
+template <typename Tag>
+std::size_t BeginRecord(Tag tag, ByteWriter* writer) {
+  writer->Put<std::uint8_t>(static_cast<std::uint8_t>(tag));
+  const std::size_t length_offset = writer->size();
+  writer->Put<std::uint64_t>(0);
+  return length_offset;
+}
+
+inline void EndRecord(std::size_t length_offset, ByteWriter* writer) {
+  writer->PutAt<std::uint64_t>(length_offset,
+                               writer->size() - length_offset - sizeof(std::uint64_t));
+}
+
+// Reads the length of a record body and returns the position where the body ends.
+inline std::size_t GetRecordEnd(ByteReader* reader) {
+  const auto length = reader->Get<std::uint64_t>();
+  if (length > reader->size() - reader->position()) {
+    throw std::runtime_error("DecodeProgram: record runs past the end of the input.");
+  }
+  return reader->position() + length;
+}
+
+inline void CheckRecordEnd(std::size_t record_end, const ByteReader& reader) {
+  if (reader.position() != record_end) {
+    throw std::runtime_error("DecodeProgram: record length does not match its contents.");
+  }
+}
+
+template <typename C>
+void PutVariables(const drake::solvers::MathematicalProgram& prog,
+                  const drake::solvers::Binding<C>& binding, ByteWriter* writer) {
+  const std::vector<int> indices = prog.FindDecisionVariableIndices(binding.variables());
+  writer->PutArray(indices.data(), indices.size());
+}
+
+// Reads a variable type written as one byte, rejecting values that name no type.
+inline drake::symbolic::Variable::Type GetVariableType(ByteReader* reader) {
+  using Type = drake::symbolic::Variable::Type;
+  const auto type = reader->Get<std::uint8_t>();
+  if (type > static_cast<std::uint8_t>(Type::RANDOM_EXPONENTIAL)) {
+    throw std::runtime_error("DecodeProgram: unknown variable type " + std::to_string(type) +
+                             ".");
+  }
+  return static_cast<Type>(type);
+}
+
+inline drake::solvers::VectorXDecisionVariable GetVariables(
+    const drake::solvers::VectorXDecisionVariable& variables, ByteReader* reader) {
+  const std::vector<int> indices = reader->GetArray<int>();
+  drake::solvers::VectorXDecisionVariable bound(indices.size());
+  for (std::size_t i = 0; i < indices.size(); ++i) {
+    if (indices[i] < 0 || indices[i] >= variables.size()) {
+      throw std::runtime_error("DecodeProgram: variable index out of range.");
+    }
+    bound(i) = variables(indices[i]);
+  }
+  return bound;
+}
+
+// Stores a sparse matrix in compressed column form.
+inline void PutSparse(const Eigen::SparseMatrix<double>& A, ByteWriter* writer) {
+  Eigen::SparseMatrix<double> compressed;
+  const Eigen::SparseMatrix<double>* matrix = &A;
+  if (!A.isCompressed()) {
+    compressed = A;
+    compressed.makeCompressed();
+    matrix = &compressed;
+  }
+  writer->Put<std::int32_t>(matrix->rows());
+  writer->Put<std::int32_t>(matrix->cols());
+  writer->PutArray(matrix->outerIndexPtr(), matrix->cols() + 1);
+  writer->PutArray(matrix->innerIndexPtr(), matrix->nonZeros());
+  writer->PutArray(matrix->valuePtr(), matrix->nonZeros());
+}
+
+// Whether `outer` (cols + 1 entries) and `inner` (nnz entries) form a valid compressed column
+// structure of a rows x cols matrix: column starts that begin at 0, never decrease and end at nnz,
+// and row indices in range and strictly increasing within every column, as Eigen requires.
+inline bool IsCompressedColumnStructure(std::int32_t rows, std::int32_t cols, const int* outer,
+                                        std::size_t outer_size, const int* inner,
+                                        std::size_t nnz) {
+  if (rows < 0 || cols < 0 || outer_size != static_cast<std::size_t>(cols) + 1 ||
+      outer[0] != 0 || static_cast<std::size_t>(outer[cols]) != nnz) {
+    return false;
+  }
+  for (std::int32_t j = 0; j < cols; ++j) {
+    if (outer[j + 1] < outer[j]) {
+      return false;
+    }
+    for (int k = outer[j]; k < outer[j + 1]; ++k) {
+      if (inner[k] < 0 || inner[k] >= rows || (k > outer[j] && inner[k] <= inner[k - 1])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+inline Eigen::SparseMatrix<double> GetSparse(ByteReader* reader) {
+  const auto rows = reader->Get<std::int32_t>();
+  const auto cols = reader->Get<std::int32_t>();
+  const auto outer = reader->GetArray<int>();
+  const auto inner = reader->GetArray<int>();
+  const auto values = reader->GetArray<double>();
+  if (inner.size() != values.size() ||
+      !IsCompressedColumnStructure(rows, cols, outer.data(), outer.size(), inner.data(),
+                                   inner.size())) {
+    throw std::runtime_error("DecodeProgram: malformed sparse matrix.");
+  }
+  return Eigen::Map<const Eigen::SparseMatrix<double>>(rows, cols, values.size(), outer.data(),
+                                                       inner.data(), values.data());
+}
+
+// The constraints of `prog` in the order of EncodeProgram()'s constraint records, which
+// DecodeProgram() preserves.
+inline std::vector<drake::solvers::Binding<drake::solvers::Constraint>> EncodedConstraints(
+    const drake::solvers::MathematicalProgram& prog) {
+  std::vector<drake::solvers::Binding<drake::solvers::Constraint>> constraints;
+  const auto append = [&](const auto& bindings) {
+    for (const auto& binding : bindings) {
+      constraints.emplace_back(binding.evaluator(), binding.variables());
+    }
+  };
+  append(prog.bounding_box_constraints());
+  append(prog.linear_constraints());
+  append(prog.linear_equality_constraints());
+  append(prog.quadratic_constraints());
+  append(prog.generic_constraints());
+  return constraints;
+}
+
+}  // namespace internal
+
+/*
+ * Appends a compact binary encoding of `prog` to `writer`: its decision variables with their
+ * types, its initial guess, linear and quadratic costs, bounding box, linear and quadratic
+ * constraints (with sparse matrices), and expression costs and constraints as expression trees
+ * over variable indices. Throws std::invalid_argument for any other cost or constraint type, so a
+ * program is never encoded with bindings missing. Visualization callbacks are not encoded.
+ *
+ * Layout: kProgramEncodingVersion, the variables, the initial guess, then the number of costs and
+ * the cost records, then the number of constraints and the constraint records.
+ */
+inline void EncodeProgram(const drake::solvers::MathematicalProgram& prog, ByteWriter* writer) {
+  using internal::ConstraintTag;
+  using internal::CostTag;
+  if (!prog.lorentz_cone_constraints().empty() ||
+      !prog.rotated_lorentz_cone_constraints().empty() ||
+      !prog.positive_semidefinite_constraints().empty() ||
+      !prog.linear_matrix_inequality_constraints().empty() ||
+      !prog.exponential_cone_constraints().empty() ||
+      !prog.linear_complementarity_constraints().empty()) {
+    throw std::invalid_argument("EncodeProgram: conic and complementarity constraints are not "
+                                "supported.");
+  }
+  const std::size_t num_costs =
+      prog.linear_costs().size() + prog.quadratic_costs().size() + prog.generic_costs().size();
+  const std::size_t num_constraints =
+      prog.bounding_box_constraints().size() + prog.linear_constraints().size() +
+      prog.linear_equality_constraints().size() + prog.generic_constraints().size() +
+      prog.quadratic_constraints().size();
+  if (prog.GetAllCosts().size() != num_costs ||
+      prog.GetAllConstraints().size() != num_constraints) {
+    throw std::invalid_argument(
+        "EncodeProgram: only linear, quadratic and expression costs and bounding box, linear, "
+        "quadratic and expression constraints are supported.");
+  }
+  writer->Put<std::uint32_t>(kProgramEncodingVersion);
+  writer->Put<std::uint32_t>(prog.num_vars());
+  for (int i = 0; i < prog.num_vars(); ++i) {
+    const auto& variable = prog.decision_variable(i);
+    writer->Put<std::uint8_t>(static_cast<std::uint8_t>(variable.get_type()));
+    writer->PutString(variable.get_name());
+  }
+  writer->PutVector(prog.initial_guess());
+  internal::ExpressionEncoder expressions(prog, writer);
+
+  writer->Put<std::uint32_t>(num_costs);
+  for (const auto& binding : prog.linear_costs()) {
+    const std::size_t record = internal::BeginRecord(CostTag::kLinear, writer);
+    internal::PutVariables(prog, binding, writer);
+    writer->PutVector(binding.evaluator()->a());
+    writer->Put<double>(binding.evaluator()->b());
+    internal::EndRecord(record, writer);
+  }
+  for (const auto& binding : prog.quadratic_costs()) {
+    const std::size_t record = internal::BeginRecord(CostTag::kQuadratic, writer);
+    internal::PutVariables(prog, binding, writer);
+    internal::PutSparse(binding.evaluator()->Q().sparseView(), writer);
+    writer->PutVector(binding.evaluator()->b());
+    writer->Put<double>(binding.evaluator()->c());
+    internal::EndRecord(record, writer);
+  }
+  for (const auto& binding : prog.generic_costs()) {
+    const auto cost =
+        std::dynamic_pointer_cast<drake::solvers::ExpressionCost>(binding.evaluator());
+    if (cost == nullptr) {
+      throw std::invalid_argument("EncodeProgram: cannot encode the cost " + binding.to_string());
+    }
+    const std::size_t record = internal::BeginRecord(CostTag::kExpression, writer);
+    expressions.Encode(cost->expression());
+    internal::EndRecord(record, writer);
+  }
+
+  writer->Put<std::uint32_t>(num_constraints);
+  for (const auto& binding : prog.bounding_box_constraints()) {
+    const std::size_t record = internal::BeginRecord(ConstraintTag::kBoundingBox, writer);
+    internal::PutVariables(prog, binding, writer);
+    writer->PutVector(binding.evaluator()->lower_bound());
+    writer->PutVector(binding.evaluator()->upper_bound());
+    internal::EndRecord(record, writer);
+  }
+  for (const auto& binding : prog.linear_constraints()) {
+    const std::size_t record = internal::BeginRecord(ConstraintTag::kLinear, writer);
+    internal::PutVariables(prog, binding, writer);
+    internal::PutSparse(binding.evaluator()->get_sparse_A(), writer);
+    writer->PutVector(binding.evaluator()->lower_bound());
+    writer->PutVector(binding.evaluator()->upper_bound());
+    internal::EndRecord(record, writer);
+  }
+  for (const auto& binding : prog.linear_equality_constraints()) {
+    const std::size_t record = internal::BeginRecord(ConstraintTag::kLinearEquality, writer);
+    internal::PutVariables(prog, binding, writer);
+    internal::PutSparse(binding.evaluator()->get_sparse_A(), writer);
+    writer->PutVector(binding.evaluator()->upper_bound());
+    internal::EndRecord(record, writer);
+  }
+  for (const auto& binding : prog.quadratic_constraints()) {
+    const std::size_t record = internal::BeginRecord(ConstraintTag::kQuadratic, writer);
+    internal::PutVariables(prog, binding, writer);
+    internal::PutSparse(binding.evaluator()->Q().sparseView(), writer);
+    writer->PutVector(binding.evaluator()->b());
+    writer->Put<double>(binding.evaluator()->lower_bound()(0));
+    writer->Put<double>(binding.evaluator()->upper_bound()(0));
+    internal::EndRecord(record, writer);
+  }
+  for (const auto& binding : prog.generic_constraints()) {
+    const auto constraint =
+        std::dynamic_pointer_cast<drake::solvers::ExpressionConstraint>(binding.evaluator());
+    if (constraint == nullptr) {
+      throw std::invalid_argument("EncodeProgram: cannot encode the constraint " +
+                                  binding.to_string());
+    }
+    const std::size_t record = internal::BeginRecord(ConstraintTag::kExpression, writer);
+    writer->Put<std::uint32_t>(constraint->expressions().size());
+    for (int i = 0; i < constraint->expressions().size(); ++i) {
+      expressions.Encode(constraint->expressions()(i));
+    }
+    writer->PutVector(constraint->lower_bound());
+    writer->PutVector(constraint->upper_bound());
+    internal::EndRecord(record, writer);
+  }
+}
+
+inline std::string EncodeProgram(const drake::solvers::MathematicalProgram& prog) {
+  ByteWriter writer;
+  EncodeProgram(prog, &writer);
+  return writer.Release();
+}
+
+// Rebuilds a program written by EncodeProgram(). The program gets fresh decision variables with
+// the original names and types, in the original order. Throws std::runtime_error on malformed
+// input.
+inline std::unique_ptr<drake::solvers::MathematicalProgram> DecodeProgram(ByteReader* reader) {
+  using drake::solvers::VectorXDecisionVariable;
+  using internal::ConstraintTag;
+  using internal::CostTag;
+  const auto version = reader->Get<std::uint32_t>();
+  if (version != kProgramEncodingVersion) {
+    throw std::runtime_error("DecodeProgram: unsupported encoding version " +
+                             std::to_string(version) + ".");
+  }
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  const auto num_vars = reader->Get<std::uint32_t>();
+  VectorXDecisionVariable variables(num_vars);
+  for (std::uint32_t i = 0; i < num_vars; ++i) {
+    const auto type = internal::GetVariableType(reader);
+    variables(i) = drake::symbolic::Variable(reader->GetString(), type);
+  }
+  prog->AddDecisionVariables(variables);
+  const Eigen::VectorXd initial_guess = reader->GetVector();
+  if (initial_guess.size() != num_vars) {
+    throw std::runtime_error("DecodeProgram: initial guess has the wrong size.");
+  }
+  prog->SetInitialGuessForAllVariables(initial_guess);
+  internal::ExpressionDecoder expressions(variables, reader);
+
+  const auto num_costs = reader->Get<std::uint32_t>();
+  for (std::uint32_t i = 0; i < num_costs; ++i) {
+    const auto tag = static_cast<CostTag>(reader->Get<std::uint8_t>());
+    const std::size_t record_end = internal::GetRecordEnd(reader);
+    if (tag == CostTag::kLinear) {
+      const VectorXDecisionVariable vars = internal::GetVariables(variables, reader);
+      const Eigen::VectorXd a = reader->GetVector();
+      prog->AddLinearCost(a, reader->Get<double>(), vars);
+    } else if (tag == CostTag::kQuadratic) {
+      const VectorXDecisionVariable vars = internal::GetVariables(variables, reader);
+      const Eigen::MatrixXd Q = internal::GetSparse(reader);
+      const Eigen::VectorXd b = reader->GetVector();
+      prog->AddQuadraticCost(Q, b, reader->Get<double>(), vars);
+    } else if (tag == CostTag::kExpression) {
+      const auto cost = std::make_shared<drake::solvers::ExpressionCost>(expressions.Decode());
+      prog->AddCost(cost, cost->vars());
+    } else {
+      throw std::runtime_error("DecodeProgram: unknown cost tag.");
+    }
+    internal::CheckRecordEnd(record_end, *reader);
+  }
+
+  const auto num_constraints = reader->Get<std::uint32_t>();
+  for (std::uint32_t i = 0; i < num_constraints; ++i) {
+    const auto tag = static_cast<ConstraintTag>(reader->Get<std::uint8_t>());
+    const std::size_t record_end = internal::GetRecordEnd(reader);
+    if (tag == ConstraintTag::kBoundingBox) {
+      const VectorXDecisionVariable vars = internal::GetVariables(variables, reader);
+      const Eigen::VectorXd lb = reader->GetVector();
+      prog->AddBoundingBoxConstraint(lb, reader->GetVector(), vars);
+    } else if (tag == ConstraintTag::kLinear) {
+      const VectorXDecisionVariable vars = internal::GetVariables(variables, reader);
+      const Eigen::SparseMatrix<double> A = internal::GetSparse(reader);
+      const Eigen::VectorXd lb = reader->GetVector();
+      prog->AddLinearConstraint(A, lb, reader->GetVector(), vars);
+    } else if (tag == ConstraintTag::kLinearEquality) {
+      const VectorXDecisionVariable vars = internal::GetVariables(variables, reader);
+      const Eigen::SparseMatrix<double> A = internal::GetSparse(reader);
+      prog->AddLinearEqualityConstraint(A, reader->GetVector(), vars);
+    } else if (tag == ConstraintTag::kQuadratic) {
+      const VectorXDecisionVariable vars = internal::GetVariables(variables, reader);
+      const Eigen::MatrixXd Q = internal::GetSparse(reader);
+      const Eigen::VectorXd b = reader->GetVector();
+      const double lb = reader->Get<double>();
+      prog->AddQuadraticConstraint(Q, b, lb, reader->Get<double>(), vars);
+    } else if (tag == ConstraintTag::kExpression) {
+      drake::VectorX<drake::symbolic::Expression> v(reader->Get<std::uint32_t>());
+      for (int j = 0; j < v.size(); ++j) {
+        v(j) = expressions.Decode();
+      }
+      const Eigen::VectorXd lb = reader->GetVector();
+      const auto constraint =
+          std::make_shared<drake::solvers::ExpressionConstraint>(v, lb, reader->GetVector());
+      prog->AddConstraint(constraint, constraint->vars());
+    } else {
+      throw std::runtime_error("DecodeProgram: unknown constraint tag.");
+    }
+    internal::CheckRecordEnd(record_end, *reader);
+  }
+  return prog;
+}
+
+inline std::unique_ptr<drake::solvers::MathematicalProgram> DecodeProgram(
+    const std::string& bytes) {
+  ByteReader reader(bytes);
+  return DecodeProgram(&reader);
+}
+
+namespace internal {
+
+// The solution status, solver name, optimal cost and primal solution of `result`.
+inline void PutPrimalResult(const drake::solvers::MathematicalProgramResult& result,
+                            ByteWriter* writer) {
+  writer->Put<std::int32_t>(result.get_solution_result());
+  writer->PutString(result.get_solver_id().name());
+  writer->Put<double>(result.get_optimal_cost());
+  writer->PutVector(result.get_x_val());
+}
+
+inline drake::solvers::MathematicalProgramResult GetPrimalResult(
+    const std::unordered_map<drake::symbolic::Variable::Id, int>& decision_variable_index,
+    ByteReader* reader) {
+  drake::solvers::MathematicalProgramResult result;
+  result.set_decision_variable_index(decision_variable_index);
+  result.set_solution_result(
+      static_cast<drake::solvers::SolutionResult>(reader->Get<std::int32_t>()));
+  // SolverId compares by identity, not by name, so the name is mapped back to the id of the
+  // solver that ran. A solver Drake does not know gets an id of its own.
+  const std::string solver_name = reader->GetString();
+  const auto& known = drake::solvers::GetKnownSolvers();
+  const auto id = std::find_if(known.begin(), known.end(), [&](const drake::solvers::SolverId& k) {
+    return k.name() == solver_name;
+  });
+  result.set_solver_id(id != known.end() ? *id : drake::solvers::SolverId(solver_name));
+  result.set_optimal_cost(reader->Get<double>());
+  const Eigen::VectorXd x = reader->GetVector();
+  if (x.size() != static_cast<int>(decision_variable_index.size())) {
+    throw std::runtime_error("DecodeResult: the result does not belong to this program.");
+  }
+  result.set_x_val(x);
+  return result;
+}
+
+// The dual solution of every constraint of `prog` in the order of EncodedConstraints(), or an
+// empty vector if the solver does not report dual solutions.
+inline std::vector<Eigen::VectorXd> DualSolutions(
+    const drake::solvers::MathematicalProgram& prog,
+    const drake::solvers::MathematicalProgramResult& result) {
+  std::vector<Eigen::VectorXd> duals;
+  try {
+    for (const auto& binding : EncodedConstraints(prog)) {
+      duals.push_back(result.GetDualSolution(binding));
+    }
+  } catch (const std::invalid_argument&) {
+    duals.clear();
+  }
+  return duals;
+}
+
+}  // namespace internal
+
+/*
+ * Appends the solution status, solver name, optimal cost, primal solution and, if the solver
+ * reported them, the dual solutions of `result`, a result of solving `prog`.
+ *
+ * Layout: int32 status | string solver name | double cost | x | uint8 has duals, followed by
+ * one vector per constraint of `prog` in the order of EncodeProgram()'s constraint records.
+ */
+inline void EncodeResult(const drake::solvers::MathematicalProgram& prog,
+                         const drake::solvers::MathematicalProgramResult& result,
+                         ByteWriter* writer) {
+  internal::PutPrimalResult(result, writer);
+  const std::vector<Eigen::VectorXd> duals = internal::DualSolutions(prog, result);
+  writer->Put<std::uint8_t>(!duals.empty());
+  for (const Eigen::VectorXd& dual : duals) {
+    writer->PutVector(dual);
+  }
+}
+
+// Reads a result written by EncodeResult(). `decision_variable_index` and `constraints` are
+// those of the program the result belongs to (MathematicalProgram::decision_variable_index()
+// and internal::EncodedConstraints()), so that GetSolution() and GetDualSolution() work with its
+// variables and bindings. Throws std::runtime_error if the result does not fit them.
+inline drake::solvers::MathematicalProgramResult DecodeResult(
+    const std::unordered_map<drake::symbolic::Variable::Id, int>& decision_variable_index,
+    const std::vector<drake::solvers::Binding<drake::solvers::Constraint>>& constraints,
+    ByteReader* reader) {
+  drake::solvers::MathematicalProgramResult result =
+      internal::GetPrimalResult(decision_variable_index, reader);
+  if (reader->Get<std::uint8_t>() != 0) {
+    for (const auto& binding : constraints) {
+      const Eigen::VectorXd dual = reader->GetVector();
+      if (dual.size() != binding.evaluator()->num_constraints()) {
+        throw std::runtime_error("DecodeResult: the result does not belong to this program.");
+      }
+      result.set_dual_solution(binding, dual);
+    }
+  }
+  return result;
+}
+
+inline drake::solvers::MathematicalProgramResult DecodeResult(
+    const drake::solvers::MathematicalProgram& prog, ByteReader* reader) {
+  return DecodeResult(prog.decision_variable_index(), internal::EncodedConstraints(prog), reader);
+}
+
+}  // namespace drake_tutorials
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <drake/solvers/mathematical_program.h>
+
+#include "program_codec.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace drake_tutorials {
+
+// Program files are these 8 bytes followed by the EncodeProgram() encoding, which carries its
+// own version. Arrays in the encoding are 8-byte aligned relative to the start of the file.
+inline constexpr char kProgramFileMagic[8] = {'D', 'T', 'P', 'R', 'O', 'G', '\n', '\0'};
+
+// Writes `prog` to `path`. The file is written next to `path` and renamed over it, so readers
+// never see a partially written program.
+inline void WriteProgramFile(const drake::solvers::MathematicalProgram& prog,
+                             const std::string& path) {
+  ByteWriter writer;
+  writer.Put(kProgramFileMagic);
+  EncodeProgram(prog, &writer);
+  const std::string temporary = path + ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    out.write(writer.bytes().data(), writer.bytes().size());
+    if (!out) {
+      throw std::runtime_error("WriteProgramFile: failed to write " + temporary);
+    }
+  }
+  std::filesystem::rename(temporary, path);
+}
+
+namespace internal {
+
+inline void CheckProgramFileMagic(ByteReader* reader, const std::string& path) {
+  char magic[sizeof(kProgramFileMagic)];
+  for (char& c : magic) {
+    c = reader->Get<char>();
+  }
+  if (std::memcmp(magic, kProgramFileMagic, sizeof(magic)) != 0) {
+    throw std::runtime_error(path + " is not a program file.");
+  }
+}
+
+inline Eigen::Map<const Eigen::SparseMatrix<double>> GetSparseView(ByteReader* reader) {
+  const auto rows = reader->Get<std::int32_t>();
+  const auto cols = reader->Get<std::int32_t>();
+  const auto outer = reader->GetArrayView<int>();
+  const auto inner = reader->GetArrayView<int>();
+  const auto values = reader->GetArrayView<double>();
+  if (inner.size != values.size ||
+      !IsCompressedColumnStructure(rows, cols, outer.data, outer.size, inner.data, inner.size)) {
+    throw std::runtime_error("MappedProgramFile: malformed sparse matrix.");
+  }
+  return {rows, cols, static_cast<Eigen::Index>(values.size), outer.data, inner.data,
+          values.data};
+}
+
+template <typename T>
+Eigen::Map<const drake::VectorX<T>> AsVector(const ArrayView<T>& view) {
+  return {view.data, static_cast<Eigen::Index>(view.size)};
+}
+
+}  // namespace internal
+
+/*
+ * A program file mapped into memory with mmap().
+ *
+ * Opening a file maps it and indexes its constraint records; nothing is decoded or copied. The
+ * bounds and sparse matrices of the bounding box and linear constraints can then be read in
+ * place through LinearConstraints(), so large archived programs can be inspected without
+ * materializing them. Load() builds the MathematicalProgram, reading straight from the mapping,
+ * so the data is copied once, into the evaluators, rather than first into a read buffer.
+ */
+class MappedProgramFile {
+ public:
+  enum class Kind { kBoundingBox, kLinear, kLinearEquality };
+
+  // A constraint lb <= A x(variables) <= ub viewed in place. Bounding boxes have no A (it is the
+  // identity), and linear equality constraints have lb = ub.
+  struct LinearConstraintView {
+    Kind kind;
+    Eigen::Map<const Eigen::VectorXi> variables;
+    std::optional<Eigen::Map<const Eigen::SparseMatrix<double>>> A;
+    Eigen::Map<const Eigen::VectorXd> lower_bound;
+    Eigen::Map<const Eigen::VectorXd> upper_bound;
+  };
+
+  explicit MappedProgramFile(const std::string& path) : path_(path) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(), "open " + path);
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+      const std::system_error error(errno, std::generic_category(), "fstat " + path);
+      close(fd);
+      throw error;
+    }
+    size_ = status.st_size;
+    void* data =
+        size_ > 0 ? mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (data == MAP_FAILED) {
+      throw std::runtime_error("MappedProgramFile: cannot map " + path);
+    }
+    data_ = static_cast<const char*>(data);
+    try {
+      Index();
+    } catch (...) {
+      munmap(const_cast<char*>(data_), size_);
+      throw;
+    }
+  }
+
+  MappedProgramFile(const MappedProgramFile&) = delete;
+  MappedProgramFile& operator=(const MappedProgramFile&) = delete;
+
+  ~MappedProgramFile() { munmap(const_cast<char*>(data_), size_); }
+
+  std::size_t size_bytes() const { return size_; }
+  int num_vars() const { return num_vars_; }
+  int num_costs() const { return num_costs_; }
+  int num_constraints() const { return static_cast<int>(constraint_records_.size()); }
+
+  // Views of the bounding box, linear and linear equality constraints, in file order, skipping
+  // quadratic and expression constraints. They point into the mapping and are valid as long as
+  // this object.
+  std::vector<LinearConstraintView> LinearConstraints() const {
+    using internal::ConstraintTag;
+    std::vector<LinearConstraintView> views;
+    for (const Record& record : constraint_records_) {
+      if (record.tag == ConstraintTag::kExpression || record.tag == ConstraintTag::kQuadratic) {
+        continue;
+      }
+      ByteReader reader(data_, record.end);
+      reader.Skip(record.begin);
+      const auto variables = internal::AsVector(reader.GetArrayView<int>());
+      if (record.tag == ConstraintTag::kBoundingBox) {
+        const auto lb = internal::AsVector(reader.GetArrayView<double>());
+        views.push_back({Kind::kBoundingBox, variables, std::nullopt, lb,
+                         internal::AsVector(reader.GetArrayView<double>())});
+      } else if (record.tag == ConstraintTag::kLinear) {
+        const auto A = internal::GetSparseView(&reader);
+        const auto lb = internal::AsVector(reader.GetArrayView<double>());
+        views.push_back(
+            {Kind::kLinear, variables, A, lb, internal::AsVector(reader.GetArrayView<double>())});
+      } else {
+        const auto A = internal::GetSparseView(&reader);
+        const auto b = internal::AsVector(reader.GetArrayView<double>());
+        views.push_back({Kind::kLinearEquality, variables, A, b, b});
+      }
+    }
+    return views;
+  }
+
+  // Decodes the whole program from the mapping.
+  std::unique_ptr<drake::solvers::MathematicalProgram> Load() const {
+    ByteReader reader(data_, size_);
+    reader.Skip(sizeof(kProgramFileMagic));
+    return DecodeProgram(&reader);
+  }
+
+ private:
+  struct Record {
+    internal::ConstraintTag tag;
+    // Byte range of the record body in the file.
+    std::size_t begin;
+    std::size_t end;
+  };
+
+  // Walks the file once, skipping over every record body.
+  void Index() {
+    ByteReader reader(data_, size_);
+    internal::CheckProgramFileMagic(&reader, path_);
+    const auto version = reader.Get<std::uint32_t>();
+    if (version != kProgramEncodingVersion) {
+      throw std::runtime_error(path_ + " has the unsupported encoding version " +
+                               std::to_string(version) + ".");
+    }
+    num_vars_ = reader.Get<std::uint32_t>();
+    for (int i = 0; i < num_vars_; ++i) {
+      internal::GetVariableType(&reader);
+      reader.GetArrayView<char>();
+    }
+    reader.GetArrayView<double>();
+    num_costs_ = reader.Get<std::uint32_t>();
+    for (int i = 0; i < num_costs_; ++i) {
+      reader.Get<std::uint8_t>();
+      reader.Skip(internal::GetRecordEnd(&reader) - reader.position());
+    }
+    const auto num_constraints = reader.Get<std::uint32_t>();
+    for (std::uint32_t i = 0; i < num_constraints; ++i) {
+      const auto tag = static_cast<internal::ConstraintTag>(reader.Get<std::uint8_t>());
+      const std::size_t end = internal::GetRecordEnd(&reader);
+      if (tag < internal::ConstraintTag::kBoundingBox ||
+          tag > internal::ConstraintTag::kQuadratic) {
+        throw std::runtime_error(path_ + " has an unknown constraint tag.");
+      }
+      constraint_records_.push_back({tag, reader.position(), end});
+      reader.Skip(end - reader.position());
+    }
+  }
+
+  std::string path_;
+  const char* data_{nullptr};
+  std::size_t size_{0};
+  int num_vars_{0};
+  int num_costs_{0};
+  std::vector<Record> constraint_records_;
+};
+
+// Reads a program written by WriteProgramFile().
+inline std::unique_ptr<drake::solvers::MathematicalProgram> ReadProgramFile(
+    const std::string& path) {
+  return MappedProgramFile(path).Load();
+}
+
+}  // namespace drake_tutorials
@@ -0,0 +1,188 @@
+#include <drake/solvers/mathematical_program.h>
+
+#include <gflags/gflags.h>
+
+#include "program_file.h"
+#include "tutorial_programs.h"
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+DEFINE_int32(num_vars, 20000, "Number of decision variables of the large program.");
+DEFINE_int32(repetitions, 5, "Number of loads per measurement.");
+DEFINE_string(path, "/tmp/program_file_benchmark.prog", "Where the program files are written.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// A sparse QP with banded inequality constraints and a few nonlinear constraints, built the way
+// the tutorials build programs: from symbolic expressions.
+std::unique_ptr<drake::solvers::MathematicalProgram> MakeLargeProgram(int n) {
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  const auto x = prog->NewContinuousVariables(n);
+  drake::symbolic::Expression cost;
+  for (int i = 0; i < n; ++i) {
+    cost += pow(x[i] - 1, 2);
+  }
+  prog->AddQuadraticCost(cost);
+  prog->AddBoundingBoxConstraint(-10, 10, x);
+  for (int i = 0; i + 2 < n; ++i) {
+    prog->AddLinearConstraint(x[i] - 2 * x[i + 1] + x[i + 2] <= 1);
+  }
+  prog->AddLinearEqualityConstraint(x[0] + x[n - 1] == 0);
+  for (int i = 0; i + 1 < n; i += std::max(1, n / 10)) {
+    prog->AddConstraint(sin(x[i]) + x[i + 1] * x[i + 1] <= 1);
+  }
+  return prog;
+}
+
+template <typename C>
+double MaxDifference(const std::vector<drake::solvers::Binding<C>>& expected,
+                     const drake::solvers::MathematicalProgram& expected_prog,
+                     const std::vector<drake::solvers::Binding<C>>& actual,
+                     const drake::solvers::MathematicalProgram& actual_prog,
+                     const Eigen::VectorXd& x) {
+  if (expected.size() != actual.size()) {
+    return INFINITY;
+  }
+  double difference = 0;
+  for (size_t i = 0; i < expected.size(); ++i) {
+    const auto evaluate = [&x](const drake::solvers::MathematicalProgram& prog,
+                               const drake::solvers::Binding<C>& binding) {
+      const std::vector<int> indices = prog.FindDecisionVariableIndices(binding.variables());
+      Eigen::VectorXd x_binding(indices.size());
+      for (size_t k = 0; k < indices.size(); ++k) {
+        x_binding(k) = x(indices[k]);
+      }
+      Eigen::VectorXd y;
+      binding.evaluator()->Eval(x_binding, &y);
+      return y;
+    };
+    const Eigen::VectorXd y_expected = evaluate(expected_prog, expected[i]);
+    const Eigen::VectorXd y_actual = evaluate(actual_prog, actual[i]);
+    if (y_expected.size() != y_actual.size()) {
+      return INFINITY;
+    }
+    if (y_expected.size() > 0) {
+      difference = std::max(difference, (y_expected - y_actual).cwiseAbs().maxCoeff());
+    }
+  }
+  return difference;
+}
+
+// Equal, with NaN (an unset initial guess) equal to NaN.
+bool SameEntries(const Eigen::VectorXd& a, const Eigen::VectorXd& b) {
+  return a.size() == b.size() &&
+         ((a.array() == b.array()) || (a.array().isNaN() && b.array().isNaN())).all();
+}
+
+// Largest difference between the costs and constraints of the two programs, including their
+// bounds, at a few random points. Infinite if their structure differs.
+double RoundTripError(const drake::solvers::MathematicalProgram& original,
+                      const drake::solvers::MathematicalProgram& loaded) {
+  if (original.num_vars() != loaded.num_vars() ||
+      !SameEntries(original.initial_guess(), loaded.initial_guess())) {
+    return INFINITY;
+  }
+  for (int i = 0; i < original.num_vars(); ++i) {
+    if (original.decision_variable(i).get_type() != loaded.decision_variable(i).get_type()) {
+      return INFINITY;
+    }
+  }
+  double error = 0;
+  const auto original_constraints = original.GetAllConstraints();
+  const auto loaded_constraints = loaded.GetAllConstraints();
+  if (original_constraints.size() != loaded_constraints.size()) {
+    return INFINITY;
+  }
+  for (size_t i = 0; i < original_constraints.size(); ++i) {
+    const auto& a = *original_constraints[i].evaluator();
+    const auto& b = *loaded_constraints[i].evaluator();
+    if (!SameEntries(a.lower_bound(), b.lower_bound()) ||
+        !SameEntries(a.upper_bound(), b.upper_bound())) {
+      return INFINITY;
+    }
+  }
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> distribution(-2, 2);
+  for (int trial = 0; trial < 3; ++trial) {
+    const Eigen::VectorXd x =
+        Eigen::VectorXd::NullaryExpr(original.num_vars(), [&] { return distribution(generator); });
+    error = std::max(error, MaxDifference(original.GetAllCosts(), original, loaded.GetAllCosts(),
+                                          loaded, x));
+    error = std::max(error, MaxDifference(original_constraints, original, loaded_constraints,
+                                          loaded, x));
+  }
+  return error;
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  int num_failures = 0;
+
+  // Round trips of the tutorial programs.
+  for (auto& tutorial : drake_tutorials::MakeTutorialPrograms()) {
+    try {
+      drake_tutorials::WriteProgramFile(*tutorial.prog, FLAGS_path);
+      const auto loaded = drake_tutorials::ReadProgramFile(FLAGS_path);
+      const double error = RoundTripError(*tutorial.prog, *loaded);
+      print(tutorial.name, ": ", std::filesystem::file_size(FLAGS_path),
+            " bytes, round-trip error ", error);
+      num_failures += !(error <= 1e-12);
+    } catch (const std::invalid_argument& e) {
+      print(tutorial.name, ": not serializable: ", e.what());
+    }
+  }
+
+  // A large program: rebuilding it from symbolic expressions against loading it from a file.
+  auto start = std::chrono::steady_clock::now();
+  auto prog = MakeLargeProgram(FLAGS_num_vars);
+  const double build_time = SecondsSince(start);
+  start = std::chrono::steady_clock::now();
+  drake_tutorials::WriteProgramFile(*prog, FLAGS_path);
+  const double write_time = SecondsSince(start);
+
+  std::unique_ptr<drake::solvers::MathematicalProgram> loaded;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < FLAGS_repetitions; ++i) {
+    loaded = drake_tutorials::ReadProgramFile(FLAGS_path);
+  }
+  const double load_time = SecondsSince(start) / FLAGS_repetitions;
+
+  // Mapping the file and summing the data of every linear constraint in place.
+  double checksum = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < FLAGS_repetitions; ++i) {
+    const drake_tutorials::MappedProgramFile file(FLAGS_path);
+    for (const auto& view : file.LinearConstraints()) {
+      checksum += view.upper_bound.sum();
+      if (view.A.has_value()) {
+        checksum += view.A->sum();
+      }
+    }
+  }
+  const double view_time = SecondsSince(start) / FLAGS_repetitions;
+
+  const double error = RoundTripError(*prog, *loaded);
+  num_failures += !(error <= 1e-12);
+  print(FLAGS_num_vars, " variables, ", prog->GetAllConstraints().size(), " constraints, ",
+        std::filesystem::file_size(FLAGS_path), " bytes, round-trip error ", error);
+  print("symbolic construction ", 1e3 * build_time, " ms\nwrite ", 1e3 * write_time,
+        " ms\nload ", 1e3 * load_time, " ms (", build_time / load_time,
+        "x faster than construction)\nmapped view of the linear constraints ", 1e3 * view_time,
+        " ms (checksum ", checksum, ")");
+  std::filesystem::remove(FLAGS_path);
+  return num_failures == 0 ? 0 : 1;
+}
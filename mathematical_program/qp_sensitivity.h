@@ -0,0 +1,247 @@
+#pragma once
+
+#include <drake/solvers/mathematical_program.h>
+
+#include "batch_solve.h"
+#include "small_qp.h"
+
+#include <Eigen/QR>
+
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace drake_tutorials {
+
+struct QpSensitivityOptions {
+  // Inequalities with a slack below this (relative to 1 + |b|) count as active at the optimum.
+  double active_tolerance{1e-6};
+  // Slack allowed when Update() checks that the active set is still optimal.
+  double tolerance{1e-9};
+  // Whether Update() linearizes again at the solution of a fallback solve.
+  bool relinearize{true};
+  // Options of the fallback solve; see SolveWithSmallQpFastPath(), which ignores its fast path
+  // when they are set.
+  std::optional<drake::solvers::SolverOptions> solver_options;
+};
+
+struct QpUpdate {
+  Eigen::VectorXd x;
+  bool success{false};
+  // False if x is the first-order update, true if the active set changed and the QP was solved
+  // again.
+  bool resolved{false};
+};
+
+namespace internal {
+
+// The QP of a family accepted by IsSmallQp() with the linear cost g + E (p - p0) and the
+// right-hand side b + B (p - p0); `data` holds the QP at p0.
+struct AffineQp {
+  SmallQpData data;
+  Eigen::MatrixXd E;
+  Eigen::MatrixXd B;
+};
+
+// Extracts E and B by building the QP at p0 and at p0 plus the unit vectors, and checks that the
+// parameters change nothing else.
+inline AffineQp MakeAffineQp(const ProgramFamily& family, const Eigen::VectorXd& p0,
+                             drake::solvers::MathematicalProgram* prog) {
+  const int num_parameters = p0.size();
+  family.set_parameters(p0, prog);
+  if (!IsSmallQp(*prog)) {
+    throw std::invalid_argument("QpSensitivity: the family is not a QP accepted by IsSmallQp().");
+  }
+  AffineQp qp{MakeSmallQpData(*prog), Eigen::MatrixXd(), Eigen::MatrixXd()};
+  qp.E.resize(qp.data.g.size(), num_parameters);
+  qp.B.resize(qp.data.b.size(), num_parameters);
+  for (int i = 0; i < num_parameters; ++i) {
+    family.set_parameters(p0 + Eigen::VectorXd::Unit(num_parameters, i), prog);
+    const SmallQpData data = MakeSmallQpData(*prog);
+    if (data.num_equalities != qp.data.num_equalities || data.b.size() != qp.data.b.size() ||
+        data.G != qp.data.G || data.normals != qp.data.normals) {
+      throw std::invalid_argument("QpSensitivity: the parameters may only change the linear "
+                                  "cost and the constraint bounds.");
+    }
+    qp.E.col(i) = data.g - qp.data.g;
+    qp.B.col(i) = data.b - qp.data.b;
+  }
+  family.set_parameters(p0, prog);
+  return qp;
+}
+
+}  // namespace internal
+
+/*
+ * Sensitivity of the solution of a parametric QP (see IsSmallQp()) whose parameters enter the
+ * linear cost and the constraint bounds affinely, e.g. b in x(0) + x(1) == b.
+ *
+ * At the optimum x*(p0) the active constraints N_A' x = b_A + B_A p and stationarity
+ * G x + g + E p = N_A u form the KKT system
+ *    [G    -N_A] [dx/dp]   [ -E ]
+ *    [N_A'    0] [du/dp] = [B_A ],
+ * which is factored once. The solution stays affine in p as long as the active set does not
+ * change, so the first-order update x*(p0) + dx/dp (p - p0) is exact inside the critical region of
+ * p0. Update() checks that it is and otherwise solves the QP at p again with the dual active-set
+ * method of SolveSmallQp(), warm started with the active set of p0, which usually differs from
+ * the new one in a constraint or two. Only if that fails does it fall back to
+ * SolveWithSmallQpFastPath() on the program. Active-set solutions are exact, which the
+ * active_tolerance test of the next linearization relies on; a first-order solver such as OSQP
+ * stops around 1e-3.
+ */
+class QpSensitivity {
+ public:
+  // `result` is a solution of the family's program at `parameters`. Throws std::invalid_argument
+  // if it is not a successful one.
+  QpSensitivity(const ProgramFamily& family, const Eigen::VectorXd& parameters,
+                const drake::solvers::MathematicalProgramResult& result,
+                const QpSensitivityOptions& options = {})
+      : family_(family), prog_(family.build()), options_(options) {
+    if (!result.is_success()) {
+      throw std::invalid_argument("QpSensitivity: the nominal solve did not succeed.");
+    }
+    Linearize(parameters, result.get_x_val());
+  }
+
+  const Eigen::VectorXd& parameters() const { return p0_; }
+  // The solution at parameters(), recomputed from the KKT system of the active set.
+  const Eigen::VectorXd& x() const { return x0_; }
+  const Eigen::MatrixXd& dx_dp() const { return dx_dp_; }
+  // Columns of internal::SmallQpData::normals that are active: the equalities, then the active
+  // inequalities.
+  const std::vector<int>& active() const { return active_; }
+  const Eigen::VectorXd& multipliers() const { return u0_; }
+  const Eigen::MatrixXd& dmultipliers_dp() const { return du_dp_; }
+
+  // The first-order prediction, valid or not.
+  Eigen::VectorXd Predict(const Eigen::VectorXd& parameters) const {
+    return x0_ + dx_dp_ * (parameters - p0_);
+  }
+
+  QpUpdate Update(const Eigen::VectorXd& parameters) {
+    QpUpdate update;
+    const Eigen::VectorXd dp = parameters - p0_;
+    update.x = x0_ + dx_dp_ * dp;
+    if (IsOptimal(update.x, u0_ + du_dp_ * dp, dp)) {
+      update.success = true;
+      return update;
+    }
+    update.resolved = true;
+    const internal::SmallQpData& data = qp_.data;
+    Eigen::VectorXd multipliers;
+    const SmallQpStatus status = internal::SolveSmallQpData(
+        data, data.g + qp_.E * dp, data.b + qp_.B * dp, &update.x, &multipliers, active_);
+    if (status == SmallQpStatus::kSolved || status == SmallQpStatus::kInfeasible) {
+      update.success = status == SmallQpStatus::kSolved;
+    } else {
+      family_.set_parameters(parameters, prog_.get());
+      const auto result =
+          SolveWithSmallQpFastPath(*prog_, x0_ + dx_dp_ * dp, options_.solver_options);
+      update.x = result.get_x_val();
+      update.success = result.is_success();
+    }
+    if (update.success && options_.relinearize) {
+      Linearize(parameters, update.x);
+    }
+    return update;
+  }
+
+ private:
+  void Linearize(const Eigen::VectorXd& parameters, const Eigen::VectorXd& x) {
+    qp_ = internal::MakeAffineQp(family_, parameters, prog_.get());
+    p0_ = parameters;
+    const internal::SmallQpData& data = qp_.data;
+    const int n = data.g.size();
+    if (x.size() != n) {
+      throw std::invalid_argument("QpSensitivity: the result is not a solution of the family.");
+    }
+    active_.clear();
+    for (int i = 0; i < data.b.size(); ++i) {
+      const double slack = data.normals.col(i).dot(x) - data.b(i);
+      if (i < data.num_equalities ||
+          slack <= options_.active_tolerance * (1 + std::abs(data.b(i)))) {
+        active_.push_back(i);
+      }
+    }
+    // Inequalities that are only weakly active can come out with a negative multiplier; they are
+    // dropped one at a time until all multipliers are nonnegative.
+    while (true) {
+      Factor();
+      int worst = -1;
+      for (int i = 0; i < u0_.size(); ++i) {
+        if (active_[i] >= data.num_equalities && u0_(i) < -options_.active_tolerance &&
+            (worst < 0 || u0_(i) < u0_(worst))) {
+          worst = i;
+        }
+      }
+      if (worst < 0) {
+        return;
+      }
+      active_.erase(active_.begin() + worst);
+    }
+  }
+
+  // Solves the KKT system of the active set for the solution, the multipliers and their
+  // derivatives. Dependent active constraints get the minimum-norm multipliers.
+  void Factor() {
+    const internal::SmallQpData& data = qp_.data;
+    const int n = data.g.size();
+    const int a = active_.size();
+    const int p = p0_.size();
+    Eigen::MatrixXd K = Eigen::MatrixXd::Zero(n + a, n + a);
+    Eigen::MatrixXd rhs(n + a, 1 + p);
+    K.topLeftCorner(n, n) = data.G;
+    rhs.topRows(n) << -data.g, -qp_.E;
+    for (int i = 0; i < a; ++i) {
+      K.block(0, n + i, n, 1) = -data.normals.col(active_[i]);
+      K.block(n + i, 0, 1, n) = data.normals.col(active_[i]).transpose();
+      rhs(n + i, 0) = data.b(active_[i]);
+      rhs.block(n + i, 1, 1, p) = qp_.B.row(active_[i]);
+    }
+    const Eigen::MatrixXd solution = Eigen::CompleteOrthogonalDecomposition<Eigen::MatrixXd>(K)
+                                         .solve(rhs);
+    x0_ = solution.col(0).head(n);
+    u0_ = solution.col(0).tail(a);
+    dx_dp_ = solution.block(0, 1, n, p);
+    du_dp_ = solution.block(n, 1, a, p);
+  }
+
+  // Whether `x` and the active multipliers `u` satisfy the KKT conditions at p0 + dp: inactive
+  // inequalities hold and active inequalities keep nonnegative multipliers.
+  bool IsOptimal(const Eigen::VectorXd& x, const Eigen::VectorXd& u,
+                 const Eigen::VectorXd& dp) const {
+    const internal::SmallQpData& data = qp_.data;
+    std::vector<bool> is_active(data.b.size(), false);
+    for (size_t i = 0; i < active_.size(); ++i) {
+      is_active[active_[i]] = true;
+      if (active_[i] >= data.num_equalities && u(i) < -options_.tolerance) {
+        return false;
+      }
+    }
+    for (int i = data.num_equalities; i < data.b.size(); ++i) {
+      if (is_active[i]) {
+        continue;
+      }
+      const double b = data.b(i) + qp_.B.row(i).dot(dp);
+      if (data.normals.col(i).dot(x) < b - options_.tolerance * (1 + std::abs(b))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  ProgramFamily family_;
+  std::unique_ptr<drake::solvers::MathematicalProgram> prog_;
+  QpSensitivityOptions options_;
+  internal::AffineQp qp_;
+  Eigen::VectorXd p0_;
+  Eigen::VectorXd x0_;
+  Eigen::MatrixXd dx_dp_;
+  std::vector<int> active_;
+  Eigen::VectorXd u0_;
+  Eigen::MatrixXd du_dp_;
+};
+
+}  // namespace drake_tutorials
@@ -0,0 +1,126 @@
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/solve.h>
+
+#include <gflags/gflags.h>
+
+#include "benchmark_statistics.h"
+#include "qp_sensitivity.h"
+#include "small_qp.h"
+#include "tutorial_programs.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+DEFINE_int32(num_updates, 10000, "Number of perturbed parameter vectors per program.");
+DEFINE_double(perturbation, 0.05, "Standard deviation of the parameter perturbations.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+// Projection of c + A p onto the box [0, 1]^10: min 0.5 |x|^2 - (c + A p)'x, with the two
+// parameters moving the target across the faces of the box.
+drake_tutorials::ProgramFamily MakeBoxProjectionFamily() {
+  constexpr int n = 10;
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> uniform(-0.2, 1.2);
+  const Eigen::VectorXd c = Eigen::VectorXd::NullaryExpr(n, [&] { return uniform(generator); });
+  const Eigen::MatrixXd A = 0.5 * Eigen::MatrixXd::Random(n, 2);
+  drake_tutorials::ProgramFamily family;
+  family.build = [] {
+    auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+    const auto x = prog->NewContinuousVariables(n);
+    prog->AddQuadraticCost(Eigen::MatrixXd::Identity(n, n), Eigen::VectorXd::Zero(n), x);
+    prog->AddBoundingBoxConstraint(0, 1, x);
+    return prog;
+  };
+  family.set_parameters = [c, A](const Eigen::VectorXd& p,
+                                 drake::solvers::MathematicalProgram* prog) {
+    prog->quadratic_costs().front().evaluator()->UpdateCoefficients(
+        Eigen::MatrixXd::Identity(n, n), -(c + A * p));
+  };
+  return family;
+}
+
+// Perturbs the parameters around `p0`, and compares QpSensitivity::Update() with SolveSmallQp()
+// and Solve() on the same parameters. Returns false on a wrong solution.
+bool Run(const std::string& name, const drake_tutorials::ProgramFamily& family,
+         const Eigen::VectorXd& p0) {
+  auto prog = family.build();
+  family.set_parameters(p0, prog.get());
+  drake_tutorials::QpSensitivity sensitivity(family, p0,
+                                             drake_tutorials::SolveWithSmallQpFastPath(*prog));
+  print(name, ": ", sensitivity.active().size(), " active constraints at p0, dx/dp =\n",
+        sensitivity.dx_dp());
+
+  std::mt19937 generator(1);
+  std::normal_distribution<double> normal(0, FLAGS_perturbation);
+  std::vector<double> update_latencies, resolve_latencies, small_qp_latencies, solve_latencies;
+  double error = 0;
+  int num_failures = 0;
+  for (int i = 0; i < FLAGS_num_updates; ++i) {
+    const Eigen::VectorXd p =
+        p0 + Eigen::VectorXd::NullaryExpr(p0.size(), [&] { return normal(generator); });
+    auto start = std::chrono::steady_clock::now();
+    const drake_tutorials::QpUpdate update = sensitivity.Update(p);
+    const std::chrono::duration<double, std::micro> latency =
+        std::chrono::steady_clock::now() - start;
+    (update.resolved ? resolve_latencies : update_latencies).push_back(latency.count());
+
+    family.set_parameters(p, prog.get());
+    drake::solvers::MathematicalProgramResult result;
+    start = std::chrono::steady_clock::now();
+    drake_tutorials::SolveSmallQp(*prog, &result);
+    small_qp_latencies.push_back(
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+            .count());
+    if (i % 10 == 0) {
+      start = std::chrono::steady_clock::now();
+      drake::solvers::Solve(*prog);
+      solve_latencies.push_back(
+          std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+              .count());
+    }
+    num_failures += !update.success;
+    if (update.success && result.is_success()) {
+      error = std::max(error, (update.x - result.get_x_val()).cwiseAbs().maxCoeff());
+    }
+  }
+  const auto report = [](const std::string& what, const std::vector<double>& latencies) {
+    if (latencies.empty()) {
+      return;
+    }
+    print("  ", what, ": ", latencies.size(), " calls, median ",
+          drake_tutorials::Percentile(latencies, 0.5), " us, p99 ",
+          drake_tutorials::Percentile(latencies, 0.99), " us");
+  };
+  report("first-order update", update_latencies);
+  report("warm-started re-solve after an active-set change", resolve_latencies);
+  report("SolveSmallQp()", small_qp_latencies);
+  report("Solve()", solve_latencies);
+  print("  largest difference to SolveSmallQp() ", error, ", failures ", num_failures);
+  return num_failures == 0 && error <= 1e-5;
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  bool ok = true;
+
+  // simple_optimization_problem_feasible.cpp with b in x(0) + x(1) == b as the parameter.
+  drake_tutorials::ProgramFamily feasible;
+  feasible.build = [] { return drake_tutorials::MakeFeasibleProgram(); };
+  feasible.set_parameters = [](const Eigen::VectorXd& p,
+                               drake::solvers::MathematicalProgram* prog) {
+    prog->linear_equality_constraints().front().evaluator()->UpdateCoefficients(
+        Eigen::RowVector2d(1, 1), p);
+  };
+  ok &= Run("simple_optimization_problem_feasible", feasible, drake::Vector1d(1));
+  ok &= Run("box projection", MakeBoxProjectionFamily(), Eigen::Vector2d::Zero());
+  return ok ? 0 : 1;
+}
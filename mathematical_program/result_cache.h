@@ -0,0 +1,649 @@
+#pragma once
+
+#include <drake/solvers/choose_best_solver.h>
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/solver_interface.h>
+
+#include "program_codec.h"
+#include "solver_concurrency.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace drake_tutorials {
+
+// A 128-bit hash of a canonicalized program; see CanonicalProgramHash().
+struct ProgramHash {
+  std::uint64_t high{0};
+  std::uint64_t low{0};
+
+  bool operator==(const ProgramHash& other) const {
+    return high == other.high && low == other.low;
+  }
+};
+
+struct ProgramHashHasher {
+  std::size_t operator()(const ProgramHash& hash) const { return hash.low; }
+};
+
+namespace internal {
+
+// Tags of the canonical records. Part of the hash, so they must not be renumbered.
+enum class CanonicalTag : std::uint8_t {
+  kVariables = 1,
+  kInitialGuess,
+  kLinearCost,
+  kQuadraticCost,
+  kExpressionCost,
+  kBoundingBox,
+  kLinearRow,
+  kLinearEqualityRow,
+  kQuadraticConstraint,
+  kExpressionConstraint,
+};
+
+// Doubles with all NaNs and both zeros mapped to one value each, so that equal data hashes
+// equally.
+inline double CanonicalDouble(double value) {
+  if (std::isnan(value)) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  return value == 0 ? 0.0 : value;
+}
+
+inline void PutCanonicalVector(const Eigen::VectorXd& v, ByteWriter* writer) {
+  writer->Put<std::uint64_t>(v.size());
+  for (int i = 0; i < v.size(); ++i) {
+    writer->Put<double>(CanonicalDouble(v(i)));
+  }
+}
+
+// (variable index, value) pairs; for quadratic terms the index encodes a pair of variables.
+using CanonicalTerms = std::vector<std::pair<std::int64_t, double>>;
+
+// Nonzero terms sorted by index, with repeated indices summed.
+inline void PutCanonicalTerms(CanonicalTerms terms, ByteWriter* writer) {
+  std::sort(terms.begin(), terms.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  CanonicalTerms merged;
+  for (const auto& [index, value] : terms) {
+    if (!merged.empty() && merged.back().first == index) {
+      merged.back().second += value;
+    } else {
+      merged.emplace_back(index, value);
+    }
+  }
+  merged.erase(std::remove_if(merged.begin(), merged.end(),
+                              [](const auto& term) { return term.second == 0; }),
+               merged.end());
+  writer->Put<std::uint64_t>(merged.size());
+  for (const auto& [index, value] : merged) {
+    writer->Put<std::int64_t>(index);
+    writer->Put<double>(CanonicalDouble(value));
+  }
+}
+
+// The rows of A x over the program variables `indices` as one record each.
+inline void AddLinearRows(CanonicalTag tag, const Eigen::SparseMatrix<double>& A,
+                          const std::vector<int>& indices, const Eigen::VectorXd& lower,
+                          const Eigen::VectorXd& upper, std::vector<std::string>* records) {
+  std::vector<CanonicalTerms> rows(A.rows());
+  for (int k = 0; k < A.outerSize(); ++k) {
+    for (Eigen::SparseMatrix<double>::InnerIterator it(A, k); it; ++it) {
+      rows[it.row()].emplace_back(indices[it.col()], it.value());
+    }
+  }
+  for (int i = 0; i < A.rows(); ++i) {
+    ByteWriter writer;
+    writer.Put<std::uint8_t>(static_cast<std::uint8_t>(tag));
+    PutCanonicalTerms(std::move(rows[i]), &writer);
+    writer.Put<double>(CanonicalDouble(lower(i)));
+    writer.Put<double>(CanonicalDouble(upper(i)));
+    records->push_back(writer.Release());
+  }
+}
+
+// x'Q x over the program variables `indices` as upper-triangular terms i <= j, keyed by
+// i * num_vars + j.
+inline void PutCanonicalQuadratic(const Eigen::MatrixXd& Q, const std::vector<int>& indices,
+                                  int num_vars, ByteWriter* writer) {
+  CanonicalTerms terms;
+  for (int r = 0; r < Q.rows(); ++r) {
+    for (int c = 0; c < Q.cols(); ++c) {
+      if (Q(r, c) != 0) {
+        const int i = std::min(indices[r], indices[c]);
+        const int j = std::max(indices[r], indices[c]);
+        terms.emplace_back(std::int64_t{i} * num_vars + j, Q(r, c));
+      }
+    }
+  }
+  PutCanonicalTerms(std::move(terms), writer);
+}
+
+template <typename C>
+CanonicalTerms GlobalTerms(const drake::solvers::MathematicalProgram& prog,
+                           const drake::solvers::Binding<C>& binding,
+                           const Eigen::VectorXd& coefficients) {
+  const std::vector<int> indices = prog.FindDecisionVariableIndices(binding.variables());
+  CanonicalTerms terms;
+  for (int i = 0; i < coefficients.size(); ++i) {
+    terms.emplace_back(indices[i], coefficients(i));
+  }
+  return terms;
+}
+
+// The outputs of a cost or constraint as expressions over the program variables. Returns nullopt
+// if the evaluator has no symbolic form.
+template <typename C>
+std::optional<drake::VectorX<drake::symbolic::Expression>> SymbolicOutputs(
+    const drake::solvers::Binding<C>& binding) {
+  drake::VectorX<drake::symbolic::Expression> y;
+  try {
+    binding.evaluator()->Eval(binding.variables(), &y);
+  } catch (const std::exception&) {
+    return std::nullopt;
+  }
+  return y;
+}
+
+// Returns false for expressions that ExpressionEncoder does not support.
+inline bool EncodeExpression(const drake::solvers::MathematicalProgram& prog,
+                             const drake::symbolic::Expression& e, ByteWriter* writer) {
+  try {
+    ExpressionEncoder(prog, writer).Encode(e);
+  } catch (const std::invalid_argument&) {
+    return false;
+  }
+  return true;
+}
+
+// One byte string per variable block, cost and constraint row, each independent of the order in
+// which the program was assembled.
+struct CanonicalRecordList {
+  // In the order of the program's bindings. The constraint rows come last, binding by binding in
+  // the order of EncodedConstraints().
+  std::vector<std::string> records;
+  std::size_t first_constraint_row{0};
+};
+
+// Returns nullopt for programs with costs or constraints that cannot be canonicalized.
+inline std::optional<CanonicalRecordList> CanonicalRecords(
+    const drake::solvers::MathematicalProgram& prog,
+    const std::optional<Eigen::VectorXd>& initial_guess) {
+  const int n = prog.num_vars();
+  std::vector<std::string> records;
+  {
+    ByteWriter writer;
+    writer.Put<std::uint8_t>(static_cast<std::uint8_t>(CanonicalTag::kVariables));
+    writer.Put<std::uint32_t>(n);
+    for (int i = 0; i < n; ++i) {
+      writer.Put<std::uint8_t>(static_cast<std::uint8_t>(prog.decision_variable(i).get_type()));
+    }
+    records.push_back(writer.Release());
+  }
+  {
+    ByteWriter writer;
+    writer.Put<std::uint8_t>(static_cast<std::uint8_t>(CanonicalTag::kInitialGuess));
+    PutCanonicalVector(initial_guess.value_or(prog.initial_guess()), &writer);
+    records.push_back(writer.Release());
+  }
+
+  std::size_t num_costs = 0;
+  for (const auto& binding : prog.linear_costs()) {
+    ByteWriter writer;
+    writer.Put<std::uint8_t>(static_cast<std::uint8_t>(CanonicalTag::kLinearCost));
+    PutCanonicalTerms(GlobalTerms(prog, binding, binding.evaluator()->a()), &writer);
+    writer.Put<double>(CanonicalDouble(binding.evaluator()->b()));
+    records.push_back(writer.Release());
+    ++num_costs;
+  }
+  for (const auto& binding : prog.quadratic_costs()) {
+    ByteWriter writer;
+    writer.Put<std::uint8_t>(static_cast<std::uint8_t>(CanonicalTag::kQuadraticCost));
+    PutCanonicalQuadratic(binding.evaluator()->Q(),
+                          prog.FindDecisionVariableIndices(binding.variables()), n, &writer);
+    PutCanonicalTerms(GlobalTerms(prog, binding, binding.evaluator()->b()), &writer);
+    writer.Put<double>(CanonicalDouble(binding.evaluator()->c()));
+    records.push_back(writer.Release());
+    ++num_costs;
+  }
+  for (const auto& binding : prog.generic_costs()) {
+    const auto y = SymbolicOutputs(binding);
+    ByteWriter writer;
+    writer.Put<std::uint8_t>(static_cast<std::uint8_t>(CanonicalTag::kExpressionCost));
+    if (!y || !EncodeExpression(prog, (*y)(0), &writer)) {
+      return std::nullopt;
+    }
+    records.push_back(writer.Release());
+    ++num_costs;
+  }
+  if (num_costs != prog.GetAllCosts().size()) {
+    return std::nullopt;
+  }
+
+  const std::size_t first_constraint_row = records.size();
+  std::size_t num_constraints = 0;
+  for (const auto& binding : prog.bounding_box_constraints()) {
+    const std::vector<int> indices = prog.FindDecisionVariableIndices(binding.variables());
+    AddLinearRows(CanonicalTag::kBoundingBox,
+                  Eigen::MatrixXd::Identity(indices.size(), indices.size()).sparseView(), indices,
+                  binding.evaluator()->lower_bound(), binding.evaluator()->upper_bound(),
+                  &records);
+    ++num_constraints;
+  }
+  for (const auto& binding : prog.linear_constraints()) {
+    AddLinearRows(CanonicalTag::kLinearRow, binding.evaluator()->get_sparse_A(),
+                  prog.FindDecisionVariableIndices(binding.variables()),
+                  binding.evaluator()->lower_bound(), binding.evaluator()->upper_bound(),
+                  &records);
+    ++num_constraints;
+  }
+  for (const auto& binding : prog.linear_equality_constraints()) {
+    AddLinearRows(CanonicalTag::kLinearEqualityRow, binding.evaluator()->get_sparse_A(),
+                  prog.FindDecisionVariableIndices(binding.variables()),
+                  binding.evaluator()->lower_bound(), binding.evaluator()->upper_bound(),
+                  &records);
+    ++num_constraints;
+  }
+  for (const auto& binding : prog.quadratic_constraints()) {
+    ByteWriter writer;
+    writer.Put<std::uint8_t>(static_cast<std::uint8_t>(CanonicalTag::kQuadraticConstraint));
+    PutCanonicalQuadratic(binding.evaluator()->Q(),
+                          prog.FindDecisionVariableIndices(binding.variables()), n, &writer);
+    PutCanonicalTerms(GlobalTerms(prog, binding, binding.evaluator()->b()), &writer);
+    PutCanonicalVector(binding.evaluator()->lower_bound(), &writer);
+    PutCanonicalVector(binding.evaluator()->upper_bound(), &writer);
+    records.push_back(writer.Release());
+    ++num_constraints;
+  }
+  for (const auto& binding : prog.generic_constraints()) {
+    const auto y = SymbolicOutputs(binding);
+    if (!y) {
+      return std::nullopt;
+    }
+    for (int i = 0; i < y->size(); ++i) {
+      ByteWriter writer;
+      writer.Put<std::uint8_t>(static_cast<std::uint8_t>(CanonicalTag::kExpressionConstraint));
+      if (!EncodeExpression(prog, (*y)(i), &writer)) {
+        return std::nullopt;
+      }
+      writer.Put<double>(CanonicalDouble(binding.evaluator()->lower_bound()(i)));
+      writer.Put<double>(CanonicalDouble(binding.evaluator()->upper_bound()(i)));
+      records.push_back(writer.Release());
+    }
+    ++num_constraints;
+  }
+  if (num_constraints != prog.GetAllConstraints().size()) {
+    return std::nullopt;
+  }
+  return CanonicalRecordList{std::move(records), first_constraint_row};
+}
+
+// FNV-1a over 64 bits with the given odd multiplier.
+inline void HashBytes(const std::string& bytes, std::uint64_t multiplier, std::uint64_t* hash) {
+  for (unsigned char byte : bytes) {
+    *hash = (*hash ^ byte) * multiplier;
+  }
+}
+
+}  // namespace internal
+
+// `prog` in canonical form; see CanonicalizeProgram().
+struct CanonicalProgram {
+  ProgramHash hash;
+  // The sorted canonical records, each prefixed with its length.
+  std::string bytes;
+  // For every constraint row, binding by binding in the order of internal::EncodedConstraints(),
+  // the position of its record among the sorted records. Equal records get consecutive positions
+  // in binding order.
+  std::vector<std::uint32_t> row_positions;
+  std::uint32_t num_records{0};
+};
+
+/*
+ * Canonicalizes and hashes `prog` together with the initial guess of the solve (the program's own
+ * if nullopt), so that programs with the same variables, data and initial guess have the same
+ * canonical form even when they were assembled differently. Every cost binding and every
+ * constraint row becomes one record, with its terms sorted by variable, and the records are
+ * sorted. The order of the bindings therefore does not matter, and neither does how constraint
+ * rows are split into bindings. A cost split into several bindings does have a different
+ * canonical form than their sum, though. Variables are identified by their index in the program,
+ * since results are indexed the same way. Expression costs and constraints are encoded as their
+ * expression trees (see internal::ExpressionEncoder), and other evaluators through their
+ * symbolic form.
+ *
+ * Returns nullopt for programs that cannot be canonicalized, e.g. with conic constraints or
+ * evaluators without a symbolic form. The result does not depend on the process, so it can key a
+ * cache stored on disk.
+ */
+inline std::optional<CanonicalProgram> CanonicalizeProgram(
+    const drake::solvers::MathematicalProgram& prog,
+    const std::optional<Eigen::VectorXd>& initial_guess = std::nullopt) {
+  const auto list = internal::CanonicalRecords(prog, initial_guess);
+  if (!list) {
+    return std::nullopt;
+  }
+  const std::vector<std::string>& records = list->records;
+  std::vector<std::uint32_t> order(records.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](std::uint32_t a, std::uint32_t b) { return records[a] < records[b]; });
+  std::vector<std::uint32_t> positions(records.size());
+  CanonicalProgram canonical;
+  for (std::uint32_t i = 0; i < order.size(); ++i) {
+    positions[order[i]] = i;
+    const std::uint64_t size = records[order[i]].size();
+    canonical.bytes.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    canonical.bytes += records[order[i]];
+  }
+  canonical.row_positions.assign(positions.begin() + list->first_constraint_row,
+                                 positions.end());
+  canonical.num_records = records.size();
+  // FNV-1a with its own prime and with a second odd multiplier. The record lengths are part of
+  // the bytes, so record boundaries are part of the hash. ResultCache compares the bytes on
+  // every hit, so a collision costs a miss rather than a wrong result.
+  constexpr std::uint64_t kFnvPrime = 0x100000001b3ULL;
+  constexpr std::uint64_t kGoldenRatio = 0x9e3779b97f4a7c15ULL;
+  canonical.hash = ProgramHash{0xcbf29ce484222325ULL, 0xcbf29ce484222325ULL};
+  internal::HashBytes(canonical.bytes, kFnvPrime, &canonical.hash.high);
+  internal::HashBytes(canonical.bytes, kGoldenRatio, &canonical.hash.low);
+  return canonical;
+}
+
+// The hash of CanonicalizeProgram().
+inline std::optional<ProgramHash> CanonicalProgramHash(
+    const drake::solvers::MathematicalProgram& prog,
+    const std::optional<Eigen::VectorXd>& initial_guess = std::nullopt) {
+  const auto canonical = CanonicalizeProgram(prog, initial_guess);
+  if (!canonical) {
+    return std::nullopt;
+  }
+  return canonical->hash;
+}
+
+struct ResultCacheOptions {
+  // Bound on the encoded results held in memory, over all shards.
+  std::size_t max_bytes{std::size_t{256} << 20};
+  int num_shards{16};
+};
+
+struct ResultCacheStatistics {
+  std::int64_t hits{0};
+  std::int64_t misses{0};
+  std::int64_t evictions{0};
+  std::size_t entries{0};
+  std::size_t bytes{0};
+  // Sum of the solve times the hits did not spend.
+  double saved_seconds{0};
+
+  double hit_rate() const { return hits + misses > 0 ? double(hits) / (hits + misses) : 0; }
+};
+
+/*
+ * A thread-safe cache of MathematicalProgramResults for workloads that solve exactly repeated
+ * programs, keyed by CanonicalizeProgram(). Every entry keeps the canonical records of its
+ * program, and a hit requires them to be equal to the lookup's, so hash collisions are misses.
+ *
+ * Results are stored encoded: status, solver, optimal cost and primal solution as in
+ * EncodeResult(), and the dual solutions one constraint row at a time under the position of the
+ * row's canonical record. A hit attaches them to the corresponding rows of the lookup program,
+ * however its constraints are ordered or split into bindings, so hits carry dual solutions
+ * whenever the solver reported them. Only the solver details are not cached.
+ *
+ * The entries are spread over shards by hash, each with its own mutex, LRU list and byte budget,
+ * so concurrent lookups rarely contend. Save() and Load() persist the cache in a file. The key
+ * does not include the solver or its options, so one cache should serve one solver
+ * configuration.
+ */
+class ResultCache {
+ public:
+  explicit ResultCache(const ResultCacheOptions& options = {})
+      : shards_(std::max(1, options.num_shards)),
+        max_shard_bytes_(std::max<std::size_t>(1, options.max_bytes / shards_.size())) {}
+
+  // Returns the result stored for `key`, the canonical form of `prog`, with `prog`'s variables
+  // and constraints.
+  std::optional<drake::solvers::MathematicalProgramResult> Find(
+      const CanonicalProgram& key, const drake::solvers::MathematicalProgram& prog) {
+    Shard& shard = ShardOf(key.hash);
+    std::string bytes;
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      const auto it = shard.index.find(key.hash);
+      if (it == shard.index.end() || it->second->canonical != key.bytes) {
+        ++shard.misses;
+        return std::nullopt;
+      }
+      shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+      ++shard.hits;
+      shard.saved_seconds += it->second->solve_seconds;
+      bytes = it->second->bytes;
+    }
+    // The entry stores the solver's name, which GetPrimalResult() maps back to its SolverId.
+    ByteReader reader(bytes);
+    drake::solvers::MathematicalProgramResult result =
+        internal::GetPrimalResult(prog.decision_variable_index(), &reader);
+    if (reader.Get<std::uint8_t>() != 0) {
+      const Eigen::VectorXd duals = reader.GetVector();
+      std::size_t row = 0;
+      for (const auto& binding : internal::EncodedConstraints(prog)) {
+        Eigen::VectorXd dual(binding.evaluator()->num_constraints());
+        for (int i = 0; i < dual.size(); ++i, ++row) {
+          dual(i) = duals(key.row_positions[row]);
+        }
+        result.set_dual_solution(binding, dual);
+      }
+    }
+    return result;
+  }
+
+  // Stores `result`, the result of solving `prog`, for `key`, the canonical form of `prog`,
+  // replacing an earlier result. `solve_seconds` is what a hit saves.
+  void Insert(const CanonicalProgram& key, const drake::solvers::MathematicalProgram& prog,
+              const drake::solvers::MathematicalProgramResult& result, double solve_seconds) {
+    ByteWriter writer;
+    internal::PutPrimalResult(result, &writer);
+    const std::vector<Eigen::VectorXd> duals = internal::DualSolutions(prog, result);
+    writer.Put<std::uint8_t>(!duals.empty());
+    if (!duals.empty()) {
+      Eigen::VectorXd by_position = Eigen::VectorXd::Zero(key.num_records);
+      std::size_t row = 0;
+      for (const Eigen::VectorXd& dual : duals) {
+        for (int i = 0; i < dual.size(); ++i, ++row) {
+          by_position(key.row_positions[row]) = dual(i);
+        }
+      }
+      writer.PutVector(by_position);
+    }
+    Insert(key.hash, key.bytes, writer.Release(), solve_seconds);
+  }
+
+  ResultCacheStatistics statistics() const {
+    ResultCacheStatistics statistics;
+    for (const Shard& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      statistics.hits += shard.hits;
+      statistics.misses += shard.misses;
+      statistics.evictions += shard.evictions;
+      statistics.entries += shard.entries.size();
+      statistics.bytes += shard.bytes;
+      statistics.saved_seconds += shard.saved_seconds;
+    }
+    return statistics;
+  }
+
+  /*
+   * Writes the entries to `path` through a temporary file renamed over it. Layout: kFileMagic,
+   * the number of entries, then per entry the two hash words, the solve time, the canonical
+   * records and the encoded result. The least recently used entries of each shard come first, so
+   * Load() restores the LRU order.
+   */
+  void Save(const std::string& path) const {
+    ByteWriter file;
+    file.Put(kFileMagic);
+    const std::size_t count_offset = file.size();
+    file.Put<std::uint64_t>(0);
+    std::uint64_t count = 0;
+    for (const Shard& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      for (auto it = shard.entries.rbegin(); it != shard.entries.rend(); ++it, ++count) {
+        file.Put<std::uint64_t>(it->hash.high);
+        file.Put<std::uint64_t>(it->hash.low);
+        file.Put<double>(it->solve_seconds);
+        file.PutString(it->canonical);
+        file.PutString(it->bytes);
+      }
+    }
+    file.PutAt<std::uint64_t>(count_offset, count);
+    const std::string temporary = path + ".tmp";
+    {
+      std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+      out.write(file.bytes().data(), file.bytes().size());
+      if (!out) {
+        throw std::runtime_error("ResultCache::Save: failed to write " + temporary);
+      }
+    }
+    std::filesystem::rename(temporary, path);
+  }
+
+  // Adds the entries of a file written by Save(), evicting as usual if they do not fit.
+  void Load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+      throw std::runtime_error("ResultCache::Load: cannot open " + path);
+    }
+    const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    ByteReader reader(bytes);
+    char magic[sizeof(kFileMagic)];
+    for (char& c : magic) {
+      c = reader.Get<char>();
+    }
+    if (std::memcmp(magic, kFileMagic, sizeof(magic)) != 0) {
+      throw std::runtime_error(path + " is not a result cache file of this version.");
+    }
+    const auto num_entries = reader.Get<std::uint64_t>();
+    for (std::uint64_t i = 0; i < num_entries; ++i) {
+      ProgramHash hash;
+      hash.high = reader.Get<std::uint64_t>();
+      hash.low = reader.Get<std::uint64_t>();
+      const double solve_seconds = reader.Get<double>();
+      std::string canonical = reader.GetString();
+      Insert(hash, std::move(canonical), reader.GetString(), solve_seconds);
+    }
+  }
+
+ private:
+  // The last character is the format version.
+  static constexpr char kFileMagic[8] = {'D', 'T', 'R', 'C', 'A', 'C', 'H', '2'};
+
+  struct Entry {
+    ProgramHash hash;
+    std::string canonical;
+    std::string bytes;
+    double solve_seconds{0};
+
+    std::size_t size() const { return canonical.size() + bytes.size(); }
+  };
+
+  // Most recently used entries first.
+  struct Shard {
+    mutable std::mutex mutex;
+    std::list<Entry> entries;
+    std::unordered_map<ProgramHash, std::list<Entry>::iterator, ProgramHashHasher> index;
+    std::size_t bytes{0};
+    std::int64_t hits{0};
+    std::int64_t misses{0};
+    std::int64_t evictions{0};
+    double saved_seconds{0};
+  };
+
+  Shard& ShardOf(const ProgramHash& hash) { return shards_[hash.high % shards_.size()]; }
+
+  void Insert(const ProgramHash& hash, std::string canonical, std::string bytes,
+              double solve_seconds) {
+    Shard& shard = ShardOf(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const auto it = shard.index.find(hash);
+    if (it != shard.index.end()) {
+      shard.bytes -= it->second->size();
+      shard.entries.erase(it->second);
+      shard.index.erase(it);
+    }
+    shard.entries.push_front(Entry{hash, std::move(canonical), std::move(bytes), solve_seconds});
+    shard.bytes += shard.entries.front().size();
+    shard.index.emplace(hash, shard.entries.begin());
+    // The newest entry stays even if it alone exceeds the budget.
+    while (shard.bytes > max_shard_bytes_ && shard.entries.size() > 1) {
+      shard.bytes -= shard.entries.back().size();
+      shard.index.erase(shard.entries.back().hash);
+      shard.entries.pop_back();
+      ++shard.evictions;
+    }
+  }
+
+  std::vector<Shard> shards_;
+  std::size_t max_shard_bytes_;
+};
+
+// Whether a result is worth caching: a solution, or a verdict of the solver that solving again
+// would repeat. Iteration limits, solver errors and the like may go differently next time.
+inline bool IsCacheableResult(const drake::solvers::MathematicalProgramResult& result) {
+  using drake::solvers::SolutionResult;
+  switch (result.get_solution_result()) {
+    case SolutionResult::kSolutionFound:
+    case SolutionResult::kInfeasibleConstraints:
+    case SolutionResult::kUnbounded:
+    case SolutionResult::kInfeasibleOrUnbounded:
+    case SolutionResult::kDualInfeasible:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/*
+ * Solves `prog` unless `cache` holds a result for its canonical form, and stores new results
+ * that pass IsCacheableResult(). Programs without a canonical form are solved every time. The
+ * solver is chosen with ChooseBestSolver() on a miss; a hit returns the cached result, which
+ * names the solver that produced it.
+ */
+inline drake::solvers::MathematicalProgramResult CachedSolve(
+    const drake::solvers::MathematicalProgram& prog, ResultCache* cache,
+    const std::optional<Eigen::VectorXd>& initial_guess = std::nullopt,
+    const std::optional<drake::solvers::SolverOptions>& solver_options = std::nullopt) {
+  const std::optional<CanonicalProgram> key = CanonicalizeProgram(prog, initial_guess);
+  if (key) {
+    if (auto result = cache->Find(*key, prog)) {
+      return std::move(*result);
+    }
+  }
+  const auto solver = drake::solvers::MakeSolver(drake::solvers::ChooseBestSolver(prog));
+  drake::solvers::MathematicalProgramResult result;
+  const auto start = std::chrono::steady_clock::now();
+  SolveConcurrently(*solver, prog, initial_guess, solver_options, &result);
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (key && IsCacheableResult(result)) {
+    cache->Insert(*key, prog, result, seconds);
+  }
+  return result;
+}
+
+}  // namespace drake_tutorials
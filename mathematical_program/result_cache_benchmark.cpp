@@ -0,0 +1,167 @@
+#include <drake/solvers/choose_best_solver.h>
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/solve.h>
+
+#include <gflags/gflags.h>
+
+#include "benchmark_statistics.h"
+#include "result_cache.h"
+#include "solver_concurrency.h"
+#include "thread_pool.h"
+#include "tutorial_programs.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+DEFINE_int32(requests, 20000, "Number of solve requests in the workload.");
+DEFINE_int32(distinct, 200, "Number of distinct programs the requests are drawn from.");
+DEFINE_double(zipf, 1.1, "Exponent of the Zipf distribution over the distinct programs.");
+DEFINE_int32(num_threads, 1,
+             "Number of worker threads; 0 means one per hardware thread. See "
+             "solver_concurrency.h for when Ipopt solves run in parallel.");
+DEFINE_string(path, "/tmp/result_cache_benchmark.cache", "Where the cache is saved.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+double MicrosecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Program `id` is tutorial program id % 5 with its data shifted by id / 5, built afresh for every
+// request as a client would, with the tutorial's initial guess.
+struct Request {
+  std::unique_ptr<drake::solvers::MathematicalProgram> prog;
+  std::optional<Eigen::VectorXd> initial_guess;
+};
+
+Request MakeRequest(int id) {
+  const double shift = 0.01 * (id / 5);
+  switch (id % 5) {
+    case 0:
+      return {drake_tutorials::MakeFeasibleProgram(1 + shift), std::nullopt};
+    case 1:
+      return {drake_tutorials::MakeInfeasibleProgram(1 + shift), std::nullopt};
+    case 2: {
+      Request request{drake_tutorials::MakeLinearProgram(), Eigen::Vector2d(1, 1)};
+      // The tutorial LP has no data to shift; the initial guess tells its instances apart.
+      (*request.initial_guess)(0) += shift;
+      return request;
+    }
+    case 3:
+      return {drake_tutorials::MakeCircleProgram(100 + shift), Eigen::Vector2d(-5, 0)};
+    default:
+      return {drake_tutorials::MakeBilinearProgram(9 + shift), Eigen::Vector2d(4, 5)};
+  }
+}
+
+std::vector<int> MakeWorkload() {
+  std::vector<double> weights(FLAGS_distinct);
+  for (int i = 0; i < FLAGS_distinct; ++i) {
+    weights[i] = 1 / std::pow(i + 1, FLAGS_zipf);
+  }
+  std::mt19937 generator(0);
+  std::discrete_distribution<int> zipf(weights.begin(), weights.end());
+  std::vector<int> workload(FLAGS_requests);
+  for (int& id : workload) {
+    id = zipf(generator);
+  }
+  return workload;
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  drake::solvers::SolverOptions options;
+  options.SetOption(drake::solvers::IpoptSolver::id(), "print_level", 0);
+  const std::vector<int> workload = MakeWorkload();
+  drake_tutorials::ThreadPool pool(FLAGS_num_threads > 0
+                                       ? FLAGS_num_threads
+                                       : drake_tutorials::ThreadPool::DefaultNumThreads());
+
+  // Single-threaded costs: canonical hashing and a cache hit next to the cheapest solve.
+  {
+    drake_tutorials::ResultCache cache;
+    std::vector<double> hash_us, hit_us, solve_us;
+    for (int repetition = 0; repetition < 200; ++repetition) {
+      const Request request = MakeRequest(0);
+      auto start = std::chrono::steady_clock::now();
+      const auto key = drake_tutorials::CanonicalizeProgram(*request.prog, request.initial_guess);
+      hash_us.push_back(MicrosecondsSince(start));
+      start = std::chrono::steady_clock::now();
+      const auto result = drake::solvers::Solve(*request.prog, request.initial_guess, options);
+      solve_us.push_back(MicrosecondsSince(start));
+      cache.Insert(*key, *request.prog, result, solve_us.back() * 1e-6);
+      start = std::chrono::steady_clock::now();
+      cache.Find(*key, *request.prog);
+      hit_us.push_back(MicrosecondsSince(start));
+    }
+    using drake_tutorials::Percentile;
+    print("simple_optimization_problem_feasible: canonical hash ", Percentile(hash_us, 0.5),
+          " us, cache hit ", Percentile(hit_us, 0.5), " us, Solve() ", Percentile(solve_us, 0.5),
+          " us (medians)");
+  }
+
+  // The workload on the pool, with and without the cache.
+  drake_tutorials::ResultCache cache;
+  std::vector<drake::solvers::MathematicalProgramResult> cached(workload.size());
+  auto start = std::chrono::steady_clock::now();
+  pool.ParallelFor(workload.size(), [&](int, int i) {
+    const Request request = MakeRequest(workload[i]);
+    cached[i] =
+        drake_tutorials::CachedSolve(*request.prog, &cache, request.initial_guess, options);
+  });
+  const double cached_seconds = MicrosecondsSince(start) * 1e-6;
+  const auto statistics = cache.statistics();
+
+  std::vector<drake::solvers::MathematicalProgramResult> solved(workload.size());
+  start = std::chrono::steady_clock::now();
+  pool.ParallelFor(workload.size(), [&](int, int i) {
+    const Request request = MakeRequest(workload[i]);
+    const auto solver =
+        drake::solvers::MakeSolver(drake::solvers::ChooseBestSolver(*request.prog));
+    drake_tutorials::SolveConcurrently(*solver, *request.prog, request.initial_guess, options,
+                                       &solved[i]);
+  });
+  const double uncached_seconds = MicrosecondsSince(start) * 1e-6;
+
+  double difference = 0;
+  for (size_t i = 0; i < workload.size(); ++i) {
+    if (cached[i].get_solution_result() != solved[i].get_solution_result()) {
+      difference = INFINITY;
+    } else if (cached[i].is_success()) {
+      difference = std::max(
+          difference, (cached[i].get_x_val() - solved[i].get_x_val()).cwiseAbs().maxCoeff());
+    }
+  }
+  print(workload.size(), " requests over ", FLAGS_distinct, " programs on ", pool.num_threads(),
+        " thread(s): hit rate ", statistics.hit_rate(), ", ", statistics.entries, " entries, ",
+        statistics.bytes, " bytes, ", statistics.saved_seconds, " s of solves saved");
+  print("  with the cache ", cached_seconds, " s, without ", uncached_seconds, " s, speedup ",
+        uncached_seconds / cached_seconds, "x; largest difference to uncached solves ",
+        difference);
+
+  // Persistence: a fresh cache loaded from disk answers the workload without solving.
+  cache.Save(FLAGS_path);
+  drake_tutorials::ResultCache loaded;
+  start = std::chrono::steady_clock::now();
+  loaded.Load(FLAGS_path);
+  const double load_seconds = MicrosecondsSince(start) * 1e-6;
+  pool.ParallelFor(workload.size(), [&](int, int i) {
+    const Request request = MakeRequest(workload[i]);
+    drake_tutorials::CachedSolve(*request.prog, &loaded, request.initial_guess, options);
+  });
+  print("  reloaded ", loaded.statistics().entries, " entries from ", FLAGS_path, " in ",
+        load_seconds, " s; hit rate on the replayed workload ", loaded.statistics().hit_rate());
+  return difference <= 1e-9 ? 0 : 1;
+}
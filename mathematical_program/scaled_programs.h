@@ -0,0 +1,220 @@
+#pragma once
+
+#include <drake/solvers/constraint.h>
+#include <drake/solvers/mathematical_program.h>
+
+#include "tutorial_programs.h"
+
+#include <Eigen/SparseCore>
+
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace drake_tutorials {
+
+namespace internal {
+
+// The (n - 1) x n matrix with rows e_i' + sign * e_{i+1}'.
+inline Eigen::SparseMatrix<double> NeighborDifferences(int n, double sign) {
+  std::vector<Eigen::Triplet<double>> triplets;
+  triplets.reserve(2 * (n - 1));
+  for (int i = 0; i + 1 < n; ++i) {
+    triplets.emplace_back(i, i, 1);
+    triplets.emplace_back(i, i + 1, sign);
+  }
+  Eigen::SparseMatrix<double> A(n - 1, n);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  return A;
+}
+
+// One quadratic cost weight * x(i)^2 per variable.
+inline void AddSeparableQuadraticCost(const drake::solvers::VectorXDecisionVariable& x,
+                                      const std::function<double(int)>& weight,
+                                      drake::solvers::MathematicalProgram* prog) {
+  for (int i = 0; i < x.size(); ++i) {
+    prog->AddQuadraticCost(drake::Vector1d(2 * weight(i)), drake::Vector1d(0), x.segment(i, 1));
+  }
+}
+
+}  // namespace internal
+
+/*
+ * simple_optimization_problem_feasible.cpp with sum and chained inequality constraints:
+ *    min sum_i x(i)^2
+ * subject to sum_i x(i) = b
+ *            x(i) <= x(i + 1)
+ */
+inline std::unique_ptr<drake::solvers::MathematicalProgram> MakeScaledFeasibleProgram(
+    int n, double b = 1) {
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  const auto x = prog->NewContinuousVariables(n, "x");
+  prog->AddLinearEqualityConstraint(Eigen::RowVectorXd::Ones(n), drake::Vector1d(b), x);
+  if (n > 1) {
+    prog->AddLinearConstraint(internal::NeighborDifferences(n, -1),
+                              Eigen::VectorXd::Constant(n - 1,
+                                                        -std::numeric_limits<double>::infinity()),
+                              Eigen::VectorXd::Zero(n - 1), x);
+  }
+  internal::AddSeparableQuadraticCost(x, [](int) { return 1.0; }, prog.get());
+  return prog;
+}
+
+/*
+ * simple_optimization_problem_infeasible.cpp along a chain:
+ *    min x(0)
+ * subject to x(i) + x(i + 1) >= lower
+ *            x(i) + x(i + 1) <= 0
+ */
+inline std::unique_ptr<drake::solvers::MathematicalProgram> MakeScaledInfeasibleProgram(
+    int n, double lower = 1) {
+  const double kInf = std::numeric_limits<double>::infinity();
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  const auto x = prog->NewContinuousVariables(std::max(2, n), "x");
+  const Eigen::SparseMatrix<double> A = internal::NeighborDifferences(x.size(), 1);
+  prog->AddLinearConstraint(A, Eigen::VectorXd::Constant(A.rows(), lower),
+                            Eigen::VectorXd::Constant(A.rows(), kInf), x);
+  prog->AddLinearConstraint(A, Eigen::VectorXd::Constant(A.rows(), -kInf),
+                            Eigen::VectorXd::Zero(A.rows()), x);
+  prog->AddLinearCost(Eigen::VectorXd::Unit(x.size(), 0), x);
+  return prog;
+}
+
+/*
+ * manually_choosing_a_solver.cpp, once per pair:
+ *    min sum_k x(2k)
+ * subject to x(2k) + x(2k + 1) = 1
+ *            0 <= x(2k + 1) <= 1
+ */
+inline std::unique_ptr<drake::solvers::MathematicalProgram> MakeScaledLinearProgram(int n) {
+  const int num_pairs = std::max(1, n / 2);
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  const auto x = prog->NewContinuousVariables(2 * num_pairs, "x");
+  std::vector<Eigen::Triplet<double>> triplets;
+  Eigen::VectorXd cost = Eigen::VectorXd::Zero(x.size());
+  drake::solvers::VectorXDecisionVariable odd(num_pairs);
+  for (int k = 0; k < num_pairs; ++k) {
+    triplets.emplace_back(k, 2 * k, 1);
+    triplets.emplace_back(k, 2 * k + 1, 1);
+    cost(2 * k) = 1;
+    odd(k) = x(2 * k + 1);
+  }
+  Eigen::SparseMatrix<double> A(num_pairs, x.size());
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  prog->AddLinearEqualityConstraint(A, Eigen::VectorXd::Ones(num_pairs), x);
+  prog->AddBoundingBoxConstraint(0, 1, odd);
+  prog->AddLinearCost(cost, x);
+  return prog;
+}
+
+/*
+ * good_or_bad_initial_guess.cpp on a sphere:
+ *    min sum_k x(2k)^2 - x(2k + 1)^2
+ * subject to sum_i x(i)^2 = radius_squared
+ * with the squared norm split over the pairs by auxiliary variables s(k), which follow the x:
+ *    x(2k)^2 + x(2k + 1)^2 = s(k)
+ *    sum_k s(k) = radius_squared
+ * One constraint over all N variables would be evaluated through AutoDiff with N-wide gradients
+ * by the NLP solvers, O(N^2) time and memory per evaluation; the pairs keep every gradient
+ * three wide.
+ */
+inline std::unique_ptr<drake::solvers::MathematicalProgram> MakeScaledSphereProgram(
+    int n, double radius_squared = 100) {
+  const int num_pairs = std::max(1, n / 2);
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  const auto x = prog->NewContinuousVariables(2 * num_pairs, "x");
+  const auto s = prog->NewContinuousVariables(num_pairs, "s");
+  // All pairs share one evaluator of x(2k)^2 + x(2k + 1)^2 - s(k).
+  const auto constraint = std::make_shared<drake::solvers::QuadraticConstraint>(
+      Eigen::Vector3d(2, 2, 0).asDiagonal().toDenseMatrix(), Eigen::Vector3d(0, 0, -1), 0, 0);
+  for (int k = 0; k < num_pairs; ++k) {
+    prog->AddConstraint(constraint,
+                        drake::solvers::VectorDecisionVariable<3>(x(2 * k), x(2 * k + 1), s(k)));
+  }
+  prog->AddLinearEqualityConstraint(Eigen::RowVectorXd::Ones(num_pairs),
+                                    drake::Vector1d(radius_squared), s);
+  internal::AddSeparableQuadraticCost(x, [](int i) { return i % 2 == 0 ? 1.0 : -1.0; },
+                                      prog.get());
+  return prog;
+}
+
+/*
+ * add_callback.cpp, once per pair:
+ *    min sum_i x(i)^2
+ * subject to x(2k) * x(2k + 1) = product
+ */
+inline std::unique_ptr<drake::solvers::MathematicalProgram> MakeScaledBilinearProgram(
+    int n, double product = 9) {
+  const int num_pairs = std::max(1, n / 2);
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  const auto x = prog->NewContinuousVariables(2 * num_pairs, "x");
+  // All pairs share one evaluator.
+  const auto constraint = std::make_shared<drake::solvers::QuadraticConstraint>(
+      (Eigen::Matrix2d() << 0, 1, 1, 0).finished(), Eigen::Vector2d::Zero(), product, product);
+  for (int k = 0; k < num_pairs; ++k) {
+    prog->AddConstraint(constraint, x.segment(2 * k, 2));
+  }
+  internal::AddSeparableQuadraticCost(x, [](int) { return 1.0; }, prog.get());
+  return prog;
+}
+
+/*
+ * The N-dimensional generalizations of the tutorial programs above, for measuring how
+ * construction and solves scale. They are built from sparse linear constraints and per-variable or
+ * per-pair costs and constraints, never from symbolic expressions or dense matrices over all N
+ * variables, so that programs with a million variables fit in memory. The programs over pairs of
+ * variables round N down to an even number; the sphere program adds one auxiliary variable per
+ * pair.
+ */
+struct ScaledProgram {
+  // The name of the tutorial program it generalizes.
+  std::string name;
+  std::function<std::unique_ptr<drake::solvers::MathematicalProgram>(int n)> build;
+  // The tutorial's initial guess, repeated over the pairs of a built program; nullopt if the
+  // tutorial has none.
+  std::function<std::optional<Eigen::VectorXd>(const drake::solvers::MathematicalProgram&)>
+      initial_guess;
+};
+
+inline std::vector<ScaledProgram> GetScaledPrograms() {
+  const auto pairs = [](double even, double odd) {
+    return [even, odd](const drake::solvers::MathematicalProgram& prog) {
+      return std::optional<Eigen::VectorXd>(Eigen::VectorXd::NullaryExpr(
+          prog.num_vars(), [even, odd](Eigen::Index i) { return i % 2 == 0 ? even : odd; }));
+    };
+  };
+  const auto none = [](const drake::solvers::MathematicalProgram&) {
+    return std::optional<Eigen::VectorXd>();
+  };
+  std::vector<ScaledProgram> programs;
+  programs.push_back({"simple_optimization_problem_feasible",
+                      [](int n) { return MakeScaledFeasibleProgram(n); }, none});
+  programs.push_back({"simple_optimization_problem_infeasible",
+                      [](int n) { return MakeScaledInfeasibleProgram(n); }, none});
+  programs.push_back(
+      {"manually_choosing_a_solver", [](int n) { return MakeScaledLinearProgram(n); },
+       pairs(1, 1)});
+  // (-5, 0) scaled so that the guess keeps the tutorial's norm of 5, followed by the matching
+  // squared norms of the pairs.
+  programs.push_back({"good_or_bad_initial_guess",
+                      [](int n) { return MakeScaledSphereProgram(n); },
+                      [](const drake::solvers::MathematicalProgram& prog) {
+                        const int num_pairs = prog.num_vars() / 3;
+                        const double even = -5 / std::sqrt(num_pairs);
+                        Eigen::VectorXd guess = Eigen::VectorXd::Zero(prog.num_vars());
+                        for (int k = 0; k < num_pairs; ++k) {
+                          guess(2 * k) = even;
+                          guess(2 * num_pairs + k) = even * even;
+                        }
+                        return std::optional<Eigen::VectorXd>(guess);
+                      }});
+  programs.push_back(
+      {"add_callback", [](int n) { return MakeScaledBilinearProgram(n); }, pairs(4, 5)});
+  return programs;
+}
+
+}  // namespace drake_tutorials
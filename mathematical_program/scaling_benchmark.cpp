@@ -0,0 +1,256 @@
+#include <drake/solvers/choose_best_solver.h>
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/osqp_solver.h>
+#include <drake/solvers/scs_solver.h>
+#include <drake/solvers/solver_interface.h>
+
+#include <gflags/gflags.h>
+
+#include "scaled_programs.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+DEFINE_string(sizes, "10,100,1000,10000,100000,1000000", "Comma-separated numbers of variables.");
+DEFINE_int32(max_solve_vars, 100000,
+             "Larger programs are only built, not solved; 0 means no limit.");
+DEFINE_string(solvers, "", "Comma-separated solver names; empty means every available solver.");
+DEFINE_string(csv, "scaling_benchmark.csv", "Path of the CSV report.");
+DEFINE_string(json, "scaling_benchmark.json", "Path of the JSON report.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+// One row per (program, size, solver); the build columns repeat for every solver of a program,
+// and a program that is not solved gets one row without a solver.
+struct Measurement {
+  std::string program;
+  int num_vars{0};
+  int num_constraints{0};
+  double build_time_s{NAN};
+  long build_peak_rss_kb{-1};
+  std::string solver;
+  std::string solution_result;
+  bool success{false};
+  double solve_time_s{NAN};
+  long solve_peak_rss_kb{-1};
+  // -1 if the solver does not report its iteration count.
+  int iterations{-1};
+};
+
+std::vector<std::string> Split(const std::string& list) {
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  for (std::string item; std::getline(stream, item, ',');) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+// Writing 5 to clear_refs resets the peak resident set size (VmHWM) of the process to its current
+// size, so every phase gets its own peak. Linux only; -1 elsewhere.
+void ResetPeakRss() { std::ofstream("/proc/self/clear_refs") << "5"; }
+
+long PeakRssKb() {
+  std::ifstream status("/proc/self/status");
+  for (std::string line; std::getline(status, line);) {
+    if (line.rfind("VmHWM:", 0) == 0) {
+      return std::stol(line.substr(6));
+    }
+  }
+  return -1;
+}
+
+// Ipopt reports every iteration through the visualization callbacks, OSQP and SCS through their
+// solver details. The other solvers do not expose an iteration count.
+int CountIterations(const drake::solvers::MathematicalProgramResult& result,
+                    int ipopt_callback_count) {
+  const auto& id = result.get_solver_id();
+  if (id == drake::solvers::IpoptSolver::id()) {
+    return ipopt_callback_count;
+  }
+  if (id == drake::solvers::OsqpSolver::id()) {
+    return result.get_solver_details<drake::solvers::OsqpSolver>().iter;
+  }
+  if (id == drake::solvers::ScsSolver::id()) {
+    return result.get_solver_details<drake::solvers::ScsSolver>().iter;
+  }
+  return -1;
+}
+
+std::string JsonNumber(double value) {
+  if (!std::isfinite(value)) {
+    return "null";
+  }
+  std::ostringstream out;
+  out.precision(17);
+  out << value;
+  return out.str();
+}
+
+std::string JsonString(const std::string& value) {
+  std::string out = "\"";
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+    }
+    out += (c == '\n') ? ' ' : c;
+  }
+  return out + "\"";
+}
+
+// Quotes fields with commas or quotes, such as solver error messages.
+std::string CsvField(const std::string& value) {
+  if (value.find_first_of(",\"\n") == std::string::npos) {
+    return value;
+  }
+  std::string out = "\"";
+  for (char c : value) {
+    out += c == '"' ? std::string("\"\"") : std::string(1, c == '\n' ? ' ' : c);
+  }
+  return out + "\"";
+}
+
+void WriteCsv(const std::vector<Measurement>& measurements, const std::string& path) {
+  std::ofstream out(path);
+  out.precision(9);
+  out << "program,num_vars,num_constraints,build_time_s,build_peak_rss_kb,solver,"
+         "solution_result,success,solve_time_s,solve_peak_rss_kb,iterations\n";
+  for (const Measurement& m : measurements) {
+    out << m.program << ',' << m.num_vars << ',' << m.num_constraints << ',' << m.build_time_s
+        << ',' << m.build_peak_rss_kb << ',' << m.solver << ','
+        << CsvField(m.solution_result) << ',' << m.success << ',';
+    if (!m.solver.empty()) {
+      out << m.solve_time_s << ',' << m.solve_peak_rss_kb << ',' << m.iterations;
+    } else {
+      out << ",,";
+    }
+    out << '\n';
+  }
+}
+
+void WriteJson(const std::vector<Measurement>& measurements, const std::string& path) {
+  std::ofstream out(path);
+  out << "{\n  \"measurements\": [";
+  for (size_t i = 0; i < measurements.size(); ++i) {
+    const Measurement& m = measurements[i];
+    out << (i == 0 ? "\n" : ",\n") << "    {\"program\": " << JsonString(m.program)
+        << ", \"num_vars\": " << m.num_vars << ", \"num_constraints\": " << m.num_constraints
+        << ", \"build_time_s\": " << JsonNumber(m.build_time_s)
+        << ", \"build_peak_rss_kb\": " << m.build_peak_rss_kb;
+    if (!m.solver.empty()) {
+      out << ", \"solver\": " << JsonString(m.solver)
+          << ", \"solution_result\": " << JsonString(m.solution_result)
+          << ", \"success\": " << (m.success ? "true" : "false")
+          << ", \"solve_time_s\": " << JsonNumber(m.solve_time_s)
+          << ", \"solve_peak_rss_kb\": " << m.solve_peak_rss_kb << ", \"iterations\": "
+          << (m.iterations >= 0 ? std::to_string(m.iterations) : "null");
+    }
+    out << "}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  drake::solvers::SolverOptions options;
+  options.SetOption(drake::solvers::IpoptSolver::id(), "print_level", 0);
+
+  // Ipopt goes last, since the callback that counts its iterations makes the program unsolvable
+  // for solvers without callback support.
+  const std::vector<std::string> names = Split(FLAGS_solvers);
+  std::vector<std::unique_ptr<drake::solvers::SolverInterface>> solvers;
+  for (const auto& id : drake::solvers::GetKnownSolvers()) {
+    auto solver = drake::solvers::MakeSolver(id);
+    if (solver->available() && solver->enabled() &&
+        (names.empty() || std::find(names.begin(), names.end(), id.name()) != names.end())) {
+      solvers.push_back(std::move(solver));
+    }
+  }
+  std::stable_partition(solvers.begin(), solvers.end(), [](const auto& solver) {
+    return solver->solver_id() != drake::solvers::IpoptSolver::id();
+  });
+
+  std::vector<Measurement> measurements;
+  for (const auto& size : Split(FLAGS_sizes)) {
+    const int n = std::stoi(size);
+    for (const auto& scaled : drake_tutorials::GetScaledPrograms()) {
+      Measurement build;
+      build.program = scaled.name;
+      ResetPeakRss();
+      const auto start = std::chrono::steady_clock::now();
+      auto prog = scaled.build(n);
+      build.build_time_s =
+          std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      build.build_peak_rss_kb = PeakRssKb();
+      build.num_vars = prog->num_vars();
+      build.num_constraints = prog->GetAllConstraints().size();
+      print(build.program, ", ", build.num_vars, " variables: built in ", build.build_time_s,
+            " s, peak RSS ", build.build_peak_rss_kb, " kB");
+
+      const auto initial_guess = scaled.initial_guess(*prog);
+      int callback_count = 0;
+      bool solved = false;
+      for (const auto& solver : solvers) {
+        if (FLAGS_max_solve_vars > 0 && prog->num_vars() > FLAGS_max_solve_vars) {
+          break;
+        }
+        if (solver->solver_id() == drake::solvers::IpoptSolver::id()) {
+          prog->AddVisualizationCallback(
+              [&callback_count](const Eigen::Ref<const Eigen::VectorXd>&) { ++callback_count; },
+              prog->decision_variables());
+        }
+        if (!solver->AreProgramAttributesSatisfied(*prog)) {
+          continue;
+        }
+        Measurement m = build;
+        m.solver = solver->solver_id().name();
+        callback_count = 0;
+        drake::solvers::MathematicalProgramResult result;
+        ResetPeakRss();
+        const auto solve_start = std::chrono::steady_clock::now();
+        try {
+          solver->Solve(*prog, initial_guess, options, &result);
+        } catch (const std::exception& e) {
+          m.solution_result = std::string("error: ") + e.what();
+          measurements.push_back(m);
+          solved = true;
+          continue;
+        }
+        m.solve_time_s =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - solve_start).count();
+        m.solve_peak_rss_kb = PeakRssKb();
+        std::ostringstream solution_result;
+        solution_result << result.get_solution_result();
+        m.solution_result = solution_result.str();
+        m.success = result.is_success();
+        m.iterations = CountIterations(result, callback_count);
+        print("  ", m.solver, ": ", m.solution_result, " in ", m.solve_time_s, " s, ",
+              m.iterations, " iterations, peak RSS ", m.solve_peak_rss_kb, " kB");
+        measurements.push_back(m);
+        solved = true;
+      }
+      if (!solved) {
+        measurements.push_back(build);
+      }
+    }
+  }
+
+  WriteCsv(measurements, FLAGS_csv);
+  WriteJson(measurements, FLAGS_json);
+  print("Wrote ", FLAGS_csv, " and ", FLAGS_json);
+  return 0;
+}
@@ -0,0 +1,496 @@
+#pragma once
+
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/solve.h>
+
+#include <Eigen/Cholesky>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace drake_tutorials {
+
+// Programs with at most this many variables are candidates for SolveSmallQp().
+constexpr int kMaxSmallQpDimension = 50;
+
+enum class SmallQpStatus {
+  kSolved,
+  kInfeasible,
+  // The Hessian is not positive definite.
+  kNotStrictlyConvex,
+  kIterationLimit,
+  // More constraints became active than there are variables, which only happens when
+  // numerically dependent constraints pass the independence test.
+  kDegenerate,
+};
+
+namespace internal {
+
+// Dimensions up to this are solved with fixed-size matrices; larger ones use dynamic sizes.
+constexpr int kMaxFixedSmallQpDimension = 12;
+
+/*
+ * Dual active-set method of Goldfarb and Idnani for the strictly convex QP
+ *    min 0.5 x'Gx + g'x
+ * subject to n_i'x = b_i  for i < num_equalities
+ *            n_i'x >= b_i for the other columns n_i of `normals`.
+ *
+ * Starting from the unconstrained minimum, it adds the most violated constraint, stepping along
+ * the primal direction that keeps the active constraints satisfied and dropping active
+ * constraints whose multiplier would turn negative, until no constraint is violated. Every
+ * iterate is optimal for its active set, so no feasible starting point is needed. The reduced
+ * Hessian is re-factored from the active set at each step, which is cheaper than maintaining
+ * factor updates at these sizes. `N` is the number of variables or Eigen::Dynamic; the
+ * matrices sized by the active set have N as their maximum size and live on the stack for a
+ * fixed N.
+ *
+ * `multipliers` receives u >= 0 for the inequalities and u for the equalities, with
+ * G x + g = sum_i u_i n_i.
+ *
+ * `warm_active` warm starts the method with a guess of the optimal active set, e.g. the one of a
+ * neighbouring QP: its violated inequalities are added first, in order, before the most violated
+ * ones. A good guess saves the steps that add constraints only to drop them again; a wrong one
+ * only costs iterations, the solution is the same.
+ */
+template <int N>
+class GoldfarbIdnani {
+ public:
+  using Vector = Eigen::Matrix<double, N, 1>;
+  using Matrix = Eigen::Matrix<double, N, N>;
+  using Normals = Eigen::Matrix<double, N, Eigen::Dynamic>;
+
+  GoldfarbIdnani(const Matrix& G, const Vector& g, const Normals& normals, const Eigen::VectorXd& b,
+                 int num_equalities, double tolerance = 1e-10)
+      : llt_(G),
+        g_(g),
+        normals_(normals),
+        b_(b),
+        num_equalities_(num_equalities),
+        tolerance_(tolerance) {}
+
+  SmallQpStatus Solve(Vector* x, Eigen::VectorXd* multipliers,
+                      const std::vector<int>& warm_active = {}) {
+    const int n = g_.size();
+    const int m = normals_.cols();
+    if (llt_.info() != Eigen::Success || (llt_.matrixLLT().diagonal().array() <= 0).any()) {
+      return SmallQpStatus::kNotStrictlyConvex;
+    }
+    *x = -llt_.solve(g_);
+    multipliers->setZero(m);
+    active_.clear();
+    const int max_iterations = 10 * (n + m) + 10;
+    int next_equality = 0;
+    std::size_t next_warm = 0;
+    for (int iteration = 0; iteration < max_iterations;) {
+      // The next equality, or else the next violated inequality of `warm_active`, or else the
+      // most violated inequality.
+      int p = -1;
+      if (next_equality < num_equalities_) {
+        p = next_equality++;
+      }
+      while (p < 0 && next_warm < warm_active.size()) {
+        const int i = warm_active[next_warm++];
+        if (i >= num_equalities_ && i < m &&
+            std::find(active_.begin(), active_.end(), i) == active_.end() &&
+            Slack(*x, i) < -tolerance_ * (1 + std::abs(b_(i)))) {
+          p = i;
+        }
+      }
+      if (p < 0) {
+        double worst = 0;
+        for (int i = num_equalities_; i < m; ++i) {
+          const double s = Slack(*x, i);
+          if (s < worst - tolerance_ * (1 + std::abs(b_(i)))) {
+            worst = s;
+            p = i;
+          }
+        }
+        if (p < 0) {
+          return SmallQpStatus::kSolved;
+        }
+      }
+      const SmallQpStatus added = Add(p, x, multipliers, &iteration, max_iterations);
+      if (added != SmallQpStatus::kSolved) {
+        return added;
+      }
+    }
+    return SmallQpStatus::kIterationLimit;
+  }
+
+ private:
+  using ActiveVector = Eigen::Matrix<double, Eigen::Dynamic, 1, 0, N, 1>;
+  using ActiveMatrix = Eigen::Matrix<double, N, Eigen::Dynamic, 0, N, N>;
+  using ReducedMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, N, N>;
+
+  double Slack(const Vector& x, int i) const { return normals_.col(i).dot(x) - b_(i); }
+
+  // The primal step z = H n_p within the active set and the change r = N* n_p of the active
+  // multipliers per unit step.
+  void Directions(int p, Vector* z, ActiveVector* r) const {
+    const Vector Ginv_np = llt_.solve(normals_.col(p));
+    const int k = active_.size();
+    if (k == 0) {
+      *z = Ginv_np;
+      r->resize(0);
+      return;
+    }
+    ActiveMatrix A(g_.size(), k);
+    for (int i = 0; i < k; ++i) {
+      A.col(i) = normals_.col(active_[i]);
+    }
+    const ActiveMatrix Ginv_A = llt_.solve(A);
+    const ReducedMatrix M = A.transpose() * Ginv_A;
+    *r = M.ldlt().solve(A.transpose() * Ginv_np);
+    *z = Ginv_np - Ginv_A * *r;
+  }
+
+  // Makes constraint p active. Returns kSolved once it is, or why it could not be.
+  SmallQpStatus Add(int p, Vector* x, Eigen::VectorXd* u, int* iteration, int max_iterations) {
+    const double kInf = std::numeric_limits<double>::infinity();
+    const bool equality = p < num_equalities_;
+    const double scale = 1 + std::abs(b_(p));
+    Vector z;
+    ActiveVector r;
+    double u_p = 0;
+    for (; *iteration < max_iterations; ++*iteration) {
+      const double s = Slack(*x, p);
+      Directions(p, &z, &r);
+      const double zn = z.dot(normals_.col(p));
+      const bool dependent = zn <= tolerance_ * normals_.col(p).squaredNorm();
+      if (equality) {
+        // Equalities are added before any inequality, so there is nothing to drop.
+        if (dependent) {
+          return std::abs(s) <= tolerance_ * scale ? SmallQpStatus::kSolved
+                                                   : SmallQpStatus::kInfeasible;
+        }
+        if (IsFull()) {
+          return SmallQpStatus::kDegenerate;
+        }
+        const double t = -s / zn;
+        *x += t * z;
+        UpdateActiveMultipliers(t, r, u);
+        (*u)(p) = t;
+        active_.push_back(p);
+        return SmallQpStatus::kSolved;
+      }
+      // Partial step: the largest step before an active inequality's multiplier reaches zero.
+      double t1 = kInf;
+      int k = -1;
+      for (int i = 0; i < static_cast<int>(active_.size()); ++i) {
+        if (active_[i] >= num_equalities_ && r(i) > tolerance_) {
+          const double ratio = (*u)(active_[i]) / r(i);
+          if (ratio < t1) {
+            t1 = ratio;
+            k = i;
+          }
+        }
+      }
+      // Full step: the step that satisfies constraint p.
+      const double t2 = dependent ? kInf : -s / zn;
+      if (k < 0 && dependent) {
+        return SmallQpStatus::kInfeasible;
+      }
+      const double t = std::min(t1, t2);
+      if (!dependent) {
+        *x += t * z;
+      }
+      UpdateActiveMultipliers(t, r, u);
+      u_p += t;
+      if (t2 <= t1) {
+        if (IsFull()) {
+          return SmallQpStatus::kDegenerate;
+        }
+        (*u)(p) = u_p;
+        active_.push_back(p);
+        return SmallQpStatus::kSolved;
+      }
+      (*u)(active_[k]) = 0;
+      active_.erase(active_.begin() + k);
+    }
+    return SmallQpStatus::kIterationLimit;
+  }
+
+  // True if as many constraints are active as there are variables. Independent constraints can
+  // then not be added anymore, and the active-set matrices hold at most N columns.
+  bool IsFull() const { return static_cast<int>(active_.size()) >= g_.size(); }
+
+  void UpdateActiveMultipliers(double t, const ActiveVector& r, Eigen::VectorXd* u) const {
+    for (int i = 0; i < static_cast<int>(active_.size()); ++i) {
+      (*u)(active_[i]) -= t * r(i);
+    }
+  }
+
+  const Eigen::LLT<Matrix> llt_;
+  const Vector g_;
+  const Normals& normals_;
+  const Eigen::VectorXd& b_;
+  const int num_equalities_;
+  const double tolerance_;
+  std::vector<int> active_;
+};
+
+// Rows of the program's constraints as the inequalities and equalities of GoldfarbIdnani.
+struct SmallQpRow {
+  // Index into the constraint bindings.
+  int binding;
+  int row;
+  // +1 for n'x >= lb or an equality, -1 for -n'x >= -ub.
+  double sign;
+};
+
+template <int N>
+SmallQpStatus SolveFixed(const Eigen::MatrixXd& G, const Eigen::VectorXd& g,
+                         const Eigen::MatrixXd& normals, const Eigen::VectorXd& b,
+                         int num_equalities, const std::vector<int>& warm_active,
+                         Eigen::VectorXd* x, Eigen::VectorXd* multipliers) {
+  const typename GoldfarbIdnani<N>::Normals fixed_normals = normals;
+  GoldfarbIdnani<N> qp(G, g, fixed_normals, b, num_equalities);
+  typename GoldfarbIdnani<N>::Vector fixed_x(g.size());
+  const SmallQpStatus status = qp.Solve(&fixed_x, multipliers, warm_active);
+  *x = fixed_x;
+  return status;
+}
+
+template <int... Ns>
+SmallQpStatus Dispatch(std::integer_sequence<int, Ns...>, const Eigen::MatrixXd& G,
+                       const Eigen::VectorXd& g, const Eigen::MatrixXd& normals,
+                       const Eigen::VectorXd& b, int num_equalities,
+                       const std::vector<int>& warm_active, Eigen::VectorXd* x,
+                       Eigen::VectorXd* multipliers) {
+  using Function = SmallQpStatus (*)(const Eigen::MatrixXd&, const Eigen::VectorXd&,
+                                     const Eigen::MatrixXd&, const Eigen::VectorXd&, int,
+                                     const std::vector<int>&, Eigen::VectorXd*, Eigen::VectorXd*);
+  // table[n] solves with n variables as a compile-time dimension.
+  static constexpr Function table[] = {&SolveFixed<Eigen::Dynamic>, &SolveFixed<Ns + 1>...};
+  const int n = g.size();
+  return table[n < static_cast<int>(std::size(table)) ? n : 0](G, g, normals, b, num_equalities,
+                                                               warm_active, x, multipliers);
+}
+
+}  // namespace internal
+
+// True if SolveSmallQp() accepts `prog`: at most kMaxSmallQpDimension variables, only quadratic
+// and linear costs, and only bounding box and linear (equality) constraints.
+inline bool IsSmallQp(const drake::solvers::MathematicalProgram& prog) {
+  return prog.num_vars() > 0 && prog.num_vars() <= kMaxSmallQpDimension &&
+         prog.GetAllCosts().size() == prog.quadratic_costs().size() + prog.linear_costs().size() &&
+         prog.GetAllConstraints().size() == prog.bounding_box_constraints().size() +
+                                                prog.linear_constraints().size() +
+                                                prog.linear_equality_constraints().size();
+}
+
+namespace internal {
+
+// The QP of a program accepted by IsSmallQp() in the form of GoldfarbIdnani:
+//    min 0.5 x'Gx + g'x + constant
+// subject to normals.col(i)' x = b(i) for i < num_equalities and >= b(i) for the other columns,
+// with the program constraint row behind every column.
+struct SmallQpData {
+  Eigen::MatrixXd G;
+  Eigen::VectorXd g;
+  double constant{0};
+  Eigen::MatrixXd normals;
+  Eigen::VectorXd b;
+  int num_equalities{0};
+  std::vector<SmallQpRow> rows;
+  std::vector<drake::solvers::Binding<drake::solvers::Constraint>> bindings;
+};
+
+inline SmallQpData MakeSmallQpData(const drake::solvers::MathematicalProgram& prog) {
+  const int n = prog.num_vars();
+  SmallQpData data;
+  Eigen::MatrixXd G = Eigen::MatrixXd::Zero(n, n);
+  Eigen::VectorXd g = Eigen::VectorXd::Zero(n);
+  double constant = 0;
+  for (const auto& binding : prog.quadratic_costs()) {
+    const auto indices = prog.FindDecisionVariableIndices(binding.variables());
+    const auto& cost = *binding.evaluator();
+    for (size_t i = 0; i < indices.size(); ++i) {
+      g(indices[i]) += cost.b()(i);
+      for (size_t j = 0; j < indices.size(); ++j) {
+        G(indices[i], indices[j]) += cost.Q()(i, j);
+      }
+    }
+    constant += cost.c();
+  }
+  for (const auto& binding : prog.linear_costs()) {
+    const auto indices = prog.FindDecisionVariableIndices(binding.variables());
+    for (size_t i = 0; i < indices.size(); ++i) {
+      g(indices[i]) += binding.evaluator()->a()(i);
+    }
+    constant += binding.evaluator()->b();
+  }
+  data.G = 0.5 * (G + G.transpose());
+  data.g = g;
+  data.constant = constant;
+
+  // Equalities first, then one inequality per finite bound.
+  std::vector<std::pair<Eigen::VectorXd, double>> equalities, inequalities;
+  std::vector<SmallQpRow> equality_rows, inequality_rows;
+  std::vector<drake::solvers::Binding<drake::solvers::Constraint>>& bindings = data.bindings;
+  auto add_rows = [&](const drake::solvers::Binding<drake::solvers::Constraint>& binding,
+                      const Eigen::MatrixXd& A) {
+    const int k = bindings.size();
+    bindings.push_back(binding);
+    const auto indices = prog.FindDecisionVariableIndices(binding.variables());
+    const auto& lb = binding.evaluator()->lower_bound();
+    const auto& ub = binding.evaluator()->upper_bound();
+    for (int r = 0; r < A.rows(); ++r) {
+      Eigen::VectorXd normal = Eigen::VectorXd::Zero(n);
+      for (size_t i = 0; i < indices.size(); ++i) {
+        normal(indices[i]) += A(r, i);
+      }
+      if (lb(r) == ub(r)) {
+        equalities.emplace_back(normal, lb(r));
+        equality_rows.push_back({k, r, 1});
+        continue;
+      }
+      if (std::isfinite(lb(r))) {
+        inequalities.emplace_back(normal, lb(r));
+        inequality_rows.push_back({k, r, 1});
+      }
+      if (std::isfinite(ub(r))) {
+        inequalities.emplace_back(-normal, -ub(r));
+        inequality_rows.push_back({k, r, -1});
+      }
+    }
+  };
+  for (const auto& binding : prog.bounding_box_constraints()) {
+    add_rows(binding, Eigen::MatrixXd::Identity(binding.variables().size(),
+                                                binding.variables().size()));
+  }
+  for (const auto& binding : prog.GetAllLinearConstraints()) {
+    add_rows(binding, binding.evaluator()->GetDenseA());
+  }
+  const int num_equalities = equalities.size();
+  data.num_equalities = num_equalities;
+  data.normals.resize(n, equalities.size() + inequalities.size());
+  data.b.resize(data.normals.cols());
+  for (size_t i = 0; i < equalities.size(); ++i) {
+    data.normals.col(i) = equalities[i].first;
+    data.b(i) = equalities[i].second;
+  }
+  for (size_t i = 0; i < inequalities.size(); ++i) {
+    data.normals.col(num_equalities + i) = inequalities[i].first;
+    data.b(num_equalities + i) = inequalities[i].second;
+  }
+  data.rows = std::move(equality_rows);
+  data.rows.insert(data.rows.end(), inequality_rows.begin(), inequality_rows.end());
+  return data;
+}
+
+// Solves the QP of `data` with the right-hand side `b` in place of data.b, warm started with the
+// columns `warm_active` (see GoldfarbIdnani).
+inline SmallQpStatus SolveSmallQpData(const SmallQpData& data, const Eigen::VectorXd& b,
+                                      Eigen::VectorXd* x, Eigen::VectorXd* multipliers,
+                                      const std::vector<int>& warm_active = {}) {
+  return Dispatch(std::make_integer_sequence<int, kMaxFixedSmallQpDimension>(), data.G, data.g,
+                  data.normals, b, data.num_equalities, warm_active, x, multipliers);
+}
+
+// The same with the linear cost `g` in place of data.g as well.
+inline SmallQpStatus SolveSmallQpData(const SmallQpData& data, const Eigen::VectorXd& g,
+                                      const Eigen::VectorXd& b, Eigen::VectorXd* x,
+                                      Eigen::VectorXd* multipliers,
+                                      const std::vector<int>& warm_active = {}) {
+  return Dispatch(std::make_integer_sequence<int, kMaxFixedSmallQpDimension>(), data.G, g,
+                  data.normals, b, data.num_equalities, warm_active, x, multipliers);
+}
+
+// The inequality columns of `data` that are active at `x`, as a warm start for
+// SolveSmallQpData().
+inline std::vector<int> ActiveColumns(const SmallQpData& data, const Eigen::VectorXd& x,
+                                      double tolerance = 1e-8) {
+  std::vector<int> active;
+  if (x.size() != data.normals.rows()) {
+    return active;
+  }
+  for (int i = data.num_equalities; i < data.normals.cols(); ++i) {
+    if (std::abs(data.normals.col(i).dot(x) - data.b(i)) <= tolerance * (1 + std::abs(data.b(i)))) {
+      active.push_back(i);
+    }
+  }
+  return active;
+}
+
+}  // namespace internal
+
+/*
+ * Solves a small strictly convex QP (see IsSmallQp()) with a dense dual active-set method,
+ * without the setup cost of a general solver. Programs with up to 12 variables are solved with
+ * fixed-size Eigen matrices. The result is reported under the solver id "SmallQp" and includes
+ * the dual solution of every constraint.
+ *
+ * The method needs no starting point. An `initial_guess` warm starts it with the inequalities
+ * active at the guess instead, which pays off when the guess is the solution of a nearby QP.
+ *
+ * Returns the status; `result` is only filled in if it is kSolved or kInfeasible.
+ */
+inline SmallQpStatus SolveSmallQp(
+    const drake::solvers::MathematicalProgram& prog,
+    drake::solvers::MathematicalProgramResult* result,
+    const std::optional<Eigen::VectorXd>& initial_guess = std::nullopt) {
+  const internal::SmallQpData data = internal::MakeSmallQpData(prog);
+  const auto& G = data.G;
+  const auto& g = data.g;
+  const auto& bindings = data.bindings;
+  const auto& rows = data.rows;
+
+  Eigen::VectorXd x, multipliers;
+  const SmallQpStatus status = internal::SolveSmallQpData(
+      data, data.b, &x, &multipliers,
+      initial_guess ? internal::ActiveColumns(data, *initial_guess) : std::vector<int>());
+  if (status != SmallQpStatus::kSolved && status != SmallQpStatus::kInfeasible) {
+    return status;
+  }
+
+  *result = drake::solvers::MathematicalProgramResult();
+  result->set_decision_variable_index(prog.decision_variable_index());
+  result->set_solver_id(drake::solvers::SolverId("SmallQp"));
+  result->set_x_val(x);
+  if (status == SmallQpStatus::kInfeasible) {
+    result->set_solution_result(drake::solvers::SolutionResult::kInfeasibleConstraints);
+    result->set_optimal_cost(drake::solvers::MathematicalProgram::kGlobalInfeasibleCost);
+    return status;
+  }
+  result->set_solution_result(drake::solvers::SolutionResult::kSolutionFound);
+  result->set_optimal_cost(0.5 * x.dot(G * x) + g.dot(x) + data.constant);
+  // Drake's dual solution is positive when the lower bound is active and negative when the upper
+  // bound is, which is the sign of the row times its multiplier.
+  std::vector<Eigen::VectorXd> duals;
+  for (const auto& binding : bindings) {
+    duals.push_back(Eigen::VectorXd::Zero(binding.evaluator()->num_outputs()));
+  }
+  for (size_t i = 0; i < rows.size(); ++i) {
+    duals[rows[i].binding](rows[i].row) += rows[i].sign * multipliers(i);
+  }
+  for (size_t k = 0; k < bindings.size(); ++k) {
+    result->set_dual_solution(bindings[k], duals[k]);
+  }
+  return status;
+}
+
+// Solve() that takes the SolveSmallQp() fast path for small strictly convex QPs, warm started from
+// `initial_guess`, and hands every other program to Solve(). Solver options are meant for the
+// solver Solve() picks, so a call with `solver_options` always goes to Solve().
+inline drake::solvers::MathematicalProgramResult SolveWithSmallQpFastPath(
+    const drake::solvers::MathematicalProgram& prog,
+    const std::optional<Eigen::VectorXd>& initial_guess = std::nullopt,
+    const std::optional<drake::solvers::SolverOptions>& solver_options = std::nullopt) {
+  if (!solver_options.has_value() && IsSmallQp(prog)) {
+    drake::solvers::MathematicalProgramResult result;
+    const SmallQpStatus status = SolveSmallQp(prog, &result, initial_guess);
+    if (status == SmallQpStatus::kSolved || status == SmallQpStatus::kInfeasible) {
+      return result;
+    }
+  }
+  return drake::solvers::Solve(prog, initial_guess, solver_options);
+}
+
+}  // namespace drake_tutorials
@@ -0,0 +1,108 @@
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/osqp_solver.h>
+#include <drake/solvers/solver_interface.h>
+
+#include <gflags/gflags.h>
+
+#include "small_qp.h"
+#include "tutorial_programs.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+DEFINE_int32(repetitions, 1000, "Number of solves per (program, solver) pair.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+/*
+ * A random strictly convex QP with n variables:
+ *    min 0.5 x'(M'M + I)x + g'x
+ * subject to n / 4 random equality rows
+ *            n / 2 random inequality rows a'x <= 1
+ *            -1 <= x <= 1
+ */
+std::unique_ptr<drake::solvers::MathematicalProgram> MakeRandomQp(int n, std::mt19937* generator) {
+  std::normal_distribution<double> normal;
+  auto random = [&](int rows, int cols) {
+    return Eigen::MatrixXd::NullaryExpr(rows, cols, [&]() { return normal(*generator); });
+  };
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  auto x = prog->NewContinuousVariables(n);
+  const Eigen::MatrixXd M = random(n, n);
+  prog->AddQuadraticCost(M.transpose() * M + Eigen::MatrixXd::Identity(n, n), random(n, 1), x);
+  // The equalities go through a point inside the box, so the program is feasible.
+  const Eigen::VectorXd interior = 0.5 * Eigen::VectorXd::Random(n);
+  const Eigen::MatrixXd Aeq = random(n / 4, n);
+  prog->AddLinearEqualityConstraint(Aeq, Aeq * interior, x);
+  const double kInf = std::numeric_limits<double>::infinity();
+  prog->AddLinearConstraint(random(n / 2, n), Eigen::VectorXd::Constant(n / 2, -kInf),
+                            Eigen::VectorXd::Ones(n / 2), x);
+  prog->AddBoundingBoxConstraint(-1, 1, x);
+  return prog;
+}
+
+// Returns the median latency in microseconds and the last result.
+double MedianLatency(const std::function<drake::solvers::MathematicalProgramResult()>& solve,
+                     drake::solvers::MathematicalProgramResult* result) {
+  std::vector<double> latencies(FLAGS_repetitions);
+  for (double& latency : latencies) {
+    const auto start = std::chrono::steady_clock::now();
+    *result = solve();
+    latency = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+                  .count();
+  }
+  std::nth_element(latencies.begin(), latencies.begin() + latencies.size() / 2, latencies.end());
+  return latencies[latencies.size() / 2];
+}
+
+void Compare(const std::string& name, const drake::solvers::MathematicalProgram& prog) {
+  drake::solvers::MathematicalProgramResult fast;
+  const double fast_latency =
+      MedianLatency([&]() { return drake_tutorials::SolveWithSmallQpFastPath(prog); }, &fast);
+  print(name, " (", prog.num_vars(), " variables): ", fast.get_solver_id().name(), " ",
+        fast_latency, " us, ", fast.get_solution_result());
+
+  drake::solvers::OsqpSolver osqp;
+  drake::solvers::IpoptSolver ipopt;
+  drake::solvers::SolverOptions options;
+  options.SetOption(drake::solvers::IpoptSolver::id(), "print_level", 0);
+  for (const drake::solvers::SolverInterface* solver :
+       std::vector<const drake::solvers::SolverInterface*>{&osqp, &ipopt}) {
+    if (!solver->available() || !solver->enabled()) {
+      continue;
+    }
+    drake::solvers::MathematicalProgramResult result;
+    const double latency = MedianLatency(
+        [&]() {
+          drake::solvers::MathematicalProgramResult r;
+          solver->Solve(prog, std::nullopt, options, &r);
+          return r;
+        },
+        &result);
+    print("  ", solver->solver_id().name(), ": ", latency, " us (", latency / fast_latency,
+          "x), max |x difference| ",
+          (result.get_x_val() - fast.get_x_val()).cwiseAbs().maxCoeff());
+  }
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  Compare("simple_optimization_problem_feasible", *drake_tutorials::MakeFeasibleProgram());
+  std::mt19937 generator(0);
+  for (int n : {2, 5, 10, 20, 30, 50}) {
+    Compare("random QP", *MakeRandomQp(n, &generator));
+  }
+  return 0;
+}
@@ -0,0 +1,348 @@
+#pragma once
+
+#include <drake/solvers/choose_best_solver.h>
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/solver_interface.h>
+
+#include "warm_start_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <list>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace drake_tutorials {
+
+/*
+ * Solutions of previous solves, keyed by the parameter vector they were solved for, with
+ * nearest-neighbour lookup and least-recently-used eviction once `capacity` entries are stored.
+ *
+ * The entries live in fixed slots. A k-d tree indexes the slots that were stored at its last
+ * rebuild; entries stored since then are scanned linearly, and the tree is rebuilt once that list
+ * grows past the square root of the size or half of the tree's points have been evicted. Removing
+ * an entry bumps the generation of its slot, so the tree skips the stale point without being
+ * rebuilt. Distances are Euclidean, so parameters of very different scales should be scaled
+ * before they are stored.
+ */
+class SolutionDatabase {
+ public:
+  struct Entry {
+    Eigen::VectorXd parameters;
+    Eigen::VectorXd x;
+    // The dual solutions of all constraints, in the order of GetAllConstraints().
+    Eigen::VectorXd duals;
+  };
+
+  SolutionDatabase(int num_parameters, int capacity)
+      : num_parameters_(num_parameters), capacity_(std::max(1, capacity)) {
+    if (num_parameters <= 0) {
+      throw std::invalid_argument("SolutionDatabase: need at least one parameter.");
+    }
+    slots_.reserve(capacity_);
+  }
+
+  int num_parameters() const { return num_parameters_; }
+  int capacity() const { return capacity_; }
+  int size() const { return static_cast<int>(lru_.size()); }
+  int num_evictions() const { return num_evictions_; }
+  int num_rebuilds() const { return num_rebuilds_; }
+
+  // Stores an entry. If a stored entry is within `merge_distance` of entry.parameters, it is
+  // replaced instead, so that repeated solves of the same parameters do not fill the database.
+  void Insert(Entry entry, double merge_distance = 0) {
+    if (entry.parameters.size() != num_parameters_) {
+      throw std::invalid_argument("SolutionDatabase: parameters of the wrong size.");
+    }
+    // A merged entry is removed and stored anew, since the tree was split at its old position.
+    const auto nearest = FindNearestSlot(entry.parameters);
+    if (nearest && nearest->second <= merge_distance) {
+      Remove(nearest->first);
+    } else if (size() == capacity_) {
+      Remove(lru_.back());
+      ++num_evictions_;
+    }
+    int slot;
+    if (!free_slots_.empty()) {
+      slot = free_slots_.back();
+      free_slots_.pop_back();
+    } else {
+      slot = slots_.size();
+      slots_.emplace_back();
+    }
+    Slot& s = slots_[slot];
+    s.entry = std::move(entry);
+    s.alive = true;
+    lru_.push_front(slot);
+    s.lru = lru_.begin();
+    pending_.push_back({slot, s.generation});
+    const int threshold = std::max(kMinPending, static_cast<int>(std::sqrt(size())));
+    if (static_cast<int>(pending_.size()) > threshold) {
+      Rebuild();
+    }
+  }
+
+  // Returns the entry nearest to `parameters` and its distance, or nullopt if the database is
+  // empty. The entry counts as used for the eviction order; the pointer stays valid until the
+  // next Insert().
+  std::optional<std::pair<const Entry*, double>> FindNearest(
+      const Eigen::Ref<const Eigen::VectorXd>& parameters) {
+    if (parameters.size() != num_parameters_) {
+      throw std::invalid_argument("SolutionDatabase: parameters of the wrong size.");
+    }
+    const auto nearest = FindNearestSlot(parameters);
+    if (!nearest) {
+      return std::nullopt;
+    }
+    Touch(nearest->first);
+    return std::make_pair(&slots_[nearest->first].entry, nearest->second);
+  }
+
+  void Clear() {
+    slots_.clear();
+    free_slots_.clear();
+    lru_.clear();
+    pending_.clear();
+    tree_.clear();
+    num_stale_ = 0;
+  }
+
+ private:
+  // Segments this short are scanned instead of split further.
+  static constexpr int kLeafSize = 8;
+  static constexpr int kMinPending = 32;
+
+  struct Slot {
+    Entry entry;
+    bool alive{false};
+    // Bumped whenever the entry is removed, so that index points of an earlier occupant are
+    // told apart.
+    int generation{0};
+    std::list<int>::iterator lru;
+  };
+
+  // A slot as the index saw it.
+  struct Point {
+    int slot;
+    int generation;
+  };
+
+  // The tree over tree_[begin, end) is implicit: the node of a segment longer than kLeafSize is
+  // its middle element, which splits the segment along `axis` at `split`. The split is copied out
+  // of the slot, so it stays valid after the slot is reused.
+  struct TreeNode {
+    Point point;
+    int axis{0};
+    double split{0};
+  };
+
+  bool IsCurrent(const Point& point) const {
+    const Slot& slot = slots_[point.slot];
+    return slot.alive && slot.generation == point.generation;
+  }
+
+  void Touch(int slot) { lru_.splice(lru_.begin(), lru_, slots_[slot].lru); }
+
+  void Remove(int slot) {
+    Slot& s = slots_[slot];
+    lru_.erase(s.lru);
+    s.alive = false;
+    ++s.generation;
+    s.entry = Entry();
+    free_slots_.push_back(slot);
+    // The slot is either pending or in the tree, which skips it from now on.
+    const auto pending_end = std::remove_if(pending_.begin(), pending_.end(),
+                                            [slot](const Point& p) { return p.slot == slot; });
+    if (pending_end != pending_.end()) {
+      pending_.erase(pending_end, pending_.end());
+      return;
+    }
+    if (++num_stale_ > static_cast<int>(tree_.size()) / 2) {
+      Rebuild();
+    }
+  }
+
+  void Rebuild() {
+    tree_.clear();
+    for (const int slot : lru_) {
+      tree_.push_back({{slot, slots_[slot].generation}, 0, 0});
+    }
+    pending_.clear();
+    num_stale_ = 0;
+    ++num_rebuilds_;
+    Build(0, tree_.size());
+  }
+
+  void Build(int begin, int end) {
+    if (end - begin <= kLeafSize) {
+      return;
+    }
+    // Split along the axis of largest spread.
+    Eigen::VectorXd lower = slots_[tree_[begin].point.slot].entry.parameters;
+    Eigen::VectorXd upper = lower;
+    for (int i = begin + 1; i < end; ++i) {
+      const Eigen::VectorXd& p = slots_[tree_[i].point.slot].entry.parameters;
+      lower = lower.cwiseMin(p);
+      upper = upper.cwiseMax(p);
+    }
+    int axis = 0;
+    (upper - lower).maxCoeff(&axis);
+    const int middle = begin + (end - begin) / 2;
+    std::nth_element(tree_.begin() + begin, tree_.begin() + middle, tree_.begin() + end,
+                     [this, axis](const TreeNode& a, const TreeNode& b) {
+                       return slots_[a.point.slot].entry.parameters(axis) <
+                              slots_[b.point.slot].entry.parameters(axis);
+                     });
+    tree_[middle].axis = axis;
+    tree_[middle].split = slots_[tree_[middle].point.slot].entry.parameters(axis);
+    Build(begin, middle);
+    Build(middle + 1, end);
+  }
+
+  void Visit(const Point& point, const Eigen::Ref<const Eigen::VectorXd>& query, int* best,
+             double* best_distance_squared) const {
+    if (!IsCurrent(point)) {
+      return;
+    }
+    const double d = (slots_[point.slot].entry.parameters - query).squaredNorm();
+    if (d < *best_distance_squared) {
+      *best_distance_squared = d;
+      *best = point.slot;
+    }
+  }
+
+  void Search(int begin, int end, const Eigen::Ref<const Eigen::VectorXd>& query, int* best,
+              double* best_distance_squared) const {
+    if (end - begin <= kLeafSize) {
+      for (int i = begin; i < end; ++i) {
+        Visit(tree_[i].point, query, best, best_distance_squared);
+      }
+      return;
+    }
+    const int middle = begin + (end - begin) / 2;
+    const TreeNode& node = tree_[middle];
+    Visit(node.point, query, best, best_distance_squared);
+    const double difference = query(node.axis) - node.split;
+    const bool left_first = difference < 0;
+    Search(left_first ? begin : middle + 1, left_first ? middle : end, query, best,
+           best_distance_squared);
+    if (difference * difference < *best_distance_squared) {
+      Search(left_first ? middle + 1 : begin, left_first ? end : middle, query, best,
+             best_distance_squared);
+    }
+  }
+
+  std::optional<std::pair<int, double>> FindNearestSlot(
+      const Eigen::Ref<const Eigen::VectorXd>& parameters) const {
+    int best = -1;
+    double best_distance_squared = std::numeric_limits<double>::infinity();
+    Search(0, tree_.size(), parameters, &best, &best_distance_squared);
+    for (const Point& point : pending_) {
+      Visit(point, parameters, &best, &best_distance_squared);
+    }
+    if (best < 0) {
+      return std::nullopt;
+    }
+    return std::make_pair(best, std::sqrt(best_distance_squared));
+  }
+
+  int num_parameters_;
+  int capacity_;
+  std::vector<Slot> slots_;
+  std::vector<int> free_slots_;
+  // Most recently used first.
+  std::list<int> lru_;
+  std::vector<TreeNode> tree_;
+  std::vector<Point> pending_;
+  // Points of the tree that were evicted since its last rebuild.
+  int num_stale_{0};
+  int num_evictions_{0};
+  int num_rebuilds_{0};
+};
+
+struct NearestNeighborWarmStartOptions {
+  // Entries kept before the least recently used one is evicted.
+  int capacity{4096};
+  // A stored solution farther than this from the parameters is not used as the initial guess.
+  double max_distance{std::numeric_limits<double>::infinity()};
+  // A new solution this close to a stored one replaces it; see SolutionDatabase::Insert().
+  double merge_distance{0};
+};
+
+/*
+ * Solves programs of a parameterized family and warm starts every solve from the stored solution
+ * whose parameters are nearest to the new ones (see SolutionDatabase). Successful solves are
+ * stored with their primal and dual solutions.
+ *
+ * Drake only passes a primal initial guess to its solvers, so the stored duals are not handed
+ * over. With IpoptSolver a warm start also lowers the initial barrier parameter and the bound
+ * push (see internal::IpoptWarmStartOptions()); OsqpSolver starts from the guess as is.
+ */
+class NearestNeighborWarmStart {
+ public:
+  NearestNeighborWarmStart(int num_parameters,
+                           const drake::solvers::SolverId& solver_id =
+                               drake::solvers::IpoptSolver::id(),
+                           const NearestNeighborWarmStartOptions& options = {})
+      : solver_(drake::solvers::MakeSolver(solver_id)),
+        options_(options),
+        database_(num_parameters, options.capacity) {}
+
+  drake::solvers::MathematicalProgramResult Solve(
+      const drake::solvers::MathematicalProgram& prog, const Eigen::VectorXd& parameters,
+      const std::optional<Eigen::VectorXd>& initial_guess = std::nullopt,
+      const std::optional<drake::solvers::SolverOptions>& solver_options = std::nullopt) {
+    const auto nearest = database_.FindNearest(parameters);
+    drake::solvers::MathematicalProgramResult result;
+    if (nearest && nearest->second <= options_.max_distance &&
+        nearest->first->x.size() == prog.num_vars()) {
+      ++num_hits_;
+      const bool ipopt = solver_->solver_id() == drake::solvers::IpoptSolver::id();
+      solver_->Solve(prog, nearest->first->x,
+                     ipopt ? internal::IpoptWarmStartOptions(solver_options) : solver_options,
+                     &result);
+    } else {
+      ++num_misses_;
+      solver_->Solve(prog, initial_guess, solver_options, &result);
+    }
+    if (result.is_success()) {
+      Store(prog, parameters, result);
+    }
+    return result;
+  }
+
+  const SolutionDatabase& database() const { return database_; }
+  int num_hits() const { return num_hits_; }
+  int num_misses() const { return num_misses_; }
+
+ private:
+  void Store(const drake::solvers::MathematicalProgram& prog, const Eigen::VectorXd& parameters,
+             const drake::solvers::MathematicalProgramResult& result) {
+    const auto constraints = prog.GetAllConstraints();
+    int num_duals = 0;
+    for (const auto& binding : constraints) {
+      num_duals += binding.evaluator()->num_outputs();
+    }
+    SolutionDatabase::Entry entry{parameters, result.get_x_val(), Eigen::VectorXd(num_duals)};
+    int offset = 0;
+    for (const auto& binding : constraints) {
+      const int size = binding.evaluator()->num_outputs();
+      entry.duals.segment(offset, size) = result.GetDualSolution(binding);
+      offset += size;
+    }
+    database_.Insert(std::move(entry), options_.merge_distance);
+  }
+
+  std::unique_ptr<drake::solvers::SolverInterface> solver_;
+  NearestNeighborWarmStartOptions options_;
+  SolutionDatabase database_;
+  int num_hits_{0};
+  int num_misses_{0};
+};
+
+}  // namespace drake_tutorials
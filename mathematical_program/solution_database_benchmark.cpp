@@ -0,0 +1,185 @@
+#include <drake/solvers/choose_best_solver.h>
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/osqp_solver.h>
+
+#include <gflags/gflags.h>
+
+#include "program_codec.h"
+#include "solution_database.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+
+DEFINE_int32(num_queries, 5000, "Number of solves in the recorded workload.");
+DEFINE_int32(num_clusters, 4, "Number of regions the workload parameters cluster in.");
+DEFINE_int32(capacity, 256, "Entries kept in the solution database.");
+DEFINE_string(workload, "solution_database_workload.bin",
+              "Recorded workload; it is generated and written if the file does not exist.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+// Parameters drawn around a few random centers in [0, 1]^2, like a controller that keeps
+// returning to a few operating points.
+Eigen::MatrixXd GenerateWorkload() {
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> uniform(0, 1);
+  std::normal_distribution<double> noise(0, 0.03);
+  Eigen::MatrixXd centers(2, FLAGS_num_clusters);
+  for (int k = 0; k < centers.cols(); ++k) {
+    centers.col(k) = Eigen::Vector2d(uniform(generator), uniform(generator));
+  }
+  std::uniform_int_distribution<int> cluster(0, FLAGS_num_clusters - 1);
+  Eigen::MatrixXd workload(2, FLAGS_num_queries);
+  for (int i = 0; i < workload.cols(); ++i) {
+    workload.col(i) = centers.col(cluster(generator)) +
+                      Eigen::Vector2d(noise(generator), noise(generator));
+  }
+  return workload;
+}
+
+// The workload is stored as the ByteWriter encoding of its columns, so that later runs replay
+// exactly the same solves.
+Eigen::MatrixXd LoadOrRecordWorkload(const std::string& path) {
+  if (std::filesystem::exists(path)) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream contents;
+    contents << in.rdbuf();
+    const std::string bytes = contents.str();
+    drake_tutorials::ByteReader reader(bytes);
+    const int num_parameters = reader.Get<std::uint32_t>();
+    const auto values = reader.GetArray<double>();
+    return Eigen::Map<const Eigen::MatrixXd>(values.data(), num_parameters,
+                                             values.size() / num_parameters);
+  }
+  const Eigen::MatrixXd workload = GenerateWorkload();
+  drake_tutorials::ByteWriter writer;
+  writer.Put<std::uint32_t>(workload.rows());
+  writer.PutArray(workload.data(), workload.size());
+  std::ofstream(path, std::ios::binary).write(writer.bytes().data(), writer.bytes().size());
+  return workload;
+}
+
+// add_callback.cpp with a shifted cost: min (x(0) - shift)^2 + x(1)^2 s.t. x(0) * x(1) = product,
+// with (product, shift) mapped from the unit square to [4, 16] x [-3, 3].
+std::unique_ptr<drake::solvers::MathematicalProgram> MakeShiftedBilinearProgram(
+    const Eigen::Vector2d& p) {
+  const double product = 4 + 12 * p(0);
+  const double shift = -3 + 6 * p(1);
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  auto x = prog->NewContinuousVariables(2);
+  prog->AddConstraint(x[0] * x[1] == product);
+  prog->AddCost(pow(x[0] - shift, 2) + pow(x[1], 2));
+  return prog;
+}
+
+// A projection onto the simplex in 20 dimensions with a coupled Hessian, whose target moves with
+// the parameters.
+std::unique_ptr<drake::solvers::MathematicalProgram> MakeSimplexQp(const Eigen::Vector2d& p) {
+  constexpr int n = 20;
+  std::mt19937 generator(1);
+  std::normal_distribution<double> normal(0, 1);
+  const Eigen::MatrixXd M = Eigen::MatrixXd::NullaryExpr(n, n, [&] { return normal(generator); });
+  const Eigen::MatrixXd A = Eigen::MatrixXd::NullaryExpr(n, 2, [&] { return normal(generator); });
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  auto x = prog->NewContinuousVariables(n);
+  prog->AddQuadraticCost(M.transpose() * M / n + Eigen::MatrixXd::Identity(n, n), -A * p, x);
+  prog->AddBoundingBoxConstraint(0, 1, x);
+  prog->AddLinearEqualityConstraint(Eigen::RowVectorXd::Ones(n), 1, x);
+  return prog;
+}
+
+struct Run {
+  long iterations{0};
+  double solve_time{0};
+  int failures{0};
+};
+
+// Ipopt reports its iterations through the visualization callbacks, OSQP through its details.
+int CountIterations(const drake::solvers::MathematicalProgramResult& result,
+                    int ipopt_callback_count) {
+  if (result.get_solver_id() == drake::solvers::OsqpSolver::id()) {
+    return result.get_solver_details<drake::solvers::OsqpSolver>().iter;
+  }
+  return ipopt_callback_count;
+}
+
+void Compare(
+    const std::string& name, const drake::solvers::SolverId& solver_id,
+    const std::function<std::unique_ptr<drake::solvers::MathematicalProgram>(
+        const Eigen::Vector2d&)>& make_program,
+    const std::optional<Eigen::VectorXd>& cold_guess, const Eigen::MatrixXd& workload) {
+  drake::solvers::SolverOptions options;
+  options.SetOption(drake::solvers::IpoptSolver::id(), "print_level", 0);
+  const auto solver = drake::solvers::MakeSolver(solver_id);
+  if (!solver->available() || !solver->enabled()) {
+    print(name, ": ", solver_id.name(), " is not available");
+    return;
+  }
+  drake_tutorials::NearestNeighborWarmStartOptions warm_options;
+  warm_options.capacity = FLAGS_capacity;
+  drake_tutorials::NearestNeighborWarmStart warm(2, solver_id, warm_options);
+
+  auto run = [&](bool warm_start) {
+    Run r;
+    for (int i = 0; i < workload.cols(); ++i) {
+      auto prog = make_program(workload.col(i));
+      int callback_count = 0;
+      // OSQP refuses programs with callbacks.
+      if (solver_id == drake::solvers::IpoptSolver::id()) {
+        prog->AddVisualizationCallback(
+            [&callback_count](const Eigen::Ref<const Eigen::VectorXd>&) { ++callback_count; },
+            prog->decision_variables());
+      }
+      const auto start = std::chrono::steady_clock::now();
+      drake::solvers::MathematicalProgramResult result;
+      if (warm_start) {
+        result = warm.Solve(*prog, workload.col(i), cold_guess, options);
+      } else {
+        solver->Solve(*prog, cold_guess, options, &result);
+      }
+      r.solve_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+                          .count();
+      r.iterations += CountIterations(result, callback_count);
+      r.failures += !result.is_success();
+    }
+    return r;
+  };
+  const Run cold = run(false);
+  const Run nearest = run(true);
+  const double n = workload.cols();
+  print(name, " with ", solver_id.name(), ":");
+  print("  cold start: ", cold.iterations / n, " iterations and ", 1e6 * cold.solve_time / n,
+        " us per solve, ", cold.failures, " failures");
+  print("  nearest stored solution: ", nearest.iterations / n, " iterations and ",
+        1e6 * nearest.solve_time / n, " us per solve, ", nearest.failures, " failures");
+  print("  hits ", warm.num_hits(), ", misses ", warm.num_misses(), ", ",
+        warm.database().size(), " entries, ", warm.database().num_evictions(), " evictions, ",
+        warm.database().num_rebuilds(), " index rebuilds");
+  print("  iteration reduction ", 100. * (cold.iterations - nearest.iterations) / cold.iterations,
+        " %, wall-time reduction ", 100. * (cold.solve_time - nearest.solve_time) / cold.solve_time,
+        " %");
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  const Eigen::MatrixXd workload = LoadOrRecordWorkload(FLAGS_workload);
+  print(workload.cols(), " solves from ", FLAGS_workload);
+
+  Compare("add_callback with a shifted cost", drake::solvers::IpoptSolver::id(),
+          MakeShiftedBilinearProgram, Eigen::VectorXd(Eigen::Vector2d(4, 5)), workload);
+  Compare("simplex QP", drake::solvers::OsqpSolver::id(), MakeSimplexQp, std::nullopt, workload);
+  return 0;
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/mathematical_program_result.h>
+
+#include "program_codec.h"
+#include "solver_protocol.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace drake_tutorials {
+
+/*
+ * A connection to a SolverServer.
+ *
+ * SolveAsync() may be called from any thread and any number of requests may be in flight; a
+ * reader thread matches the responses to their requests by id. Results carry the decision
+ * variable index and the constraint bindings of the program that was sent, so GetSolution() and
+ * GetDualSolution() work with its variables and constraints.
+ * Requests fail with std::runtime_error when the server reports an error or the connection
+ * closes.
+ */
+class SolverClient {
+ public:
+  explicit SolverClient(const std::string& socket_path)
+      : fd_(internal::ConnectToUnixSocket(socket_path)) {
+    reader_ = std::thread([this] { ReadResponses(); });
+  }
+
+  SolverClient(const SolverClient&) = delete;
+  SolverClient& operator=(const SolverClient&) = delete;
+
+  ~SolverClient() {
+    shutdown(fd_, SHUT_RDWR);
+    reader_.join();
+    close(fd_);
+  }
+
+  // Sends `prog` to the server. Without `solver_name`, the server picks a solver with
+  // ChooseBestSolver().
+  std::future<drake::solvers::MathematicalProgramResult> SolveAsync(
+      const drake::solvers::MathematicalProgram& prog,
+      const std::optional<std::string>& solver_name = std::nullopt) {
+    ByteWriter request;
+    const std::uint64_t request_id = next_request_id_++;
+    request.Put<std::uint64_t>(request_id);
+    request.PutString(solver_name.value_or(""));
+    EncodeProgram(prog, &request);
+
+    std::future<drake::solvers::MathematicalProgramResult> future;
+    {
+      std::lock_guard<std::mutex> lock(pending_mutex_);
+      if (closed_) {
+        throw std::runtime_error("SolverClient: the connection is closed.");
+      }
+      Pending& pending = pending_[request_id];
+      pending.decision_variable_index = prog.decision_variable_index();
+      pending.constraints = internal::EncodedConstraints(prog);
+      future = pending.promise.get_future();
+    }
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!internal::WriteFrame(fd_, request.bytes())) {
+      Fail(request_id, "SolverClient: failed to send the request.");
+    }
+    return future;
+  }
+
+  drake::solvers::MathematicalProgramResult Solve(
+      const drake::solvers::MathematicalProgram& prog,
+      const std::optional<std::string>& solver_name = std::nullopt) {
+    return SolveAsync(prog, solver_name).get();
+  }
+
+ private:
+  struct Pending {
+    std::promise<drake::solvers::MathematicalProgramResult> promise;
+    std::unordered_map<drake::symbolic::Variable::Id, int> decision_variable_index;
+    std::vector<drake::solvers::Binding<drake::solvers::Constraint>> constraints;
+  };
+
+  void ReadResponses() {
+    std::string frame;
+    try {
+      while (internal::ReadFrame(fd_, &frame)) {
+        ByteReader reader(frame);
+        const auto request_id = reader.Get<std::uint64_t>();
+        Pending pending;
+        {
+          std::lock_guard<std::mutex> lock(pending_mutex_);
+          auto it = pending_.find(request_id);
+          if (it == pending_.end()) {
+            continue;
+          }
+          pending = std::move(it->second);
+          pending_.erase(it);
+        }
+        if (reader.Get<std::uint8_t>() != 0) {
+          pending.promise.set_value(
+              DecodeResult(pending.decision_variable_index, pending.constraints, &reader));
+        } else {
+          pending.promise.set_exception(
+              std::make_exception_ptr(std::runtime_error(reader.GetString())));
+        }
+      }
+    } catch (const std::exception&) {
+      // A malformed response; the remaining requests are failed below.
+    }
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    closed_ = true;
+    for (auto& [request_id, pending] : pending_) {
+      pending.promise.set_exception(std::make_exception_ptr(
+          std::runtime_error("SolverClient: the connection closed before the response arrived.")));
+    }
+    pending_.clear();
+  }
+
+  void Fail(std::uint64_t request_id, const std::string& message) {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    auto it = pending_.find(request_id);
+    if (it != pending_.end()) {
+      it->second.promise.set_exception(std::make_exception_ptr(std::runtime_error(message)));
+      pending_.erase(it);
+    }
+  }
+
+  int fd_;
+  std::thread reader_;
+  std::atomic<std::uint64_t> next_request_id_{1};
+  std::mutex write_mutex_;
+  std::mutex pending_mutex_;
+  std::unordered_map<std::uint64_t, Pending> pending_;
+  bool closed_{false};
+};
+
+}  // namespace drake_tutorials
@@ -0,0 +1,205 @@
+#include <drake/solvers/choose_best_solver.h>
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/osqp_solver.h>
+#include <drake/solvers/scs_solver.h>
+#include <drake/solvers/solver_interface.h>
+
+#include <gflags/gflags.h>
+
+#include "benchmark_statistics.h"
+#include "tutorial_programs.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+DEFINE_int32(repetitions, 1000, "Number of solves per (program, solver) pair.");
+DEFINE_string(output, "solver_comparison.json", "Path of the JSON report.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+struct Measurement {
+  std::string program;
+  std::string solver;
+  std::string error;
+  std::string solution_result;
+  bool success{false};
+  double optimal_cost{NAN};
+  Eigen::VectorXd solution;
+  double median_latency_us{NAN};
+  double p99_latency_us{NAN};
+  // -1 if the solver does not report its iteration count.
+  int iterations{-1};
+  // Largest difference to the solution of ChooseBestSolver(); NaN if either solve failed.
+  double max_deviation_from_reference{NAN};
+};
+
+// Ipopt reports every iteration through the visualization callbacks, OSQP and SCS through their
+// solver details. The other solvers do not expose an iteration count.
+int CountIterations(const drake::solvers::MathematicalProgramResult& result,
+                    int ipopt_callback_count) {
+  const auto& id = result.get_solver_id();
+  if (id == drake::solvers::IpoptSolver::id()) {
+    return ipopt_callback_count;
+  }
+  if (id == drake::solvers::OsqpSolver::id()) {
+    return result.get_solver_details<drake::solvers::OsqpSolver>().iter;
+  }
+  if (id == drake::solvers::ScsSolver::id()) {
+    return result.get_solver_details<drake::solvers::ScsSolver>().iter;
+  }
+  return -1;
+}
+
+// Solves `prog`, which is `program.prog` or a copy of it. `callback_count` is incremented by a
+// visualization callback of `prog`, if it has one.
+Measurement Measure(const drake_tutorials::TutorialProgram& program,
+                    const drake::solvers::MathematicalProgram& prog, const int& callback_count,
+                    const drake::solvers::SolverInterface& solver,
+                    const drake::solvers::SolverOptions& options) {
+  Measurement m;
+  m.program = program.name;
+  m.solver = solver.solver_id().name();
+  std::vector<double> latencies;
+  latencies.reserve(FLAGS_repetitions);
+  drake::solvers::MathematicalProgramResult result;
+  try {
+    for (int i = 0; i < FLAGS_repetitions; ++i) {
+      const auto start = std::chrono::steady_clock::now();
+      solver.Solve(prog, program.initial_guess, options, &result);
+      const std::chrono::duration<double, std::micro> elapsed =
+          std::chrono::steady_clock::now() - start;
+      latencies.push_back(elapsed.count());
+    }
+    // One more solve with a fresh counter for the iteration count.
+    const int count_before = callback_count;
+    solver.Solve(prog, program.initial_guess, options, &result);
+    m.iterations = CountIterations(result, callback_count - count_before);
+  } catch (const std::exception& e) {
+    m.error = e.what();
+    return m;
+  }
+  m.success = result.is_success();
+  std::ostringstream solution_result;
+  solution_result << result.get_solution_result();
+  m.solution_result = solution_result.str();
+  m.optimal_cost = result.get_optimal_cost();
+  m.solution = result.get_x_val();
+  m.median_latency_us = drake_tutorials::Percentile(latencies, 0.5);
+  m.p99_latency_us = drake_tutorials::Percentile(latencies, 0.99);
+  return m;
+}
+
+std::string JsonNumber(double value) {
+  if (!std::isfinite(value)) {
+    return "null";
+  }
+  std::ostringstream out;
+  out.precision(17);
+  out << value;
+  return out.str();
+}
+
+std::string JsonString(const std::string& value) {
+  std::string out = "\"";
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+    }
+    out += (c == '\n') ? ' ' : c;
+  }
+  return out + "\"";
+}
+
+void WriteJson(const std::vector<Measurement>& measurements, const std::string& path) {
+  std::ofstream out(path);
+  out << "{\n  \"repetitions\": " << FLAGS_repetitions << ",\n  \"measurements\": [";
+  for (size_t i = 0; i < measurements.size(); ++i) {
+    const Measurement& m = measurements[i];
+    out << (i == 0 ? "\n" : ",\n") << "    {\"program\": " << JsonString(m.program)
+        << ", \"solver\": " << JsonString(m.solver);
+    if (!m.error.empty()) {
+      out << ", \"error\": " << JsonString(m.error) << "}";
+      continue;
+    }
+    out << ", \"solution_result\": " << JsonString(m.solution_result)
+        << ", \"success\": " << (m.success ? "true" : "false")
+        << ", \"optimal_cost\": " << JsonNumber(m.optimal_cost) << ", \"solution\": [";
+    for (int j = 0; j < m.solution.size(); ++j) {
+      out << (j == 0 ? "" : ", ") << JsonNumber(m.solution(j));
+    }
+    out << "], \"median_latency_us\": " << JsonNumber(m.median_latency_us)
+        << ", \"p99_latency_us\": " << JsonNumber(m.p99_latency_us) << ", \"iterations\": "
+        << (m.iterations >= 0 ? std::to_string(m.iterations) : "null")
+        << ", \"max_deviation_from_reference\": " << JsonNumber(m.max_deviation_from_reference)
+        << "}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  drake::solvers::SolverOptions options;
+  options.SetOption(drake::solvers::IpoptSolver::id(), "print_level", 0);
+
+  // Every solver Drake knows about that is compiled in, and for the commercial ones, licensed.
+  std::vector<std::unique_ptr<drake::solvers::SolverInterface>> solvers;
+  for (const auto& id : drake::solvers::GetKnownSolvers()) {
+    auto solver = drake::solvers::MakeSolver(id);
+    if (solver->available() && solver->enabled()) {
+      solvers.push_back(std::move(solver));
+    }
+  }
+
+  std::vector<Measurement> measurements;
+  for (auto& program : drake_tutorials::MakeTutorialPrograms()) {
+    const auto reference_id = drake::solvers::ChooseBestSolver(*program.prog);
+    // Ipopt reports its iterations through the visualization callbacks. Only its copy of the
+    // program gets one, since solvers without callback support reject programs with callbacks.
+    int callback_count = 0;
+    const auto ipopt_prog = program.prog->Clone();
+    ipopt_prog->AddVisualizationCallback(
+        [&callback_count](const Eigen::Ref<const Eigen::VectorXd>&) { ++callback_count; },
+        ipopt_prog->decision_variables());
+
+    const size_t first = measurements.size();
+    for (const auto& solver : solvers) {
+      const drake::solvers::MathematicalProgram& prog =
+          solver->solver_id() == drake::solvers::IpoptSolver::id() ? *ipopt_prog : *program.prog;
+      if (!solver->AreProgramAttributesSatisfied(prog)) {
+        continue;
+      }
+      measurements.push_back(Measure(program, prog, callback_count, *solver, options));
+      const Measurement& m = measurements.back();
+      print(m.program, " / ", m.solver, ": ",
+            m.error.empty() ? m.solution_result : "error: " + m.error, ", median ",
+            m.median_latency_us, " us, p99 ", m.p99_latency_us, " us, iterations ", m.iterations);
+    }
+
+    // Compare every solution with the one of the solver Solve() would have picked.
+    const auto reference =
+        std::find_if(measurements.begin() + first, measurements.end(),
+                     [&](const Measurement& m) { return m.solver == reference_id.name(); });
+    if (reference != measurements.end() && reference->success) {
+      for (size_t i = first; i < measurements.size(); ++i) {
+        if (measurements[i].success) {
+          measurements[i].max_deviation_from_reference =
+              (measurements[i].solution - reference->solution).cwiseAbs().maxCoeff();
+        }
+      }
+    }
+  }
+
+  WriteJson(measurements, FLAGS_output);
+  print("Wrote ", measurements.size(), " measurements to ", FLAGS_output);
+  return 0;
+}
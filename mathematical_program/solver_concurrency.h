@@ -0,0 +1,68 @@
+#pragma once
+
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/mathematical_program_result.h>
+#include <drake/solvers/solver_interface.h>
+#include <drake/solvers/solver_options.h>
+
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace drake_tutorials {
+
+/*
+ * Solving on several threads of one process.
+ *
+ * IPOPT's default linear solver, MUMPS, keeps global state: two Ipopt solves running at the same
+ * time corrupt each other's results or crash. The HSL linear solvers (ma27, ma57, ma77, ma86,
+ * ma97) are reentrant. Everything in this repo that solves on a ThreadPool goes through
+ * SolveConcurrently(), which runs Ipopt solves on a non-reentrant linear solver one at a time and
+ * all other solves in parallel. Setting the Ipopt option "linear_solver" to one of the HSL
+ * solvers lets Ipopt solves run in parallel as well, given an Ipopt built with them.
+ */
+
+// Whether Ipopt solves with `options` use a reentrant linear solver.
+inline bool IpoptIsReentrant(const std::optional<drake::solvers::SolverOptions>& options) {
+  if (!options.has_value()) {
+    return false;
+  }
+  const auto& ipopt_options = options->GetOptionsStr(drake::solvers::IpoptSolver::id());
+  const auto it = ipopt_options.find("linear_solver");
+  if (it == ipopt_options.end()) {
+    return false;
+  }
+  for (const char* name : {"ma27", "ma57", "ma77", "ma86", "ma97"}) {
+    if (it->second == name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+namespace internal {
+
+inline std::mutex& IpoptMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+}  // namespace internal
+
+// Calls solver.Solve(prog, initial_guess, options, result). Ipopt solves that are not reentrant
+// hold a process-wide lock while they run, so they may be issued from any number of threads.
+inline void SolveConcurrently(const drake::solvers::SolverInterface& solver,
+                              const drake::solvers::MathematicalProgram& prog,
+                              const std::optional<Eigen::VectorXd>& initial_guess,
+                              const std::optional<drake::solvers::SolverOptions>& options,
+                              drake::solvers::MathematicalProgramResult* result) {
+  if (solver.solver_id() == drake::solvers::IpoptSolver::id() && !IpoptIsReentrant(options)) {
+    std::lock_guard<std::mutex> lock(internal::IpoptMutex());
+    solver.Solve(prog, initial_guess, options, result);
+    return;
+  }
+  solver.Solve(prog, initial_guess, options, result);
+}
+
+}  // namespace drake_tutorials
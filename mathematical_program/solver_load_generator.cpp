@@ -0,0 +1,148 @@
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/solve.h>
+
+#include <gflags/gflags.h>
+
+#include "benchmark_statistics.h"
+#include "solver_client.h"
+#include "solver_server.h"
+#include "tutorial_programs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+DEFINE_string(socket, "/tmp/drake_tutorials_solver.sock", "Path of the server's socket.");
+DEFINE_bool(spawn_server, false,
+            "Run a server inside this process instead of connecting to a running solver_server.");
+DEFINE_int32(server_threads, 0, "Solver threads of the spawned server; 0 means one per hardware "
+             "thread.");
+DEFINE_int32(connections, 8, "Number of client connections, each driven by its own thread.");
+DEFINE_int32(in_flight, 1, "Number of requests each connection keeps in flight.");
+DEFINE_double(duration, 5, "Length of the measurement in seconds.");
+DEFINE_string(program, "feasible", "Program to send: feasible, linear or circle.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+std::unique_ptr<drake::solvers::MathematicalProgram> MakeProgram(const std::string& name) {
+  if (name == "feasible") {
+    return drake_tutorials::MakeFeasibleProgram();
+  }
+  if (name == "linear") {
+    return drake_tutorials::MakeLinearProgram();
+  }
+  if (name == "circle") {
+    return drake_tutorials::MakeCircleProgram();
+  }
+  std::cerr << "Unknown program " << name << std::endl;
+  std::exit(1);
+}
+
+struct ConnectionStatistics {
+  std::vector<double> latencies_us;
+  int num_errors{0};
+};
+
+// Keeps FLAGS_in_flight requests outstanding on one connection until `deadline`.
+ConnectionStatistics DriveConnection(const drake::solvers::MathematicalProgram& prog,
+                                     std::chrono::steady_clock::time_point deadline) {
+  using Clock = std::chrono::steady_clock;
+  drake_tutorials::SolverClient client(FLAGS_socket);
+  ConnectionStatistics statistics;
+  std::deque<std::pair<Clock::time_point, std::future<drake::solvers::MathematicalProgramResult>>>
+      in_flight;
+  while (true) {
+    const bool sending = Clock::now() < deadline;
+    if (sending && static_cast<int>(in_flight.size()) < FLAGS_in_flight) {
+      in_flight.emplace_back(Clock::now(), client.SolveAsync(prog));
+      continue;
+    }
+    if (in_flight.empty()) {
+      break;
+    }
+    try {
+      in_flight.front().second.get();
+      statistics.latencies_us.push_back(
+          std::chrono::duration<double, std::micro>(Clock::now() - in_flight.front().first)
+              .count());
+    } catch (const std::exception&) {
+      ++statistics.num_errors;
+    }
+    in_flight.pop_front();
+  }
+  return statistics;
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  std::unique_ptr<drake_tutorials::SolverServer> server;
+  std::thread server_thread;
+  if (FLAGS_spawn_server) {
+    const int num_threads = FLAGS_server_threads > 0
+                                ? FLAGS_server_threads
+                                : drake_tutorials::ThreadPool::DefaultNumThreads();
+    server = std::make_unique<drake_tutorials::SolverServer>(FLAGS_socket, num_threads);
+    server_thread = std::thread([&] { server->Run(); });
+  }
+  const auto prog = MakeProgram(FLAGS_program);
+
+  // The in-process baseline: what one solve costs without the socket round trip.
+  const int num_baseline_solves = 1000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_baseline_solves; ++i) {
+    drake::solvers::Solve(*prog);
+  }
+  const double baseline_us =
+      std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+          .count() / num_baseline_solves;
+
+  std::vector<ConnectionStatistics> statistics(FLAGS_connections);
+  std::vector<std::thread> drivers;
+  start = std::chrono::steady_clock::now();
+  const auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                    std::chrono::duration<double>(FLAGS_duration));
+  for (int i = 0; i < FLAGS_connections; ++i) {
+    drivers.emplace_back([&, i] { statistics[i] = DriveConnection(*prog, deadline); });
+  }
+  for (auto& driver : drivers) {
+    driver.join();
+  }
+  const double elapsed =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::vector<double> latencies;
+  int num_errors = 0;
+  for (const auto& s : statistics) {
+    latencies.insert(latencies.end(), s.latencies_us.begin(), s.latencies_us.end());
+    num_errors += s.num_errors;
+  }
+  print("program ", FLAGS_program, ", ", FLAGS_connections, " connection(s) with ",
+        FLAGS_in_flight, " request(s) in flight each, in-process solve ", baseline_us, " us");
+  if (latencies.empty()) {
+    print("no request completed, ", num_errors, " error(s)");
+  } else {
+    using drake_tutorials::Percentile;
+    print(latencies.size(), " requests in ", elapsed, " s: ", latencies.size() / elapsed,
+          " requests/s, ", num_errors, " error(s)\nlatency p50 ", Percentile(latencies, 0.5),
+          " us, p90 ", Percentile(latencies, 0.9), " us, p99 ", Percentile(latencies, 0.99),
+          " us, p99.9 ", Percentile(latencies, 0.999), " us, max ",
+          *std::max_element(latencies.begin(), latencies.end()), " us");
+  }
+
+  if (server != nullptr) {
+    server->Stop();
+    server_thread.join();
+  }
+  return num_errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <drake/solvers/choose_best_solver.h>
+
+#include "program_codec.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+// The wire protocol between SolverServer and SolverClient. Messages travel over a Unix domain
+// stream socket as frames: a uint32 payload length followed by the payload.
+//
+//   request:  uint64 request id | string solver name ("" lets the server choose) | program
+//   response: uint64 request id | uint8 ok | ok ? result : string error message
+//
+// Programs and results use the encoding of program_codec.h; results include the dual solutions
+// when the solver reports them. Both ends run on the same machine, so integers are in host byte
+// order.
+namespace drake_tutorials {
+namespace internal {
+
+constexpr std::uint32_t kMaxFrameSize = 1u << 30;
+
+inline std::system_error SocketError(const std::string& what) {
+  return std::system_error(errno, std::generic_category(), what);
+}
+
+// Writes all of `size` bytes, retrying on partial writes. Returns false if the peer is gone.
+inline bool WriteFully(int fd, const char* data, std::size_t size) {
+  while (size > 0) {
+    const ssize_t written = send(fd, data, size, MSG_NOSIGNAL);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    size -= written;
+  }
+  return true;
+}
+
+// Reads exactly `size` bytes. Returns false on end of stream or error.
+inline bool ReadFully(int fd, char* data, std::size_t size) {
+  while (size > 0) {
+    const ssize_t n = recv(fd, data, size, 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+inline bool WriteFrame(int fd, const std::string& payload) {
+  const auto size = static_cast<std::uint32_t>(payload.size());
+  std::string frame(reinterpret_cast<const char*>(&size), sizeof(size));
+  frame += payload;
+  return WriteFully(fd, frame.data(), frame.size());
+}
+
+// Reads one frame into `payload`. Returns false when the connection is closed.
+inline bool ReadFrame(int fd, std::string* payload) {
+  std::uint32_t size;
+  if (!ReadFully(fd, reinterpret_cast<char*>(&size), sizeof(size))) {
+    return false;
+  }
+  if (size > kMaxFrameSize) {
+    throw std::runtime_error("ReadFrame: frame of " + std::to_string(size) + " bytes is too big.");
+  }
+  payload->resize(size);
+  return ReadFully(fd, payload->data(), size);
+}
+
+inline sockaddr_un UnixSocketAddress(const std::string& path) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) {
+    throw std::invalid_argument("Socket path " + path + " is too long.");
+  }
+  std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+  return address;
+}
+
+// Binds a listening socket at `path`, replacing a stale socket file left by an earlier server.
+inline int ListenOnUnixSocket(const std::string& path, int backlog = 128) {
+  const sockaddr_un address = UnixSocketAddress(path);
+  const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    throw SocketError("socket");
+  }
+  unlink(path.c_str());
+  if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+      listen(fd, backlog) != 0) {
+    const std::system_error error = SocketError("bind " + path);
+    close(fd);
+    throw error;
+  }
+  return fd;
+}
+
+inline int ConnectToUnixSocket(const std::string& path) {
+  const sockaddr_un address = UnixSocketAddress(path);
+  const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    throw SocketError("socket");
+  }
+  if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+    const std::system_error error = SocketError("connect " + path);
+    close(fd);
+    throw error;
+  }
+  return fd;
+}
+
+// Maps a solver name back to its id. SolverId compares by identity, not by name, so a
+// SolverId constructed from the name would not match the solver's own id.
+inline drake::solvers::SolverId FindKnownSolver(const std::string& name) {
+  for (const auto& id : drake::solvers::GetKnownSolvers()) {
+    if (id.name() == name) {
+      return id;
+    }
+  }
+  throw std::invalid_argument("Unknown solver " + name + ".");
+}
+
+}  // namespace internal
+}  // namespace drake_tutorials
@@ -0,0 +1,46 @@
+#include <drake/solvers/ipopt_solver.h>
+
+#include <gflags/gflags.h>
+
+#include "solver_concurrency.h"
+#include "solver_server.h"
+
+#include <csignal>
+#include <iostream>
+#include <thread>
+
+DEFINE_string(socket, "/tmp/drake_tutorials_solver.sock", "Path of the Unix domain socket.");
+DEFINE_int32(num_threads, 0,
+             "Number of solver threads; 0 means one per hardware thread. Ipopt solves only run in "
+             "parallel with a reentrant --linear_solver, see solver_concurrency.h.");
+DEFINE_string(linear_solver, "mumps", "Ipopt's linear solver.");
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  // SIGINT and SIGTERM are taken by a thread with sigwait() rather than a handler, because
+  // Stop() locks a mutex. They must be blocked before any other thread starts.
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  const int num_threads = FLAGS_num_threads > 0 ? FLAGS_num_threads
+                                                : drake_tutorials::ThreadPool::DefaultNumThreads();
+  drake::solvers::SolverOptions options;
+  options.SetOption(drake::solvers::IpoptSolver::id(), "linear_solver", FLAGS_linear_solver);
+  drake_tutorials::SolverServer server(FLAGS_socket, num_threads, options);
+  std::thread signal_thread([&] {
+    int signal;
+    sigwait(&signals, &signal);
+    server.Stop();
+  });
+  std::cout << "Serving on " << server.socket_path() << " with " << server.num_threads()
+            << " solver thread(s)"
+            << (drake_tutorials::IpoptIsReentrant(options) ? "" : ", Ipopt solves serialized")
+            << std::endl;
+  server.Run();
+  signal_thread.join();
+  std::cout << "Answered " << server.num_requests() << " request(s)" << std::endl;
+  return 0;
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <drake/solvers/choose_best_solver.h>
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/solver_interface.h>
+
+#include "batch_solve.h"
+#include "program_codec.h"
+#include "solver_concurrency.h"
+#include "solver_protocol.h"
+#include "thread_pool.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace drake_tutorials {
+
+/*
+ * A long-running solve service on a Unix domain socket, so clients pay for process startup,
+ * Drake's library loading and solver construction once instead of per solve.
+ *
+ * Every connection gets a reader thread that only splits the stream into request frames and
+ * hands them to a ThreadPool. The workers decode the program, solve it with the worker's own
+ * solver instances (created for every known solver when the server starts) and write the
+ * response as soon as it is ready. Clients may therefore pipeline requests on one connection;
+ * responses come back in completion order and carry the request id. See solver_protocol.h for
+ * the wire format.
+ *
+ * Solves go through SolveConcurrently(), so Ipopt solves on MUMPS run one at a time however many
+ * threads the server has (see solver_concurrency.h); `solver_options` apply to every solve.
+ */
+class SolverServer {
+ public:
+  explicit SolverServer(
+      const std::string& socket_path, int num_threads = ThreadPool::DefaultNumThreads(),
+      const std::optional<drake::solvers::SolverOptions>& solver_options = std::nullopt)
+      : socket_path_(socket_path),
+        solver_options_(solver_options),
+        solvers_(std::max(1, num_threads)),
+        pool_(num_threads),
+        listen_fd_(internal::ListenOnUnixSocket(socket_path)) {
+    for (auto& worker_solvers : solvers_) {
+      for (const auto& id : drake::solvers::GetKnownSolvers()) {
+        worker_solvers.Get(id);
+      }
+    }
+  }
+
+  SolverServer(const SolverServer&) = delete;
+  SolverServer& operator=(const SolverServer&) = delete;
+
+  ~SolverServer() {
+    Stop();
+    close(listen_fd_);
+    unlink(socket_path_.c_str());
+  }
+
+  // Accepts connections until Stop() is called, then waits for the connection readers to finish.
+  // Run() must have returned before the server is destroyed.
+  void Run() {
+    while (!stopping_) {
+      const int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+      if (fd < 0) {
+        if (errno == EINTR || errno == ECONNABORTED) {
+          continue;
+        }
+        break;
+      }
+      auto connection = std::make_shared<Connection>(fd);
+      std::lock_guard<std::mutex> lock(connections_mutex_);
+      if (stopping_) {
+        break;
+      }
+      connections_.erase(std::remove_if(connections_.begin(), connections_.end(),
+                                        [](const auto& weak) { return weak.expired(); }),
+                         connections_.end());
+      connections_.push_back(connection);
+      ++num_readers_;
+      std::thread([this, connection] { ReadRequests(connection); }).detach();
+    }
+    std::unique_lock<std::mutex> lock(connections_mutex_);
+    readers_done_.wait(lock, [this] { return num_readers_ == 0; });
+  }
+
+  // Makes Run() return. Requests that are already queued are still answered.
+  void Stop() {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    if (stopping_.exchange(true)) {
+      return;
+    }
+    shutdown(listen_fd_, SHUT_RDWR);
+    for (const auto& weak : connections_) {
+      if (const auto connection = weak.lock()) {
+        shutdown(connection->fd, SHUT_RD);
+      }
+    }
+  }
+
+  const std::string& socket_path() const { return socket_path_; }
+  int num_threads() const { return pool_.num_threads(); }
+  std::int64_t num_requests() const { return num_requests_; }
+
+ private:
+  struct Connection {
+    explicit Connection(int fd_in) : fd(fd_in) {}
+    ~Connection() { close(fd); }
+
+    void Send(const std::string& payload) {
+      std::lock_guard<std::mutex> lock(write_mutex);
+      internal::WriteFrame(fd, payload);
+    }
+
+    int fd;
+    std::mutex write_mutex;
+  };
+
+  void ReadRequests(const std::shared_ptr<Connection>& connection) {
+    try {
+      auto frame = std::make_shared<std::string>();
+      while (internal::ReadFrame(connection->fd, frame.get())) {
+        ++num_requests_;
+        pool_.Submit([this, connection, frame](int worker_index) {
+          connection->Send(Respond(*frame, worker_index));
+        });
+        frame = std::make_shared<std::string>();
+      }
+    } catch (const std::exception&) {
+      // An oversized frame; the stream cannot be resynchronized, so the connection is dropped.
+    }
+    shutdown(connection->fd, SHUT_RD);
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    if (--num_readers_ == 0) {
+      readers_done_.notify_all();
+    }
+  }
+
+  std::string Respond(const std::string& request, int worker_index) {
+    ByteReader reader(request);
+    ByteWriter response;
+    std::uint64_t request_id = 0;
+    try {
+      request_id = reader.Get<std::uint64_t>();
+      const std::string solver_name = reader.GetString();
+      const auto prog = DecodeProgram(&reader);
+      const drake::solvers::SolverId id = solver_name.empty()
+                                              ? drake::solvers::ChooseBestSolver(*prog)
+                                              : internal::FindKnownSolver(solver_name);
+      drake::solvers::MathematicalProgramResult result;
+      SolveConcurrently(solvers_[worker_index].Get(id), *prog, std::nullopt, solver_options_,
+                        &result);
+      response.Put<std::uint64_t>(request_id);
+      response.Put<std::uint8_t>(1);
+      EncodeResult(*prog, result, &response);
+    } catch (const std::exception& e) {
+      response = ByteWriter();
+      response.Put<std::uint64_t>(request_id);
+      response.Put<std::uint8_t>(0);
+      response.PutString(e.what());
+    }
+    return response.Release();
+  }
+
+  std::string socket_path_;
+  std::optional<drake::solvers::SolverOptions> solver_options_;
+  // Declared before the pool, so that they outlive the tasks still running at destruction.
+  std::vector<internal::WorkerSolvers> solvers_;
+  std::atomic<std::int64_t> num_requests_{0};
+  std::atomic<bool> stopping_{false};
+  std::mutex connections_mutex_;
+  std::vector<std::weak_ptr<Connection>> connections_;
+  int num_readers_{0};
+  std::condition_variable readers_done_;
+  ThreadPool pool_;
+  int listen_fd_;
+};
+
+}  // namespace drake_tutorials
@@ -0,0 +1,532 @@
+#pragma once
+
+#include <drake/solvers/choose_best_solver.h>
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+#include <drake/solvers/solver_interface.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Set to 0 to compile all tracing out; Tracer::set_enabled() switches it at runtime.
+#ifndef DRAKE_TUTORIALS_TRACING
+#define DRAKE_TUTORIALS_TRACING 1
+#endif
+
+namespace drake_tutorials {
+
+/*
+ * Collects a timeline of the phases of a solve and per-evaluator call statistics, and exports
+ * them as Chrome trace JSON (chrome://tracing, https://ui.perfetto.dev) and as a summary table.
+ *
+ * A disabled tracer costs one relaxed atomic load per phase or evaluator call. Evaluator calls
+ * are only aggregated by default; individual call events can be recorded for short runs. The
+ * timeline keeps the most recent Options::max_events events, so a tracer left enabled in a
+ * long-running process uses bounded memory; the summary table counts every event.
+ */
+class Tracer {
+ public:
+  struct Options {
+    bool enabled{true};
+    // Record every evaluator call as its own trace event, not only its aggregate.
+    bool record_evaluation_events{false};
+    // Ask Ipopt for its timing statistics (function evaluations, linear system factorization,
+    // ...) in TracedSolve(). This writes Ipopt's output to a temporary file on every solve, so
+    // it is meant for diagnosing single solves rather than for production.
+    bool ipopt_timing_statistics{false};
+    // Capacity of the timeline; once it is full, every new event replaces the oldest one.
+    int max_events{1 << 16};
+    // Number of evaluator names with their own statistics. Evaluators with the same name share
+    // them, and once this many names are registered, evaluators with a new name are counted
+    // together under "(other)".
+    int max_evaluators{1024};
+  };
+
+  // Call count and total time of one evaluator, updated lock-free by the solver threads.
+  struct EvaluatorStatistics {
+    std::string name;
+    std::atomic<std::int64_t> calls{0};
+    std::atomic<std::int64_t> nanoseconds{0};
+  };
+
+  class Scope {
+   public:
+    Scope(Tracer* tracer, std::string name, std::string category)
+        : tracer_(tracer != nullptr && tracer->enabled() ? tracer : nullptr) {
+      if (tracer_ != nullptr) {
+        name_ = std::move(name);
+        category_ = std::move(category);
+        start_ = std::chrono::steady_clock::now();
+      }
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope() {
+      if (tracer_ != nullptr) {
+        tracer_->AddEvent(name_, category_, start_, std::chrono::steady_clock::now(), args_);
+      }
+    }
+
+    // Attaches "key": value to the event, shown when the event is selected in the trace viewer.
+    void AddArgument(const std::string& key, double value) {
+      if (tracer_ != nullptr) {
+        args_.emplace_back(key, value);
+      }
+    }
+
+   private:
+    Tracer* tracer_;
+    std::string name_;
+    std::string category_;
+    std::chrono::steady_clock::time_point start_;
+    std::vector<std::pair<std::string, double>> args_;
+  };
+
+  Tracer() : Tracer(Options{}) {}
+  explicit Tracer(const Options& options)
+      : options_(options),
+        enabled_(options.enabled && DRAKE_TUTORIALS_TRACING),
+        origin_(std::chrono::steady_clock::now()) {}
+
+  bool enabled() const {
+#if DRAKE_TUTORIALS_TRACING
+    return enabled_.load(std::memory_order_relaxed);
+#else
+    return false;
+#endif
+  }
+  void set_enabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+  const Options& options() const { return options_; }
+
+  // Times the enclosing block as one phase, e.g. `auto scope = tracer.Trace("build program");`.
+  Scope Trace(std::string name, std::string category = "phase") {
+    return Scope(this, std::move(name), std::move(category));
+  }
+
+  void AddEvent(const std::string& name, const std::string& category,
+                std::chrono::steady_clock::time_point start,
+                std::chrono::steady_clock::time_point end,
+                const std::vector<std::pair<std::string, double>>& args = {}) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    const auto thread = threads_.try_emplace(std::this_thread::get_id(), threads_.size()).first;
+    Event event{name, category, Microseconds(start), Microseconds(end) - Microseconds(start),
+                thread->second, args};
+    if (events_.size() < static_cast<size_t>(std::max(1, options_.max_events))) {
+      events_.push_back(std::move(event));
+    } else {
+      events_[next_event_] = std::move(event);
+      next_event_ = (next_event_ + 1) % events_.size();
+      ++num_dropped_events_;
+    }
+    auto& total = phase_totals_[category + "/" + name];
+    ++total.first;
+    total.second += std::chrono::duration<double>(end - start).count();
+  }
+
+  // Adds a duration measured elsewhere to the summary table, without a timeline event.
+  void AddToSummary(const std::string& name, const std::string& category, double seconds) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    auto& total = phase_totals_[category + "/" + name];
+    ++total.first;
+    total.second += seconds;
+  }
+
+  // Counters for an evaluator named `name`; see TracedCost and TracedConstraint. Programs that are
+  // instrumented over and over again reuse the counters of their evaluators' names.
+  std::shared_ptr<EvaluatorStatistics> RegisterEvaluator(const std::string& name) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    const bool full =
+        static_cast<int>(evaluators_.size()) >= std::max(1, options_.max_evaluators);
+    const std::string& key = full && evaluator_index_.count(name) == 0 ? kOther : name;
+    const auto [it, inserted] = evaluator_index_.try_emplace(key, evaluators_.size());
+    if (inserted) {
+      auto statistics = std::make_shared<EvaluatorStatistics>();
+      statistics->name = key;
+      evaluators_.push_back(std::move(statistics));
+    }
+    return evaluators_[it->second];
+  }
+
+  void WriteChromeTrace(const std::string& path) const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    std::ofstream out(path);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    for (size_t i = 0; i < events_.size(); ++i) {
+      // Oldest first; next_event_ is the oldest event once the timeline is full.
+      const Event& e = events_[(next_event_ + i) % events_.size()];
+      out << (i == 0 ? "\n" : ",\n") << "  {\"name\": " << JsonString(e.name)
+          << ", \"cat\": " << JsonString(e.category) << ", \"ph\": \"X\", \"ts\": "
+          << JsonNumber(e.start_us) << ", \"dur\": " << JsonNumber(e.duration_us)
+          << ", \"pid\": 1, \"tid\": " << e.thread;
+      if (!e.args.empty()) {
+        out << ", \"args\": {";
+        for (size_t j = 0; j < e.args.size(); ++j) {
+          out << (j == 0 ? "" : ", ") << JsonString(e.args[j].first) << ": "
+              << JsonNumber(e.args[j].second);
+        }
+        out << "}";
+      }
+      out << "}";
+    }
+    // The evaluator aggregates as one instant event at the end of the timeline.
+    double end_us = 0;
+    for (const Event& e : events_) {
+      end_us = std::max(end_us, e.start_us + e.duration_us);
+    }
+    out << (events_.empty() ? "\n" : ",\n")
+        << "  {\"name\": \"evaluator statistics\", \"cat\": \"evaluation\", \"ph\": \"i\", "
+        << "\"s\": \"g\", \"ts\": " << JsonNumber(end_us) << ", \"pid\": 1, \"tid\": 0, "
+        << "\"args\": {";
+    for (size_t i = 0; i < evaluators_.size(); ++i) {
+      out << (i == 0 ? "" : ", ") << JsonString(evaluators_[i]->name) << ": {\"calls\": "
+          << evaluators_[i]->calls.load() << ", \"total_us\": "
+          << JsonNumber(evaluators_[i]->nanoseconds.load() * 1e-3) << "}";
+    }
+    out << "}}\n]}\n";
+  }
+
+  // One line per phase (summed over its occurrences) and per evaluator.
+  std::string SummaryTable() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream out;
+    out << std::left << std::setw(48) << "phase / evaluator" << std::right << std::setw(10)
+        << "count" << std::setw(14) << "total [ms]" << std::setw(14) << "mean [us]" << "\n";
+    auto row = [&](const std::string& name, std::int64_t count, double seconds) {
+      out << std::left << std::setw(48) << name << std::right << std::setw(10) << count
+          << std::setw(14) << std::fixed << std::setprecision(3) << seconds * 1e3 << std::setw(14)
+          << (count > 0 ? seconds * 1e6 / count : 0.0) << "\n";
+    };
+    for (const auto& [name, total] : phase_totals_) {
+      row(name, total.first, total.second);
+    }
+    for (const auto& statistics : evaluators_) {
+      row("evaluation/" + statistics->name, statistics->calls.load(),
+          statistics->nanoseconds.load() * 1e-9);
+    }
+    return out.str();
+  }
+
+  // Timeline events that were replaced by newer ones since the last Clear().
+  std::int64_t num_dropped_events() const {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return num_dropped_events_;
+  }
+
+  void Clear() {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    events_.clear();
+    next_event_ = 0;
+    num_dropped_events_ = 0;
+    phase_totals_.clear();
+    for (const auto& statistics : evaluators_) {
+      statistics->calls = 0;
+      statistics->nanoseconds = 0;
+    }
+  }
+
+ private:
+  struct Event {
+    std::string name;
+    std::string category;
+    double start_us;
+    double duration_us;
+    int thread;
+    std::vector<std::pair<std::string, double>> args;
+  };
+
+  double Microseconds(std::chrono::steady_clock::time_point t) const {
+    return std::chrono::duration<double, std::micro>(t - origin_).count();
+  }
+
+  static std::string JsonNumber(double value) {
+    if (!std::isfinite(value)) {
+      return "null";
+    }
+    std::ostringstream out;
+    out.precision(12);
+    out << value;
+    return out.str();
+  }
+
+  static std::string JsonString(const std::string& value) {
+    std::string out = "\"";
+    for (char c : value) {
+      if (c == '"' || c == '\\') {
+        out += '\\';
+      }
+      out += (c == '\n') ? ' ' : c;
+    }
+    return out + "\"";
+  }
+
+  inline static const std::string kOther = "(other)";
+
+  const Options options_;
+  std::atomic<bool> enabled_;
+  const std::chrono::steady_clock::time_point origin_;
+  mutable std::mutex mutex_;
+  // A ring buffer of at most Options::max_events events.
+  std::vector<Event> events_;
+  size_t next_event_{0};
+  std::int64_t num_dropped_events_{0};
+  std::map<std::string, std::pair<std::int64_t, double>> phase_totals_;
+  std::unordered_map<std::thread::id, int> threads_;
+  // At most Options::max_evaluators + 1 entries (the last one for "(other)"), indexed by name.
+  std::vector<std::shared_ptr<EvaluatorStatistics>> evaluators_;
+  std::unordered_map<std::string, size_t> evaluator_index_;
+};
+
+namespace internal {
+
+// Times calls of `evaluator` into the tracer's statistics, one entry for values and one for
+// gradients (the AutoDiffXd overload).
+class TracedEvaluation {
+ public:
+  TracedEvaluation(std::shared_ptr<drake::solvers::EvaluatorBase> evaluator, Tracer* tracer,
+                   const std::string& kind)
+      : evaluator_(std::move(evaluator)),
+        tracer_(tracer),
+        value_(tracer->RegisterEvaluator(Name(kind + " value"))),
+        gradient_(tracer->RegisterEvaluator(Name(kind + " gradient"))) {}
+
+  template <typename X, typename Y>
+  void Eval(const X& x, Y* y, bool gradient) const {
+    if (!tracer_->enabled()) {
+      evaluator_->Eval(x, y);
+      return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    evaluator_->Eval(x, y);
+    const auto end = std::chrono::steady_clock::now();
+    Tracer::EvaluatorStatistics& statistics = gradient ? *gradient_ : *value_;
+    statistics.calls.fetch_add(1, std::memory_order_relaxed);
+    statistics.nanoseconds.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(),
+        std::memory_order_relaxed);
+    if (tracer_->options().record_evaluation_events) {
+      tracer_->AddEvent(statistics.name, "evaluation", start, end);
+    }
+  }
+
+  const drake::solvers::EvaluatorBase& evaluator() const { return *evaluator_; }
+
+ private:
+  std::string Name(const std::string& kind) const {
+    const std::string& description = evaluator_->get_description();
+    return kind + " " + (description.empty() ? "(unnamed)" : description);
+  }
+
+  std::shared_ptr<drake::solvers::EvaluatorBase> evaluator_;
+  Tracer* tracer_;
+  std::shared_ptr<Tracer::EvaluatorStatistics> value_;
+  std::shared_ptr<Tracer::EvaluatorStatistics> gradient_;
+};
+
+}  // namespace internal
+
+// A cost that forwards to `cost` and reports its calls to a Tracer.
+class TracedCost : public drake::solvers::Cost {
+ public:
+  TracedCost(std::shared_ptr<drake::solvers::Cost> cost, Tracer* tracer)
+      : Cost(cost->num_vars(), cost->get_description()), evaluation_(cost, tracer, "cost") {}
+
+ private:
+  void DoEval(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::VectorXd* y) const override {
+    evaluation_.Eval(x, y, false);
+  }
+  void DoEval(const Eigen::Ref<const drake::AutoDiffVecXd>& x,
+              drake::AutoDiffVecXd* y) const override {
+    evaluation_.Eval(x, y, true);
+  }
+  void DoEval(const Eigen::Ref<const drake::VectorX<drake::symbolic::Variable>>& x,
+              drake::VectorX<drake::symbolic::Expression>* y) const override {
+    evaluation_.evaluator().Eval(x, y);
+  }
+
+  internal::TracedEvaluation evaluation_;
+};
+
+// A constraint that forwards to `constraint` and reports its calls to a Tracer.
+class TracedConstraint : public drake::solvers::Constraint {
+ public:
+  TracedConstraint(std::shared_ptr<drake::solvers::Constraint> constraint, Tracer* tracer)
+      : Constraint(constraint->num_constraints(), constraint->num_vars(),
+                   constraint->lower_bound(), constraint->upper_bound(),
+                   constraint->get_description()),
+        evaluation_(constraint, tracer, "constraint") {}
+
+ private:
+  void DoEval(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::VectorXd* y) const override {
+    evaluation_.Eval(x, y, false);
+  }
+  void DoEval(const Eigen::Ref<const drake::AutoDiffVecXd>& x,
+              drake::AutoDiffVecXd* y) const override {
+    evaluation_.Eval(x, y, true);
+  }
+  void DoEval(const Eigen::Ref<const drake::VectorX<drake::symbolic::Variable>>& x,
+              drake::VectorX<drake::symbolic::Expression>* y) const override {
+    evaluation_.evaluator().Eval(x, y);
+  }
+
+  internal::TracedEvaluation evaluation_;
+};
+
+enum class EvaluatorWrapping {
+  // Only generic costs and constraints are traced, so every solver still sees linear and quadratic
+  // costs and constraints as such.
+  kGenericOnly,
+  // Every cost and constraint becomes a traced generic one. Only nonlinear solvers can then solve
+  // the program, but they evaluate linear and quadratic terms through Eval() anyway.
+  kAll,
+};
+
+/*
+ * Returns a copy of `prog` with its costs and constraints wrapped in TracedCost and
+ * TracedConstraint. The copy has the same decision variables and initial guess; visualization
+ * callbacks are not copied. `tracer` must outlive the returned program.
+ */
+inline std::unique_ptr<drake::solvers::MathematicalProgram> InstrumentProgram(
+    const drake::solvers::MathematicalProgram& prog, Tracer* tracer,
+    EvaluatorWrapping wrapping = EvaluatorWrapping::kGenericOnly) {
+  auto scope = tracer->Trace("instrument program");
+  auto traced = std::make_unique<drake::solvers::MathematicalProgram>();
+  traced->AddDecisionVariables(prog.decision_variables());
+  traced->SetInitialGuessForAllVariables(prog.initial_guess());
+
+  std::unordered_set<const drake::solvers::EvaluatorBase*> generic;
+  for (const auto& binding : prog.generic_costs()) {
+    generic.insert(binding.evaluator().get());
+  }
+  for (const auto& binding : prog.generic_constraints()) {
+    generic.insert(binding.evaluator().get());
+  }
+  auto wrap = [&](const auto& binding) {
+    return wrapping == EvaluatorWrapping::kAll || generic.count(binding.evaluator().get()) > 0;
+  };
+  for (const auto& binding : prog.GetAllCosts()) {
+    if (wrap(binding)) {
+      traced->AddCost(std::make_shared<TracedCost>(binding.evaluator(), tracer),
+                      binding.variables());
+    } else {
+      traced->AddCost(binding);
+    }
+  }
+  for (const auto& binding : prog.GetAllConstraints()) {
+    if (wrap(binding)) {
+      traced->AddConstraint(std::make_shared<TracedConstraint>(binding.evaluator(), tracer),
+                            binding.variables());
+    } else {
+      traced->AddConstraint(binding);
+    }
+  }
+  return traced;
+}
+
+namespace internal {
+
+// Reads Ipopt's "Timing Statistics" block ("Name....: cpu (sys: s wall: w)") from its output
+// file and returns the wall times in seconds by name.
+inline std::vector<std::pair<std::string, double>> ReadIpoptTimingStatistics(
+    const std::string& path) {
+  std::vector<std::pair<std::string, double>> timings;
+  std::ifstream in(path);
+  std::string line;
+  bool in_block = false;
+  while (std::getline(in, line)) {
+    if (line.rfind("Timing Statistics", 0) == 0) {
+      in_block = true;
+      continue;
+    }
+    const size_t dots = line.find("..");
+    const size_t wall = line.find("wall:");
+    if (!in_block || dots == std::string::npos || wall == std::string::npos) {
+      continue;
+    }
+    const size_t begin = line.find_first_not_of(' ');
+    timings.emplace_back(line.substr(begin, dots - begin),
+                         std::strtod(line.c_str() + wall + 5, nullptr));
+  }
+  return timings;
+}
+
+}  // namespace internal
+
+/*
+ * Solves `prog` (instrumented or not) and traces solver selection and construction, and the solve
+ * itself. The solve event carries the success, optimal cost and solution norm as arguments.
+ * Drake's solvers extract the result inside Solve(), so that is part of the solve event.
+ *
+ * With Options::ipopt_timing_statistics, the solve event of an Ipopt solve also carries Ipopt's
+ * own timing statistics, including function evaluations and the linear system factorization,
+ * and they are added to the summary as "ipopt/..." phases. `tracer` may be null.
+ */
+inline drake::solvers::MathematicalProgramResult TracedSolve(
+    const drake::solvers::MathematicalProgram& prog, Tracer* tracer,
+    const std::optional<drake::solvers::SolverId>& solver_id = std::nullopt,
+    const std::optional<Eigen::VectorXd>& initial_guess = std::nullopt,
+    const std::optional<drake::solvers::SolverOptions>& solver_options = std::nullopt) {
+  std::unique_ptr<drake::solvers::SolverInterface> solver;
+  {
+    Tracer::Scope scope(tracer, "solver setup", "phase");
+    solver = drake::solvers::MakeSolver(solver_id.value_or(
+        drake::solvers::ChooseBestSolver(prog)));
+  }
+  drake::solvers::SolverOptions options = solver_options.value_or(
+      drake::solvers::SolverOptions());
+  std::string ipopt_output;
+  const bool ipopt_timing = tracer != nullptr && tracer->enabled() &&
+                            tracer->options().ipopt_timing_statistics &&
+                            solver->solver_id() == drake::solvers::IpoptSolver::id();
+  if (ipopt_timing) {
+    // Unique per process and solve, so that concurrent solves and processes sharing the
+    // temporary directory never read each other's output.
+    static std::atomic<std::uint64_t> counter{0};
+    ipopt_output = (std::filesystem::temp_directory_path() /
+                    ("ipopt_timing_" + std::to_string(::getpid()) + "_" +
+                     std::to_string(counter.fetch_add(1)) + ".txt"))
+                       .string();
+    options.SetOption(drake::solvers::IpoptSolver::id(), "output_file", ipopt_output);
+    options.SetOption(drake::solvers::IpoptSolver::id(), "print_timing_statistics",
+                      std::string("yes"));
+  }
+
+  drake::solvers::MathematicalProgramResult result;
+  {
+    Tracer::Scope scope(tracer, "solve " + solver->solver_id().name(), "phase");
+    solver->Solve(prog, initial_guess, options, &result);
+    if (ipopt_timing) {
+      // Ipopt only reports totals, so they are not placed on the timeline.
+      for (const auto& [name, seconds] : internal::ReadIpoptTimingStatistics(ipopt_output)) {
+        scope.AddArgument(name + " [ms]", seconds * 1e3);
+        tracer->AddToSummary(name, "ipopt", seconds);
+      }
+      std::filesystem::remove(ipopt_output);
+    }
+    scope.AddArgument("success", result.is_success());
+    scope.AddArgument("optimal cost", result.get_optimal_cost());
+    scope.AddArgument("solution norm", result.get_x_val().norm());
+  }
+  return result;
+}
+
+}  // namespace drake_tutorials
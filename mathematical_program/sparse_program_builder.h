@@ -0,0 +1,261 @@
+#pragma once
+
+#include <drake/solvers/mathematical_program.h>
+
+#include <Eigen/SparseCore>
+
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace drake_tutorials {
+
+// The bindings appended by SparseProgramBuilder::AppendTo(); empty where there was nothing to add.
+struct SparseProgramBindings {
+  std::vector<drake::solvers::Binding<drake::solvers::LinearConstraint>> linear_constraints;
+  std::vector<drake::solvers::Binding<drake::solvers::LinearEqualityConstraint>>
+      linear_equality_constraints;
+  std::vector<drake::solvers::Binding<drake::solvers::LinearCost>> linear_costs;
+  std::vector<drake::solvers::Binding<drake::solvers::QuadraticCost>> quadratic_costs;
+};
+
+/*
+ * Collects linear constraints lower <= A x <= upper and the cost 0.5 x'Q x + c'x + constant over
+ * a fixed vector of variables x as triplets, and appends them to a MathematicalProgram at once.
+ * It is the bulk counterpart of
+ *    for (...) prog.AddLinearConstraint(x(i) + x(j) <= 1);
+ *    for (...) prog.AddQuadraticCost(x(i) * x(i));
+ * which builds and decomposes a symbolic expression per row and adds a binding per call.
+ *
+ * Rows come either one coefficient at a time (NewRow() and AddCoefficient()) or as whole sparse
+ * matrices (AddLinearConstraints()). AppendTo() adds
+ *  - one LinearEqualityConstraint for the rows with lower == upper,
+ *  - one LinearConstraint with a sparse A for the other rows,
+ *  - one LinearCost for c and the constant,
+ *  - one QuadraticCost per connected block of Q; Drake stores Q dense, so a Q coupling all N
+ *    variables costs N^2 memory, while a separable one costs N bindings of size 1.
+ * Duplicate triplets are summed.
+ */
+class SparseProgramBuilder {
+ public:
+  explicit SparseProgramBuilder(drake::solvers::VectorXDecisionVariable x) : x_(std::move(x)) {}
+
+  int num_vars() const { return x_.size(); }
+  int num_rows() const { return lower_.size(); }
+
+  // Preallocates storage for rows, their nonzeros and the nonzeros of Q.
+  void Reserve(int num_rows, int num_nonzeros, int num_quadratic_nonzeros = 0) {
+    lower_.reserve(num_rows);
+    upper_.reserve(num_rows);
+    triplets_.reserve(num_nonzeros);
+    quadratic_triplets_.reserve(num_quadratic_nonzeros);
+  }
+
+  // Starts the row lower <= a'x <= upper with a = 0 and returns its index.
+  int NewRow(double lower, double upper) {
+    if (!(lower <= upper)) {
+      throw std::invalid_argument("SparseProgramBuilder: a row needs lower <= upper.");
+    }
+    lower_.push_back(lower);
+    upper_.push_back(upper);
+    return lower_.size() - 1;
+  }
+
+  void AddCoefficient(int row, int var, double value) {
+    CheckVariable(var);
+    if (row < 0 || row >= num_rows()) {
+      throw std::out_of_range("SparseProgramBuilder: no such row.");
+    }
+    triplets_.emplace_back(row, var, value);
+  }
+
+  // Appends the rows lower <= A x <= upper.
+  void AddLinearConstraints(const Eigen::SparseMatrix<double>& A, const Eigen::VectorXd& lower,
+                            const Eigen::VectorXd& upper) {
+    if (A.cols() != num_vars() || lower.size() != A.rows() || upper.size() != A.rows()) {
+      throw std::invalid_argument("SparseProgramBuilder: A, lower and upper do not match.");
+    }
+    const int first = num_rows();
+    lower_.reserve(first + A.rows());
+    upper_.reserve(first + A.rows());
+    for (int i = 0; i < A.rows(); ++i) {
+      NewRow(lower(i), upper(i));
+    }
+    triplets_.reserve(triplets_.size() + A.nonZeros());
+    for (int k = 0; k < A.outerSize(); ++k) {
+      for (Eigen::SparseMatrix<double>::InnerIterator it(A, k); it; ++it) {
+        triplets_.emplace_back(first + it.row(), it.col(), it.value());
+      }
+    }
+  }
+
+  // Adds value to Q(i, j) and Q(j, i) of the cost 0.5 x'Q x, i.e. value * x(i) x(j) for i != j.
+  // A diagonal entry is added once, i.e. 0.5 * value * x(i)^2 for i == j.
+  void AddQuadraticCoefficient(int i, int j, double value) {
+    CheckVariable(i);
+    CheckVariable(j);
+    quadratic_triplets_.emplace_back(i, j, value);
+    if (i != j) {
+      quadratic_triplets_.emplace_back(j, i, value);
+    }
+  }
+
+  // Adds 0.5 x'Q x + c'x to the cost. Q must be symmetric.
+  void AddQuadraticCost(const Eigen::SparseMatrix<double>& Q, const Eigen::VectorXd& c) {
+    if (Q.rows() != num_vars() || Q.cols() != num_vars() || c.size() != num_vars()) {
+      throw std::invalid_argument("SparseProgramBuilder: Q and c do not match the variables.");
+    }
+    quadratic_triplets_.reserve(quadratic_triplets_.size() + Q.nonZeros());
+    for (int k = 0; k < Q.outerSize(); ++k) {
+      for (Eigen::SparseMatrix<double>::InnerIterator it(Q, k); it; ++it) {
+        quadratic_triplets_.emplace_back(it.row(), it.col(), it.value());
+      }
+    }
+    AddLinearCost(c);
+  }
+
+  void AddLinearCost(const Eigen::VectorXd& c, double constant = 0) {
+    if (c.size() != num_vars()) {
+      throw std::invalid_argument("SparseProgramBuilder: c does not match the variables.");
+    }
+    LinearCost() += c;
+    constant_ += constant;
+  }
+
+  void AddLinearCostCoefficient(int var, double value) {
+    CheckVariable(var);
+    LinearCost()(var) += value;
+  }
+
+  // Appends everything collected so far to `prog`, which must own the variables.
+  SparseProgramBindings AppendTo(drake::solvers::MathematicalProgram* prog) const {
+    SparseProgramBindings bindings;
+    AppendLinearConstraints(prog, &bindings);
+    if (c_.size() > 0 || constant_ != 0) {
+      bindings.linear_costs.push_back(prog->AddLinearCost(
+          c_.size() > 0 ? c_ : Eigen::VectorXd::Zero(num_vars()), constant_, x_));
+    }
+    AppendQuadraticCosts(prog, &bindings);
+    return bindings;
+  }
+
+ private:
+  void CheckVariable(int var) const {
+    if (var < 0 || var >= num_vars()) {
+      throw std::out_of_range("SparseProgramBuilder: no such variable.");
+    }
+  }
+
+  Eigen::VectorXd& LinearCost() {
+    if (c_.size() == 0) {
+      c_ = Eigen::VectorXd::Zero(num_vars());
+    }
+    return c_;
+  }
+
+  // Splits the rows into equalities and inequalities and renumbers each part consecutively.
+  void AppendLinearConstraints(drake::solvers::MathematicalProgram* prog,
+                               SparseProgramBindings* bindings) const {
+    const int m = num_rows();
+    std::vector<int> renumbered(m);
+    int num_equalities = 0;
+    int num_inequalities = 0;
+    for (int i = 0; i < m; ++i) {
+      renumbered[i] = lower_[i] == upper_[i] ? num_equalities++ : num_inequalities++;
+    }
+    std::vector<Eigen::Triplet<double>> equality_triplets, inequality_triplets;
+    equality_triplets.reserve(num_equalities > 0 ? triplets_.size() : 0);
+    inequality_triplets.reserve(num_inequalities > 0 ? triplets_.size() : 0);
+    for (const auto& t : triplets_) {
+      (lower_[t.row()] == upper_[t.row()] ? equality_triplets : inequality_triplets)
+          .emplace_back(renumbered[t.row()], t.col(), t.value());
+    }
+    Eigen::VectorXd b(num_equalities), lower(num_inequalities), upper(num_inequalities);
+    for (int i = 0; i < m; ++i) {
+      if (lower_[i] == upper_[i]) {
+        b(renumbered[i]) = lower_[i];
+      } else {
+        lower(renumbered[i]) = lower_[i];
+        upper(renumbered[i]) = upper_[i];
+      }
+    }
+    if (num_equalities > 0) {
+      Eigen::SparseMatrix<double> A(num_equalities, num_vars());
+      A.setFromTriplets(equality_triplets.begin(), equality_triplets.end());
+      bindings->linear_equality_constraints.push_back(prog->AddLinearEqualityConstraint(A, b, x_));
+    }
+    if (num_inequalities > 0) {
+      Eigen::SparseMatrix<double> A(num_inequalities, num_vars());
+      A.setFromTriplets(inequality_triplets.begin(), inequality_triplets.end());
+      bindings->linear_constraints.push_back(prog->AddLinearConstraint(A, lower, upper, x_));
+    }
+  }
+
+  // Groups the variables coupled through Q with a union-find, and adds one dense QuadraticCost
+  // per group.
+  void AppendQuadraticCosts(drake::solvers::MathematicalProgram* prog,
+                            SparseProgramBindings* bindings) const {
+    if (quadratic_triplets_.empty()) {
+      return;
+    }
+    std::vector<int> parent(num_vars());
+    std::iota(parent.begin(), parent.end(), 0);
+    const auto find = [&parent](int i) {
+      while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+      }
+      return i;
+    };
+    std::vector<bool> quadratic(num_vars(), false);
+    for (const auto& t : quadratic_triplets_) {
+      quadratic[t.row()] = quadratic[t.col()] = true;
+      parent[find(t.row())] = find(t.col());
+    }
+    // Members of each group in increasing order, and every variable's position in its group.
+    std::vector<int> group(num_vars(), -1);
+    std::vector<int> position(num_vars());
+    std::vector<std::vector<int>> members;
+    for (int i = 0; i < num_vars(); ++i) {
+      if (!quadratic[i]) {
+        continue;
+      }
+      const int root = find(i);
+      if (group[root] < 0) {
+        group[root] = members.size();
+        members.emplace_back();
+      }
+      group[i] = group[root];
+      position[i] = members[group[i]].size();
+      members[group[i]].push_back(i);
+    }
+    std::vector<Eigen::MatrixXd> Q(members.size());
+    for (size_t g = 0; g < members.size(); ++g) {
+      Q[g] = Eigen::MatrixXd::Zero(members[g].size(), members[g].size());
+    }
+    for (const auto& t : quadratic_triplets_) {
+      Q[group[t.row()]](position[t.row()], position[t.col()]) += t.value();
+    }
+    bindings->quadratic_costs.reserve(members.size());
+    for (size_t g = 0; g < members.size(); ++g) {
+      drake::solvers::VectorXDecisionVariable vars(members[g].size());
+      for (size_t k = 0; k < members[g].size(); ++k) {
+        vars(k) = x_(members[g][k]);
+      }
+      bindings->quadratic_costs.push_back(
+          prog->AddQuadraticCost(Q[g], Eigen::VectorXd::Zero(vars.size()), vars));
+    }
+  }
+
+  drake::solvers::VectorXDecisionVariable x_;
+  std::vector<double> lower_;
+  std::vector<double> upper_;
+  std::vector<Eigen::Triplet<double>> triplets_;
+  std::vector<Eigen::Triplet<double>> quadratic_triplets_;
+  // Empty until the first linear cost term.
+  Eigen::VectorXd c_;
+  double constant_{0};
+};
+
+}  // namespace drake_tutorials
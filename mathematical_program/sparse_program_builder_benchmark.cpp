@@ -0,0 +1,132 @@
+#include <drake/solvers/mathematical_program.h>
+
+#include <gflags/gflags.h>
+
+#include "sparse_program_builder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+DEFINE_string(rows, "1000,10000,100000,1000000", "Comma-separated numbers of constraint rows.");
+DEFINE_int32(max_symbolic_rows, 1000000,
+             "Larger programs are only built through SparseProgramBuilder; 0 means no limit.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/*
+ * The benchmark program over n = m variables, with m rows
+ *    0 <= x(i) + 2 x(i + 1 mod n) <= 1, every tenth row an equality x(i) + 2 x(i + 1 mod n) == 1
+ * and the cost sum_k (x(2k) - x(2k + 1))^2 + sum_i x(i)^2 + x(i), coupling the variables in pairs.
+ */
+bool IsEquality(int row) { return row % 10 == 0; }
+
+std::unique_ptr<drake::solvers::MathematicalProgram> BuildSymbolic(int m) {
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  const auto x = prog->NewContinuousVariables(m, "x");
+  for (int i = 0; i < m; ++i) {
+    const drake::symbolic::Expression row = x(i) + 2 * x((i + 1) % m);
+    if (IsEquality(i)) {
+      prog->AddLinearEqualityConstraint(row == 1);
+    } else {
+      prog->AddLinearConstraint(row, 0, 1);
+    }
+  }
+  for (int k = 0; 2 * k + 1 < m; ++k) {
+    prog->AddQuadraticCost(pow(x(2 * k) - x(2 * k + 1), 2));
+  }
+  for (int i = 0; i < m; ++i) {
+    prog->AddQuadraticCost(x(i) * x(i) + x(i));
+  }
+  return prog;
+}
+
+std::unique_ptr<drake::solvers::MathematicalProgram> BuildSparse(int m) {
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  const auto x = prog->NewContinuousVariables(m, "x");
+  drake_tutorials::SparseProgramBuilder builder(x);
+  builder.Reserve(m, 2 * m, 3 * m);
+  for (int i = 0; i < m; ++i) {
+    const int row = IsEquality(i) ? builder.NewRow(1, 1) : builder.NewRow(0, 1);
+    builder.AddCoefficient(row, i, 1);
+    builder.AddCoefficient(row, (i + 1) % m, 2);
+  }
+  for (int k = 0; 2 * k + 1 < m; ++k) {
+    builder.AddQuadraticCoefficient(2 * k, 2 * k, 2);
+    builder.AddQuadraticCoefficient(2 * k + 1, 2 * k + 1, 2);
+    builder.AddQuadraticCoefficient(2 * k, 2 * k + 1, -2);
+  }
+  for (int i = 0; i < m; ++i) {
+    builder.AddQuadraticCoefficient(i, i, 2);
+    builder.AddLinearCostCoefficient(i, 1);
+  }
+  builder.AppendTo(prog.get());
+  return prog;
+}
+
+// The total cost and the summed bound violation of all constraints at x; equal for equivalent
+// programs regardless of how the rows are split into bindings.
+std::pair<double, double> Evaluate(const drake::solvers::MathematicalProgram& prog,
+                                   const Eigen::VectorXd& x) {
+  double cost = 0;
+  for (const auto& binding : prog.GetAllCosts()) {
+    cost += prog.EvalBinding(binding, x)(0);
+  }
+  double violation = 0;
+  for (const auto& binding : prog.GetAllConstraints()) {
+    const Eigen::VectorXd y = prog.EvalBinding(binding, x);
+    const auto& lower = binding.evaluator()->lower_bound();
+    const auto& upper = binding.evaluator()->upper_bound();
+    violation += (lower - y).cwiseMax(0).sum() + (y - upper).cwiseMax(0).sum();
+  }
+  return {cost, violation};
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  bool ok = true;
+  std::stringstream rows(FLAGS_rows);
+  for (std::string item; std::getline(rows, item, ',');) {
+    const int m = std::stoi(item);
+    auto start = std::chrono::steady_clock::now();
+    const auto sparse = BuildSparse(m);
+    const double sparse_time = SecondsSince(start);
+    print(m, " rows: SparseProgramBuilder ", sparse_time, " s, ",
+          sparse->GetAllConstraints().size(), " constraint and ", sparse->GetAllCosts().size(),
+          " cost bindings");
+    if (FLAGS_max_symbolic_rows > 0 && m > FLAGS_max_symbolic_rows) {
+      continue;
+    }
+    start = std::chrono::steady_clock::now();
+    const auto symbolic = BuildSymbolic(m);
+    const double symbolic_time = SecondsSince(start);
+    print("  symbolic ", symbolic_time, " s, ", symbolic->GetAllConstraints().size(),
+          " constraint and ", symbolic->GetAllCosts().size(), " cost bindings, speedup ",
+          symbolic_time / sparse_time, "x");
+
+    std::mt19937 generator(m);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    const Eigen::VectorXd x = Eigen::VectorXd::NullaryExpr(m, [&] { return uniform(generator); });
+    const auto [sparse_cost, sparse_violation] = Evaluate(*sparse, x);
+    const auto [symbolic_cost, symbolic_violation] = Evaluate(*symbolic, x);
+    const double difference = std::max(std::abs(sparse_cost - symbolic_cost),
+                                        std::abs(sparse_violation - symbolic_violation));
+    print("  difference at a random point ", difference);
+    ok &= difference <= 1e-8 * (1 + std::abs(symbolic_cost) + symbolic_violation);
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace drake_tutorials {
+
+/*
+ * A small work-stealing thread pool.
+ *
+ * Every worker owns a task deque. A worker pops tasks from the back of its own deque and, when it
+ * runs dry, steals from the front of the other workers' deques. Tasks receive the index of the
+ * worker running them, so callers can keep per-worker state (e.g. one solver instance per worker)
+ * without any locking. Idle workers sleep on a condition variable.
+ */
+class ThreadPool {
+ public:
+  using Task = std::function<void(int worker_index)>;
+
+  explicit ThreadPool(int num_threads = DefaultNumThreads()) {
+    num_threads = std::max(1, num_threads);
+    queues_.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+      queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    workers_.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+      workers_.emplace_back([this, i] { WorkerLoop(i); });
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(wake_mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  static int DefaultNumThreads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  int num_threads() const { return static_cast<int>(workers_.size()); }
+
+  // Enqueues a task. Tasks are distributed round-robin over the worker deques. A task must not
+  // throw; an exception escaping it terminates the process.
+  void Submit(Task task) {
+    const std::size_t queue_index = next_queue_++ % queues_.size();
+    {
+      std::lock_guard<std::mutex> lock(queues_[queue_index]->mutex);
+      queues_[queue_index]->tasks.push_back(std::move(task));
+    }
+    {
+      std::lock_guard<std::mutex> lock(wake_mutex_);
+      ++num_pending_;
+    }
+    wake_.notify_one();
+  }
+
+  // Runs body(worker_index, i) for every i in [0, n) and blocks until all calls returned. The range
+  // is split into chunks of `grain_size` indices; each chunk is one stealable task.
+  //
+  // If a call throws, the chunks that have not started yet are skipped and the first exception is
+  // rethrown here once the running chunks are done. Called from one of this pool's own workers,
+  // the loop runs inline on that worker, since waiting for the other workers could deadlock.
+  void ParallelFor(int n, const std::function<void(int worker_index, int i)>& body,
+                   int grain_size = 1) {
+    if (n <= 0) {
+      return;
+    }
+    const WorkerIdentity& caller = CurrentWorker();
+    if (caller.pool == this) {
+      for (int i = 0; i < n; ++i) {
+        body(caller.index, i);
+      }
+      return;
+    }
+    grain_size = std::max(1, grain_size);
+    const int num_chunks = (n + grain_size - 1) / grain_size;
+    std::mutex done_mutex;
+    std::condition_variable done;
+    int num_remaining = num_chunks;
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
+    for (int chunk = 0; chunk < num_chunks; ++chunk) {
+      const int begin = chunk * grain_size;
+      const int end = std::min(n, begin + grain_size);
+      Submit([&, begin, end](int worker_index) {
+        std::exception_ptr chunk_error;
+        try {
+          for (int i = begin; i < end && !failed; ++i) {
+            body(worker_index, i);
+          }
+        } catch (...) {
+          chunk_error = std::current_exception();
+          failed = true;
+        }
+        std::lock_guard<std::mutex> lock(done_mutex);
+        if (chunk_error && !error) {
+          error = chunk_error;
+        }
+        if (--num_remaining == 0) {
+          done.notify_one();
+        }
+      });
+    }
+    std::unique_lock<std::mutex> lock(done_mutex);
+    done.wait(lock, [&] { return num_remaining == 0; });
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+ private:
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  // The pool and worker index of the calling thread; `pool` is null outside of worker threads.
+  struct WorkerIdentity {
+    const ThreadPool* pool{nullptr};
+    int index{-1};
+  };
+
+  static WorkerIdentity& CurrentWorker() {
+    thread_local WorkerIdentity identity;
+    return identity;
+  }
+
+  bool PopOwn(int worker_index, Task* task) {
+    WorkerQueue& queue = *queues_[worker_index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+      return false;
+    }
+    *task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+  }
+
+  bool Steal(int worker_index, Task* task) {
+    const int n = static_cast<int>(queues_.size());
+    for (int offset = 1; offset < n; ++offset) {
+      WorkerQueue& victim = *queues_[(worker_index + offset) % n];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        *task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void WorkerLoop(int worker_index) {
+    CurrentWorker() = {this, worker_index};
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_.wait(lock, [this] { return stop_ || num_pending_ > 0; });
+        if (num_pending_ == 0) {
+          return;
+        }
+        // Claims one task. Submit() counts a task only after queueing it, so every claim is backed
+        // by a task in one of the deques.
+        --num_pending_;
+      }
+      Task task;
+      // One pass over the deques can still miss the claimed task, when another worker takes the
+      // task of a deque not scanned yet while a new one lands in a deque already scanned.
+      while (!PopOwn(worker_index, &task) && !Steal(worker_index, &task)) {
+      }
+      task(worker_index);
+    }
+  }
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<std::size_t> next_queue_{0};
+  std::mutex wake_mutex_;
+  std::condition_variable wake_;
+  int num_pending_{0};
+  bool stop_{false};
+};
+
+}  // namespace drake_tutorials
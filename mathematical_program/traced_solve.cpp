@@ -0,0 +1,73 @@
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+
+#include <gflags/gflags.h>
+
+#include "solver_trace.h"
+#include "tutorial_programs.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+DEFINE_string(trace, "solver_trace.json", "Path of the Chrome trace.");
+DEFINE_int32(repetitions, 2000, "Number of solves for the overhead measurement.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+// Mean time of a solve of `prog` with Ipopt in microseconds.
+double MeanSolveTime(const drake::solvers::MathematicalProgram& prog,
+                     drake_tutorials::Tracer* tracer,
+                     const drake::solvers::SolverOptions& options) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < FLAGS_repetitions; ++i) {
+    drake_tutorials::TracedSolve(prog, tracer, drake::solvers::IpoptSolver::id(),
+                                 Eigen::Vector2d(1, 1), options);
+  }
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+             .count() / FLAGS_repetitions;
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  drake::solvers::SolverOptions options;
+  options.SetOption(drake::solvers::IpoptSolver::id(), "print_level", 0);
+
+  // manually_choosing_a_solver.cpp with every phase traced, including Ipopt's own timing
+  // statistics. Ipopt evaluates even the linear constraints and cost through Eval(), so all of
+  // them are wrapped.
+  drake_tutorials::Tracer::Options trace_options;
+  trace_options.ipopt_timing_statistics = true;
+  drake_tutorials::Tracer tracer(trace_options);
+  std::unique_ptr<drake::solvers::MathematicalProgram> prog;
+  {
+    auto scope = tracer.Trace("program construction");
+    prog = drake_tutorials::MakeLinearProgram();
+  }
+  const auto traced = drake_tutorials::InstrumentProgram(*prog, &tracer,
+                                                         drake_tutorials::EvaluatorWrapping::kAll);
+  const auto result = drake_tutorials::TracedSolve(*traced, &tracer,
+                                                   drake::solvers::IpoptSolver::id(),
+                                                   Eigen::Vector2d(1, 1), options);
+  print("x* = ", result.get_x_val().transpose(), ", Ipopt status ",
+        result.get_solver_details<drake::solvers::IpoptSolver>().ConvertStatusToString());
+  tracer.WriteChromeTrace(FLAGS_trace);
+  print("Wrote ", FLAGS_trace, "\n", tracer.SummaryTable());
+
+  // What tracing costs when it is left on in production: evaluator statistics and phase events,
+  // without Ipopt's timing statistics (which write a file per solve).
+  drake_tutorials::Tracer production({true, false, false});
+  const auto production_prog = drake_tutorials::InstrumentProgram(
+      *prog, &production, drake_tutorials::EvaluatorWrapping::kAll);
+  const double plain = MeanSolveTime(*prog, nullptr, options);
+  const double enabled = MeanSolveTime(*production_prog, &production, options);
+  production.set_enabled(false);
+  const double disabled = MeanSolveTime(*production_prog, &production, options);
+  print("mean solve time: untraced ", plain, " us, tracing enabled ", enabled, " us (",
+        100 * (enabled - plain) / plain, " %), tracing disabled ", disabled, " us (",
+        100 * (disabled - plain) / plain, " %)");
+  return 0;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <drake/solvers/mathematical_program.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace drake_tutorials {
+
+// The programs of the mathematical_program tutorials, with their data exposed as arguments so
+// benchmarks can vary it.
+struct TutorialProgram {
+  std::string name;
+  std::unique_ptr<drake::solvers::MathematicalProgram> prog;
+  std::optional<Eigen::VectorXd> initial_guess;
+};
+
+/*
+ * simple_optimization_problem_feasible.cpp
+ *    min x(0)^2 + x(1)^2
+ * subject to x(0) + x(1) = b
+ *        x(0) <= x(1)
+ */
+inline std::unique_ptr<drake::solvers::MathematicalProgram> MakeFeasibleProgram(double b = 1) {
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  auto x = prog->NewContinuousVariables(2);
+  prog->AddConstraint(x[0] + x[1] == b);
+  prog->AddConstraint(x[0] <= x[1]);
+  prog->AddCost(pow(x[0], 2) + pow(x[1], 2));
+  return prog;
+}
+
+/*
+ * simple_optimization_problem_infeasible.cpp
+ *    min x
+ * subject to x + y >= lower
+ *            x + y <= 0
+ */
+inline std::unique_ptr<drake::solvers::MathematicalProgram> MakeInfeasibleProgram(
+    double lower = 1) {
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  auto x = prog->NewContinuousVariables(1)[0];
+  auto y = prog->NewContinuousVariables(1)[0];
+  prog->AddConstraint(x + y >= lower);
+  prog->AddConstraint(x + y <= 0);
+  prog->AddCost(x);
+  return prog;
+}
+
+/*
+ * manually_choosing_a_solver.cpp
+ *    min x(0)
+ * subject to x(0) + x(1) = 1
+ *            0 <= x(1) <= 1
+ */
+inline std::unique_ptr<drake::solvers::MathematicalProgram> MakeLinearProgram() {
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  auto x = prog->NewContinuousVariables(2);
+  prog->AddConstraint(x[0] + x[1] == 1);
+  prog->AddConstraint(0 <= x[1]);
+  prog->AddConstraint(x[1] <= 1);
+  prog->AddCost(x[0]);
+  return prog;
+}
+
+/*
+ * good_or_bad_initial_guess.cpp
+ *    min x(0)^2 - x(1)^2
+ * subject to x(0)^2 + x(1)^2 = radius_squared
+ */
+inline std::unique_ptr<drake::solvers::MathematicalProgram> MakeCircleProgram(
+    double radius_squared = 100) {
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  auto x = prog->NewContinuousVariables(2);
+  prog->AddConstraint(pow(x[0], 2) + pow(x[1], 2) == radius_squared);
+  prog->AddCost(pow(x[0], 2) - pow(x[1], 2));
+  return prog;
+}
+
+/*
+ * add_callback.cpp
+ *    min x(0)^2 + x(1)^2
+ * subject to x(0) * x(1) = product
+ */
+inline std::unique_ptr<drake::solvers::MathematicalProgram> MakeBilinearProgram(
+    double product = 9) {
+  auto prog = std::make_unique<drake::solvers::MathematicalProgram>();
+  auto x = prog->NewContinuousVariables(2);
+  prog->AddConstraint(x[0] * x[1] == product);
+  prog->AddCost(pow(x[0], 2) + pow(x[1], 2));
+  return prog;
+}
+
+// All tutorial programs with the data and initial guesses used in the tutorials.
+inline std::vector<TutorialProgram> MakeTutorialPrograms() {
+  std::vector<TutorialProgram> programs;
+  programs.push_back({"simple_optimization_problem_feasible", MakeFeasibleProgram(), std::nullopt});
+  programs.push_back(
+      {"simple_optimization_problem_infeasible", MakeInfeasibleProgram(), std::nullopt});
+  programs.push_back({"manually_choosing_a_solver", MakeLinearProgram(), Eigen::Vector2d(1, 1)});
+  programs.push_back({"good_or_bad_initial_guess", MakeCircleProgram(), Eigen::Vector2d(-5, 0)});
+  programs.push_back({"add_callback", MakeBilinearProgram(), Eigen::Vector2d(4, 5)});
+  return programs;
+}
+
+}  // namespace drake_tutorials
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace drake_tutorials {
+
+namespace internal {
+
+inline void HashCombine(std::size_t* seed, std::size_t value) {
+  *seed ^= value + 0x9e3779b97f4a7c15ULL + (*seed << 6) + (*seed >> 2);
+}
+
+template <typename C>
+void HashBindings(const drake::solvers::MathematicalProgram& prog,
+                  const std::vector<drake::solvers::Binding<C>>& bindings, std::size_t category,
+                  std::size_t* seed) {
+  HashCombine(seed, category);
+  HashCombine(seed, bindings.size());
+  for (const auto& binding : bindings) {
+    HashCombine(seed, typeid(*binding.evaluator()).hash_code());
+    HashCombine(seed, binding.evaluator()->num_outputs());
+    // Variables are hashed by their position in the program, not by their id, so that a program
+    // rebuilt with fresh variables has the same fingerprint.
+    for (int index : prog.FindDecisionVariableIndices(binding.variables())) {
+      HashCombine(seed, index);
+    }
+  }
+}
+
+// `solver_options` plus the Ipopt settings for a solve that starts close to the solution: a small
+// initial barrier parameter and bound push, so Ipopt does not move the initial guess away into
+// the interior of the feasible set.
+inline drake::solvers::SolverOptions IpoptWarmStartOptions(
+    const std::optional<drake::solvers::SolverOptions>& solver_options) {
+  drake::solvers::SolverOptions options =
+      solver_options.value_or(drake::solvers::SolverOptions());
+  options.SetOption(drake::solvers::IpoptSolver::id(), "mu_init", 1e-4);
+  options.SetOption(drake::solvers::IpoptSolver::id(), "bound_push", 1e-6);
+  options.SetOption(drake::solvers::IpoptSolver::id(), "bound_frac", 1e-6);
+  return options;
+}
+
+}  // namespace internal
+
+/*
+ * Hashes the structure of `prog`: the number and type of its decision variables, which variables
+ * every cost and constraint is bound to, the evaluator type of each cost and constraint (of every
+ * category, including conic and generic ones), and the sparsity pattern of the linear
+ * constraints. The numerical data is deliberately left out, so programs that only differ in their
+ * data share a fingerprint. Evaluator types are hashed with typeid, so fingerprints are only
+ * comparable within one process.
+ */
+inline std::size_t FingerprintProgramStructure(const drake::solvers::MathematicalProgram& prog) {
+  std::size_t seed = prog.num_vars();
+  for (int i = 0; i < prog.num_vars(); ++i) {
+    internal::HashCombine(&seed, static_cast<std::size_t>(prog.decision_variable(i).get_type()));
+  }
+  internal::HashBindings(prog, prog.GetAllCosts(), 1, &seed);
+  internal::HashBindings(prog, prog.GetAllConstraints(), 2, &seed);
+  for (const auto& binding : prog.GetAllLinearConstraints()) {
+    const Eigen::SparseMatrix<double>& A = binding.evaluator()->get_sparse_A();
+    for (int k = 0; k < A.outerSize(); ++k) {
+      for (Eigen::SparseMatrix<double>::InnerIterator it(A, k); it; ++it) {
+        internal::HashCombine(&seed, it.row());
+        internal::HashCombine(&seed, it.col());
+      }
+    }
+  }
+  return seed;
+}
+
+/*
+ * Solves programs with IpoptSolver and warm starts every solve from the last solution of a program
+ * with the same structure (see FingerprintProgramStructure()).
+ *
+ * Drake's IpoptSolver only accepts a primal initial guess, so only the solution is cached.
+ * Instead of multipliers, a hit lowers the initial barrier parameter and the bound push (see
+ * internal::IpoptWarmStartOptions()). An initial guess passed by the caller wins over the cache.
+ */
+class IpoptWarmStartCache {
+ public:
+  struct Entry {
+    Eigen::VectorXd x;
+  };
+
+  explicit IpoptWarmStartCache(int max_entries = 1024) : max_entries_(std::max(1, max_entries)) {}
+
+  drake::solvers::MathematicalProgramResult Solve(
+      const drake::solvers::MathematicalProgram& prog,
+      const std::optional<Eigen::VectorXd>& initial_guess = std::nullopt,
+      const std::optional<drake::solvers::SolverOptions>& solver_options = std::nullopt) {
+    const std::size_t fingerprint = FingerprintProgramStructure(prog);
+    const Entry* entry = initial_guess.has_value() ? nullptr : Find(fingerprint, prog);
+    drake::solvers::MathematicalProgramResult result;
+    if (entry == nullptr) {
+      ++num_misses_;
+      solver_.Solve(prog, initial_guess, solver_options, &result);
+    } else {
+      ++num_hits_;
+      solver_.Solve(prog, entry->x, internal::IpoptWarmStartOptions(solver_options),
+                    &result);
+    }
+    if (result.is_success()) {
+      Store(fingerprint, result);
+    }
+    return result;
+  }
+
+  // Returns the entry for programs with the structure of `prog`, or nullptr.
+  const Entry* Find(const drake::solvers::MathematicalProgram& prog) const {
+    return Find(FingerprintProgramStructure(prog), prog);
+  }
+
+  int num_hits() const { return num_hits_; }
+  int num_misses() const { return num_misses_; }
+  int size() const { return static_cast<int>(entries_.size()); }
+
+  void Clear() {
+    entries_.clear();
+    insertion_order_.clear();
+  }
+
+ private:
+  // An entry whose x does not fit `prog`, after a fingerprint collision between programs of
+  // different structure, counts as missing.
+  const Entry* Find(std::size_t fingerprint,
+                    const drake::solvers::MathematicalProgram& prog) const {
+    const auto it = entries_.find(fingerprint);
+    if (it == entries_.end() || it->second.x.size() != prog.num_vars()) {
+      return nullptr;
+    }
+    return &it->second;
+  }
+
+  void Store(std::size_t fingerprint, const drake::solvers::MathematicalProgramResult& result) {
+    auto [it, inserted] = entries_.try_emplace(fingerprint);
+    if (inserted) {
+      insertion_order_.push_back(fingerprint);
+      if (static_cast<int>(insertion_order_.size()) > max_entries_) {
+        entries_.erase(insertion_order_.front());
+        insertion_order_.pop_front();
+      }
+    }
+    it->second.x = result.get_x_val();
+  }
+
+  drake::solvers::IpoptSolver solver_;
+  int max_entries_;
+  std::unordered_map<std::size_t, Entry> entries_;
+  std::deque<std::size_t> insertion_order_;
+  int num_hits_{0};
+  int num_misses_{0};
+};
+
+}  // namespace drake_tutorials
@@ -0,0 +1,71 @@
+#include <drake/solvers/ipopt_solver.h>
+#include <drake/solvers/mathematical_program.h>
+
+#include <gflags/gflags.h>
+
+#include "tutorial_programs.h"
+#include "warm_start_cache.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+DEFINE_int32(num_cycles, 1000, "Number of control cycles, i.e. solves per strategy.");
+DEFINE_double(drift, 0.01, "Drift of the constraint x(0) * x(1) = product per cycle.");
+
+template <typename... Args>
+void print(Args&&... value) {
+  (std::cout << ... << value) << "\n---\n";
+}
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  drake::solvers::SolverOptions options;
+  options.SetOption(drake::solvers::IpoptSolver::id(), "print_level", 0);
+
+  // add_callback.cpp, with x(0) * x(1) = 9 slowly drifting. Every cycle rebuilds the program, like
+  // a production loop that generates a fresh program from new data.
+  auto product = [](int cycle) { return 9 + 3 * std::sin(FLAGS_drift * cycle); };
+  const Eigen::VectorXd tutorial_guess = Eigen::Vector2d(4, 5);
+
+  int iterations = 0;
+  auto count_iterations = [&iterations](drake::solvers::MathematicalProgram* prog) {
+    prog->AddVisualizationCallback(
+        [&iterations](const Eigen::Ref<const Eigen::VectorXd>&) { ++iterations; },
+        prog->decision_variables());
+  };
+
+  drake::solvers::IpoptSolver solver;
+  int cold_failures = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int cycle = 0; cycle < FLAGS_num_cycles; ++cycle) {
+    auto prog = drake_tutorials::MakeBilinearProgram(product(cycle));
+    count_iterations(prog.get());
+    cold_failures += !solver.Solve(*prog, tutorial_guess, options).is_success();
+  }
+  const std::chrono::duration<double> cold_time = std::chrono::steady_clock::now() - start;
+  const int cold_iterations = iterations;
+
+  drake_tutorials::IpoptWarmStartCache cache;
+  int warm_failures = 0;
+  iterations = 0;
+  start = std::chrono::steady_clock::now();
+  for (int cycle = 0; cycle < FLAGS_num_cycles; ++cycle) {
+    auto prog = drake_tutorials::MakeBilinearProgram(product(cycle));
+    count_iterations(prog.get());
+    warm_failures += !cache.Solve(*prog, tutorial_guess, options).is_success();
+  }
+  const std::chrono::duration<double> warm_time = std::chrono::steady_clock::now() - start;
+  const int warm_iterations = iterations;
+
+  print("cold start from (4, 5): ", cold_iterations, " Ipopt iterations, ",
+        static_cast<double>(cold_iterations) / FLAGS_num_cycles, " per solve, ", cold_time.count(),
+        " s, ", cold_failures, " failures");
+  print("warm-start cache: ", warm_iterations, " Ipopt iterations, ",
+        static_cast<double>(warm_iterations) / FLAGS_num_cycles, " per solve, ", warm_time.count(),
+        " s, ", warm_failures, " failures");
+  print("cache hits: ", cache.num_hits(), ", misses: ", cache.num_misses());
+  print("iteration reduction: ", 100. * (cold_iterations - warm_iterations) / cold_iterations,
+        " %");
+  return 0;
+}